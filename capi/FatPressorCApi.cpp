@@ -0,0 +1,319 @@
+#include "include/fatpressor.h"
+#include "../src/PluginProcessor.h"
+#include <climits>
+#include <cmath>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief fp_set_parameter() value waiting for the next block (plain value)
+ */
+struct PendingParameter
+{
+    std::atomic<float> value { 0.0f };
+    std::atomic<bool> pending { false };
+};
+
+/**
+ * @brief One C API instance: a headless FatPressorAudioProcessor plus the
+ * scratch space interleaved processing needs
+ */
+struct fp_instance
+{
+    FatPressorAudioProcessor processor { FatPressorAudioProcessor::Options::embedded() };
+    std::vector<juce::RangedAudioParameter*> parameters;
+    std::vector<std::string> parameterIds;  // stable storage for fp_get_parameter_id()
+    std::vector<PendingParameter> pendingParameters;  // same order as parameters, sized in fp_create()
+
+    juce::AudioBuffer<float> scratch;       // deinterleaved audio, sized in fp_prepare()
+    juce::MidiBuffer midi;
+    int numChannels = 0;
+    int maxBlockSize = 0;
+};
+
+namespace
+{
+// JUCE is initialised with the first instance and shut down with the last.
+// JUCE's message manager belongs to the thread that created it, so it is
+// only shut down on that thread (a last fp_destroy() elsewhere leaves it
+// for the next fp_create()), and an application that runs JUCE itself
+// keeps its own.
+std::mutex lifetimeMutex;
+int numInstances = 0;
+bool ownsJuce = false;
+std::thread::id juceThread;
+
+bool isPrepared(const fp_instance* instance)
+{
+    return instance != nullptr && instance->maxBlockSize > 0;
+}
+
+/**
+ * @brief Hand fp_set_parameter() values to the processor
+ * While prepared they become events at the start of the next block (no
+ * locks, no listeners; the processor writes them back to the parameters
+ * afterwards), otherwise they are set directly.
+ */
+void applyPendingParameters(fp_instance& instance, bool asEvents)
+{
+    auto& events = instance.processor.getParameterEventQueue();
+
+    for (size_t i = 0; i < instance.parameters.size(); ++i)
+    {
+        auto& pending = instance.pendingParameters[i];
+        if (! pending.pending.exchange(false, std::memory_order_acquire))
+            continue;
+
+        auto* parameter = instance.parameters[i];
+        const auto value = pending.value.load(std::memory_order_relaxed);
+
+        if (asEvents)
+            events.add(0, parameter->getParameterIndex(), value);
+        else
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+}
+
+void processChunk(fp_instance& instance, float* const* channels, int numSamples)
+{
+    applyPendingParameters(instance, true);
+
+    // Refers to the caller's memory (up to 32 channels need no allocation)
+    juce::AudioBuffer<float> buffer(channels, instance.numChannels, numSamples);
+    instance.processor.processBlock(buffer, instance.midi);
+}
+}
+
+extern "C" {
+
+int fp_get_api_version(void)
+{
+    return FATPRESSOR_API_VERSION;
+}
+
+fp_instance* fp_create(void)
+{
+    const std::lock_guard<std::mutex> lock(lifetimeMutex);
+
+    // The parameter tree expects a message manager
+    if (juce::MessageManager::getInstanceWithoutCreating() == nullptr)
+    {
+        juce::initialiseJuce_GUI();
+        ownsJuce = true;
+        juceThread = std::this_thread::get_id();
+    }
+
+    auto* instance = new (std::nothrow) fp_instance();
+    if (instance == nullptr)
+        return nullptr;
+
+    ++numInstances;
+
+    for (auto* parameter : instance->processor.getParameters())
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+        {
+            instance->parameters.push_back(ranged);
+            instance->parameterIds.push_back(ranged->getParameterID().toStdString());
+        }
+    }
+
+    instance->pendingParameters = std::vector<PendingParameter>(instance->parameters.size());
+    return instance;
+}
+
+void fp_destroy(fp_instance* instance)
+{
+    if (instance == nullptr)
+        return;
+
+    const std::lock_guard<std::mutex> lock(lifetimeMutex);
+
+    instance->processor.releaseResources();
+    delete instance;
+
+    if (--numInstances == 0 && ownsJuce && std::this_thread::get_id() == juceThread)
+    {
+        juce::shutdownJuce_GUI();
+        ownsJuce = false;
+    }
+}
+
+fp_status fp_prepare(fp_instance* instance, double sample_rate, int max_block_size, int num_channels)
+{
+    if (instance == nullptr || sample_rate <= 0.0 || max_block_size <= 0 || num_channels < 1 || num_channels > 2)
+        return FP_ERROR_INVALID_ARGUMENT;
+
+    auto& processor = instance->processor;
+
+    const auto channelSet = num_channels == 1 ? juce::AudioChannelSet::mono() : juce::AudioChannelSet::stereo();
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(channelSet);
+    layout.outputBuses.add(channelSet);
+
+    if (! processor.setBusesLayout(layout))
+        return FP_ERROR_INVALID_ARGUMENT;
+
+    applyPendingParameters(*instance, false);
+
+    processor.setRateAndBufferSizeDetails(sample_rate, max_block_size);
+    processor.prepareToPlay(sample_rate, max_block_size);
+
+    instance->scratch.setSize(num_channels, max_block_size);
+    instance->midi.ensureSize(0);
+    instance->numChannels = num_channels;
+    instance->maxBlockSize = max_block_size;
+    return FP_OK;
+}
+
+int fp_get_latency(const fp_instance* instance)
+{
+    return instance != nullptr ? instance->processor.getLatencySamples() : 0;
+}
+
+int fp_get_parameter_count(const fp_instance* instance)
+{
+    return instance != nullptr ? static_cast<int>(instance->parameters.size()) : 0;
+}
+
+const char* fp_get_parameter_id(const fp_instance* instance, int index)
+{
+    if (instance == nullptr || ! juce::isPositiveAndBelow(index, static_cast<int>(instance->parameterIds.size())))
+        return nullptr;
+
+    return instance->parameterIds[static_cast<size_t>(index)].c_str();
+}
+
+int fp_find_parameter(const fp_instance* instance, const char* id)
+{
+    if (instance == nullptr || id == nullptr)
+        return -1;
+
+    for (size_t i = 0; i < instance->parameterIds.size(); ++i)
+        if (instance->parameterIds[i] == id)
+            return static_cast<int>(i);
+
+    return -1;
+}
+
+fp_status fp_set_parameter(fp_instance* instance, int index, float value)
+{
+    if (instance == nullptr || ! juce::isPositiveAndBelow(index, static_cast<int>(instance->parameters.size()))
+        || ! std::isfinite(value))
+        return FP_ERROR_INVALID_ARGUMENT;
+
+    // Picked up by the next fp_prepare() or block (any thread, no locks, no allocation)
+    const auto* parameter = instance->parameters[static_cast<size_t>(index)];
+    auto& pending = instance->pendingParameters[static_cast<size_t>(index)];
+    pending.value.store(parameter->convertFrom0to1(parameter->convertTo0to1(value)), std::memory_order_relaxed);
+    pending.pending.store(true, std::memory_order_release);
+    return FP_OK;
+}
+
+float fp_get_parameter(const fp_instance* instance, int index)
+{
+    if (instance == nullptr || ! juce::isPositiveAndBelow(index, static_cast<int>(instance->parameters.size())))
+        return 0.0f;
+
+    const auto& pending = instance->pendingParameters[static_cast<size_t>(index)];
+    if (pending.pending.load(std::memory_order_acquire))
+        return pending.value.load(std::memory_order_relaxed);
+
+    const auto* parameter = instance->parameters[static_cast<size_t>(index)];
+    return parameter->convertFrom0to1(parameter->getValue());
+}
+
+fp_status fp_process_planar(fp_instance* instance, float* const* channels, int num_samples)
+{
+    if (! isPrepared(instance))
+        return FP_ERROR_NOT_PREPARED;
+    if (channels == nullptr || num_samples < 0)
+        return FP_ERROR_INVALID_ARGUMENT;
+
+    float* chunk[2] {};
+
+    for (int start = 0; start < num_samples; start += instance->maxBlockSize)
+    {
+        const int length = juce::jmin(instance->maxBlockSize, num_samples - start);
+
+        for (int channel = 0; channel < instance->numChannels; ++channel)
+            chunk[channel] = channels[channel] + start;
+
+        processChunk(*instance, chunk, length);
+    }
+
+    return FP_OK;
+}
+
+fp_status fp_process_interleaved(fp_instance* instance, float* samples, int num_frames)
+{
+    if (! isPrepared(instance))
+        return FP_ERROR_NOT_PREPARED;
+    if (samples == nullptr || num_frames < 0)
+        return FP_ERROR_INVALID_ARGUMENT;
+
+    const int numChannels = instance->numChannels;
+    auto& scratch = instance->scratch;
+
+    for (int start = 0; start < num_frames; start += instance->maxBlockSize)
+    {
+        const int length = juce::jmin(instance->maxBlockSize, num_frames - start);
+        float* frames = samples + static_cast<size_t>(start) * static_cast<size_t>(numChannels);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* planar = scratch.getWritePointer(channel);
+            for (int i = 0; i < length; ++i)
+                planar[i] = frames[i * numChannels + channel];
+        }
+
+        processChunk(*instance, scratch.getArrayOfWritePointers(), length);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* planar = scratch.getReadPointer(channel);
+            for (int i = 0; i < length; ++i)
+                frames[i * numChannels + channel] = planar[i];
+        }
+    }
+
+    return FP_OK;
+}
+
+fp_status fp_get_meters(const fp_instance* instance, fp_meters* meters)
+{
+    if (instance == nullptr || meters == nullptr)
+        return FP_ERROR_INVALID_ARGUMENT;
+
+    const auto& processor = instance->processor;
+    meters->input_left = processor.inputLevelL.load();
+    meters->input_right = processor.inputLevelR.load();
+    meters->output_left = processor.outputLevelL.load();
+    meters->output_right = processor.outputLevelR.load();
+    meters->gain_reduction = processor.gainReduction.load();
+    return FP_OK;
+}
+
+fp_status fp_load_preset(fp_instance* instance, const void* data, size_t size)
+{
+    if (instance == nullptr || data == nullptr || size == 0 || size > static_cast<size_t>(INT_MAX))
+        return FP_ERROR_INVALID_ARGUMENT;
+
+    const auto text = juce::String::fromUTF8(static_cast<const char*>(data), static_cast<int>(size));
+    const auto xml = juce::XmlDocument::parse(text);
+
+    if (xml == nullptr || ! instance->processor.presetManager.loadPresetFromXml(*xml))
+        return FP_ERROR_INVALID_PRESET;
+
+    // Values set before the preset do not outlive it
+    for (auto& pending : instance->pendingParameters)
+        pending.pending.store(false, std::memory_order_relaxed);
+
+    return FP_OK;
+}
+
+} // extern "C"
@@ -0,0 +1,117 @@
+/*
+ * fatpressor-c-example - drives the FatPressor C API from plain C
+ *
+ *   fatpressor-c-example [preset.fppreset]
+ *
+ * Compresses ten seconds of a decaying 110 Hz tone, prints the meters and
+ * reports throughput as a multiple of real time.
+ */
+#include <fatpressor.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define SAMPLE_RATE 48000.0
+#define BLOCK_SIZE 256
+#define NUM_CHANNELS 2
+#define SECONDS 10
+
+static void set_parameter(fp_instance* instance, const char* id, float value)
+{
+    const int index = fp_find_parameter(instance, id);
+    if (index < 0 || fp_set_parameter(instance, index, value) != FP_OK)
+        fprintf(stderr, "cannot set %s\n", id);
+}
+
+static int load_preset(fp_instance* instance, const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    long size;
+    void* data;
+    int status = -1;
+
+    if (file == NULL)
+        return -1;
+
+    fseek(file, 0, SEEK_END);
+    size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    data = size > 0 ? malloc((size_t) size) : NULL;
+    if (data != NULL && fread(data, 1, (size_t) size, file) == (size_t) size)
+        status = fp_load_preset(instance, data, (size_t) size);
+
+    free(data);
+    fclose(file);
+    return status;
+}
+
+int main(int argc, char* argv[])
+{
+    const double twoPi = 6.283185307179586;
+    const long totalFrames = (long) (SAMPLE_RATE * SECONDS);
+    float block[BLOCK_SIZE * NUM_CHANNELS];
+    double processSeconds = 0.0;
+    fp_meters meters;
+    long frame = 0;
+    fp_instance* instance;
+
+    if (fp_get_api_version() != FATPRESSOR_API_VERSION)
+    {
+        fprintf(stderr, "library API version %d, header %d\n", fp_get_api_version(), FATPRESSOR_API_VERSION);
+        return 1;
+    }
+
+    instance = fp_create();
+    if (instance == NULL || fp_prepare(instance, SAMPLE_RATE, BLOCK_SIZE, NUM_CHANNELS) != FP_OK)
+    {
+        fprintf(stderr, "cannot create FatPressor\n");
+        return 1;
+    }
+
+    if (argc > 1)
+    {
+        if (load_preset(instance, argv[1]) != FP_OK)
+            fprintf(stderr, "cannot load preset %s\n", argv[1]);
+    }
+    else
+    {
+        set_parameter(instance, "threshold", -24.0f);
+        set_parameter(instance, "ratio", 4.0f);
+        set_parameter(instance, "fat", 60.0f);
+    }
+
+    printf("latency %d samples\n", fp_get_latency(instance));
+
+    while (frame < totalFrames)
+    {
+        clock_t start;
+        int i;
+
+        for (i = 0; i < BLOCK_SIZE; ++i)
+        {
+            const double t = (double) (frame + i) / SAMPLE_RATE;
+            const float sample = (float) (0.8 * exp(-fmod(t, 0.5) * 6.0) * sin(twoPi * 110.0 * t));
+            block[i * NUM_CHANNELS] = sample;
+            block[i * NUM_CHANNELS + 1] = sample;
+        }
+
+        start = clock();
+        fp_process_interleaved(instance, block, BLOCK_SIZE);
+        processSeconds += (double) (clock() - start) / CLOCKS_PER_SEC;
+
+        frame += BLOCK_SIZE;
+    }
+
+    fp_get_meters(instance, &meters);
+    printf("in %.1f/%.1f dB  out %.1f/%.1f dB  gain reduction %.1f dB\n",
+           meters.input_left, meters.input_right, meters.output_left, meters.output_right,
+           meters.gain_reduction);
+
+    if (processSeconds > 0.0)
+        printf("%.0fx real time (%d-sample blocks)\n", SECONDS / processSeconds, BLOCK_SIZE);
+
+    fp_destroy(instance);
+    return 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * FatPressor C API - the FatPressor DSP chain without a plugin host
+ *
+ * Stable C ABI: opaque handles, plain types, no C++ in this header.
+ *
+ * Threading: instances are independent and may be used from different
+ * threads at the same time. Calls on one instance must not overlap, except
+ * fp_set_parameter(), fp_get_parameter() and fp_get_meters(), which may be
+ * called from any thread while another thread is processing.
+ *
+ * The library runs JUCE internally. The first fp_create() initialises it on
+ * the calling thread (unless the application already runs JUCE); the last
+ * fp_destroy() shuts it down only when called on that same thread, and
+ * otherwise leaves it running. Creating and destroying instances on one
+ * thread (say, the main thread) keeps this simple.
+ *
+ * Instances have no side effects outside themselves: no files are written,
+ * no background threads are started, nothing is shared with other instances
+ * or processes.
+ *
+ * Real-time: fp_set_parameter(), fp_get_parameter() and fp_get_meters()
+ * never allocate or lock. fp_process_planar() and fp_process_interleaved()
+ * do neither once fp_prepare() has returned, except in the first block
+ * after the FAT parameter moved: with no background thread, the waveshaper
+ * table for the new FAT is baked at the start of that block.
+ */
+#ifndef FATPRESSOR_H
+#define FATPRESSOR_H
+
+#include <stddef.h>
+
+#if defined(_WIN32)
+ #if defined(FATPRESSOR_CAPI_BUILD)
+  #define FP_API __declspec(dllexport)
+ #else
+  #define FP_API __declspec(dllimport)
+ #endif
+#else
+ #define FP_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bumped whenever a declaration in this header changes incompatibly */
+#define FATPRESSOR_API_VERSION 1
+
+typedef struct fp_instance fp_instance;
+
+typedef enum fp_status
+{
+    FP_OK = 0,
+    FP_ERROR_INVALID_ARGUMENT = -1,
+    FP_ERROR_NOT_PREPARED = -2,
+    FP_ERROR_INVALID_PRESET = -3
+} fp_status;
+
+/* Levels in dBFS, gain reduction in dB (positive), from the last processed block */
+typedef struct fp_meters
+{
+    float input_left;
+    float input_right;
+    float output_left;
+    float output_right;
+    float gain_reduction;
+} fp_meters;
+
+FP_API int fp_get_api_version(void);
+
+/* Lifetime (not real-time safe). Returns NULL on failure. */
+FP_API fp_instance* fp_create(void);
+FP_API void fp_destroy(fp_instance* instance);
+
+/*
+ * Allocates everything processing needs. num_channels is 1 or 2; blocks
+ * longer than max_block_size are processed in several passes.
+ */
+FP_API fp_status fp_prepare(fp_instance* instance, double sample_rate, int max_block_size, int num_channels);
+
+/* Processing latency in samples (valid after fp_prepare) */
+FP_API int fp_get_latency(const fp_instance* instance);
+
+/*
+ * Parameters, addressed by index. Values are in the parameter's own units
+ * (dB, ms, %, ratio) and are clamped to its range. fp_set_parameter() only
+ * stores the value; it takes effect at the start of the next processed
+ * block (or in fp_prepare()), and fp_get_parameter() returns it meanwhile.
+ */
+FP_API int fp_get_parameter_count(const fp_instance* instance);
+FP_API const char* fp_get_parameter_id(const fp_instance* instance, int index);
+FP_API int fp_find_parameter(const fp_instance* instance, const char* id); /* -1 if unknown */
+FP_API fp_status fp_set_parameter(fp_instance* instance, int index, float value);
+FP_API float fp_get_parameter(const fp_instance* instance, int index);
+
+/* In-place processing, one pointer per channel */
+FP_API fp_status fp_process_planar(fp_instance* instance, float* const* channels, int num_samples);
+
+/* In-place processing of interleaved frames (num_channels samples each) */
+FP_API fp_status fp_process_interleaved(fp_instance* instance, float* samples, int num_frames);
+
+FP_API fp_status fp_get_meters(const fp_instance* instance, fp_meters* meters);
+
+/*
+ * Loads a preset from the bytes of a .fppreset file. Rejected as a whole
+ * (FP_ERROR_INVALID_PRESET) if it is malformed or any value is out of range.
+ * Not real-time safe.
+ */
+FP_API fp_status fp_load_preset(fp_instance* instance, const void* data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FATPRESSOR_H */
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+
+/**
+ * @brief Membership of one instance in a process-wide compression link group
+ *
+ * Instances that share a group number compress together without bussing:
+ * each publishes its own detector envelope (dB) once per block into a slot
+ * of a static table, and reads the loudest level of the other live members
+ * of its group to drive its own gain computer. With matching settings every
+ * member ends up applying the same gain reduction.
+ *
+ * Everything is lock-free and allocation-free, so join/leave/publish/read
+ * are all safe on the audio thread. Hosts may run the members on different
+ * threads in any order: a member sees the others' levels from their current
+ * or previous block, never older. Members that stop processing (bypassed,
+ * transport stopped, removed) drop out after staleMs.
+ *
+ * Only instances loaded in the same process (the same plugin binary) link.
+ */
+class LinkGroup
+{
+public:
+    static constexpr int maxGroups = 8;
+    static constexpr int maxMembers = 64;
+    static constexpr float floorDb = -90.0f;   // the envelope's floor
+    static constexpr juce::uint32 staleMs = 250;
+
+    LinkGroup() = default;
+    ~LinkGroup() { leave(); }
+
+    /**
+     * @brief Join group 1...maxGroups (0 leaves); false when the table is full
+     *
+     * Asking again for the group last asked for does nothing, so a member
+     * that found the table full stays unlinked (without rescanning it) until
+     * it asks for another group or leaves.
+     */
+    bool join(int group) noexcept
+    {
+        group = juce::jlimit(0, maxGroups, group);
+        if (group == requestedGroup)
+            return group == currentGroup;
+
+        leave();
+        requestedGroup = group;
+        if (group == 0)
+            return true;
+
+        auto& slots = getSlots();
+        for (int index = 0; index < maxMembers; ++index)
+        {
+            int expected = 0;
+            if (slots[static_cast<size_t>(index)].group.compare_exchange_strong(expected, group, std::memory_order_acq_rel))
+            {
+                slotIndex = index;
+                currentGroup = group;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void leave() noexcept
+    {
+        requestedGroup = 0;
+        if (slotIndex < 0)
+            return;
+
+        // Free slots always read as stale, so the next owner starts clean
+        auto& slot = getSlots()[static_cast<size_t>(slotIndex)];
+        slot.publishedMs.store(0, std::memory_order_relaxed);
+        slot.group.store(0, std::memory_order_release);
+        slotIndex = -1;
+        currentGroup = 0;
+    }
+
+    int getGroup() const noexcept { return currentGroup; }
+    int getRequestedGroup() const noexcept { return requestedGroup; }
+    bool isLinked() const noexcept { return slotIndex >= 0; }
+
+    /**
+     * @brief Publish this member's detector level for the block just processed
+     */
+    void publish(float levelDb) noexcept
+    {
+        if (slotIndex < 0)
+            return;
+
+        auto& slot = getSlots()[static_cast<size_t>(slotIndex)];
+        slot.levelDb.store(levelDb, std::memory_order_relaxed);
+        slot.publishedMs.store(juce::jmax(1u, juce::Time::getMillisecondCounter()), std::memory_order_release);
+    }
+
+    /**
+     * @brief Loudest level published by the other live members (floorDb if none)
+     */
+    float readOthers() const noexcept
+    {
+        float loudest = floorDb;
+        if (slotIndex < 0)
+            return loudest;
+
+        const auto now = juce::Time::getMillisecondCounter();
+        const auto& slots = getSlots();
+
+        for (int index = 0; index < maxMembers; ++index)
+        {
+            const auto& slot = slots[static_cast<size_t>(index)];
+            if (index == slotIndex || slot.group.load(std::memory_order_acquire) != currentGroup)
+                continue;
+
+            const auto published = slot.publishedMs.load(std::memory_order_acquire);
+            if (published == 0 || now - published > staleMs)
+                continue;
+
+            loudest = juce::jmax(loudest, slot.levelDb.load(std::memory_order_relaxed));
+        }
+
+        return loudest;
+    }
+
+private:
+    // One cache line per member: members publish from different threads
+    struct alignas(64) Slot
+    {
+        std::atomic<int> group { 0 };
+        std::atomic<float> levelDb { floorDb };
+        std::atomic<juce::uint32> publishedMs { 0 };
+    };
+
+    static std::array<Slot, maxMembers>& getSlots() noexcept
+    {
+        static std::array<Slot, maxMembers> slots;
+        return slots;
+    }
+
+    int slotIndex = -1;
+    int currentGroup = 0;
+    int requestedGroup = 0;   // last join(), even if the table was full
+};
@@ -0,0 +1,199 @@
+#include "MeterHub.h"
+#include <limits>
+#include <mutex>
+
+#if JUCE_MAC || JUCE_LINUX || JUCE_BSD
+ #include <cerrno>
+ #include <fcntl.h>
+ #include <signal.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+ #define FATPRESSOR_METER_HUB 1
+#else
+ #define FATPRESSOR_METER_HUB 0
+#endif
+
+using MeterHubLayout::Segment;
+using MeterHubLayout::Slot;
+
+#if FATPRESSOR_METER_HUB
+namespace
+{
+bool isProcessAlive(juce::int32 pid)
+{
+    return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+}
+
+std::atomic<juce::uint32> nextInstanceId { 1 };
+}
+
+std::shared_ptr<Segment> MeterHub::mapSegment(bool create)
+{
+    // Publishers in one process share a single mapping
+    static std::mutex mappingLock;
+    static std::weak_ptr<Segment> sharedMapping;
+
+    const std::lock_guard<std::mutex> lock(mappingLock);
+    if (auto existing = sharedMapping.lock())
+        return existing;
+
+    const int fd = shm_open(MeterHubLayout::segmentName, create ? (O_RDWR | O_CREAT) : O_RDWR, 0600);
+    if (fd < 0)
+        return {};
+
+    struct stat info {};
+    bool usable = fstat(fd, &info) == 0;
+
+    // A fresh segment is empty; zero-filled by ftruncate is the valid initial state
+    if (usable && info.st_size == 0 && create)
+        usable = ftruncate(fd, static_cast<off_t>(sizeof(Segment))) == 0;
+    else if (usable)
+        usable = info.st_size == static_cast<off_t>(sizeof(Segment));  // other layout version
+
+    void* address = usable ? mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+
+    if (address == MAP_FAILED)
+        return {};
+
+    auto* segment = static_cast<Segment*>(address);
+    juce::uint32 expected = 0;
+    if (segment->magic.load() == 0)
+    {
+        segment->version.store(MeterHubLayout::version);
+        segment->numSlots.store(MeterHubLayout::numSlots);
+        segment->magic.compare_exchange_strong(expected, MeterHubLayout::magic);
+    }
+
+    if (segment->magic.load() != MeterHubLayout::magic || segment->version.load() != MeterHubLayout::version)
+    {
+        munmap(address, sizeof(Segment));
+        return {};
+    }
+
+    std::shared_ptr<Segment> mapping(segment, [](Segment* mapped) { munmap(mapped, sizeof(Segment)); });
+    sharedMapping = mapping;
+    return mapping;
+}
+
+MeterHub::Publisher::Publisher(bool shouldConnect)
+{
+    if (! shouldConnect)
+        return;
+
+    segment = mapSegment(true);
+    if (segment == nullptr)
+        return;
+
+    const auto pid = static_cast<juce::int32>(getpid());
+
+    for (auto& candidate : segment->slots)
+    {
+        // Free, or left behind by a process that died without releasing it
+        auto owner = candidate.ownerPid.load();
+        if (owner != 0 && isProcessAlive(owner))
+            continue;
+
+        if (! candidate.ownerPid.compare_exchange_strong(owner, pid))
+            continue;
+
+        // A dead owner may have stopped mid-write: start from an even sequence
+        const auto sequence = candidate.sequence.load();
+        candidate.sequence.store((sequence + 1u) & ~1u);
+        candidate.instanceId.store(nextInstanceId.fetch_add(1));
+        candidate.updatedMs.store(0);
+        slot = &candidate;
+        return;
+    }
+
+    segment.reset();  // hub full: this instance is not shown
+}
+
+MeterHub::Publisher::~Publisher()
+{
+    if (slot != nullptr)
+        slot->ownerPid.store(0);
+}
+
+void MeterHub::Publisher::publish(const Snapshot& snapshot) noexcept
+{
+    if (slot == nullptr)
+        return;
+
+    const auto sequence = slot->sequence.load(std::memory_order_relaxed);
+    slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        slot->inputDb[channel].store(snapshot.inputDb[channel], std::memory_order_relaxed);
+        slot->outputDb[channel].store(snapshot.outputDb[channel], std::memory_order_relaxed);
+    }
+    slot->gainReductionDb.store(snapshot.gainReductionDb, std::memory_order_relaxed);
+    slot->cpuLoad.store(snapshot.cpuLoad, std::memory_order_relaxed);
+    slot->presetNameHash.store(snapshot.presetNameHash, std::memory_order_relaxed);
+    slot->updatedMs.store(juce::Time::getMillisecondCounter(), std::memory_order_relaxed);
+
+    slot->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+std::vector<MeterHub::Snapshot> MeterHub::readAll()
+{
+    std::vector<Snapshot> snapshots;
+
+    const auto segment = mapSegment(false);
+    if (segment == nullptr)
+        return snapshots;
+
+    const auto now = juce::Time::getMillisecondCounter();
+
+    for (const auto& slot : segment->slots)
+    {
+        const auto owner = slot.ownerPid.load();
+        if (owner == 0 || ! isProcessAlive(owner))
+            continue;
+
+        Snapshot snapshot;
+        juce::uint32 updated = 0;
+        bool consistent = false;
+
+        // Seqlock read; give up on a slot that is being rewritten continuously
+        for (int attempt = 0; attempt < 64 && ! consistent; ++attempt)
+        {
+            const auto before = slot.sequence.load(std::memory_order_acquire);
+            if ((before & 1u) != 0)
+                continue;
+
+            snapshot.processId = slot.ownerPid.load(std::memory_order_relaxed);
+            snapshot.instanceId = slot.instanceId.load(std::memory_order_relaxed);
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                snapshot.inputDb[channel] = slot.inputDb[channel].load(std::memory_order_relaxed);
+                snapshot.outputDb[channel] = slot.outputDb[channel].load(std::memory_order_relaxed);
+            }
+            snapshot.gainReductionDb = slot.gainReductionDb.load(std::memory_order_relaxed);
+            snapshot.cpuLoad = slot.cpuLoad.load(std::memory_order_relaxed);
+            snapshot.presetNameHash = slot.presetNameHash.load(std::memory_order_relaxed);
+            updated = slot.updatedMs.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            consistent = slot.sequence.load(std::memory_order_relaxed) == before;
+        }
+
+        if (! consistent || snapshot.processId == 0)
+            continue;
+
+        snapshot.ageMs = updated == 0 ? std::numeric_limits<juce::uint32>::max() : now - updated;
+        snapshots.push_back(snapshot);
+    }
+
+    return snapshots;
+}
+#else
+std::shared_ptr<Segment> MeterHub::mapSegment(bool) { return {}; }
+MeterHub::Publisher::Publisher(bool) {}
+MeterHub::Publisher::~Publisher() {}
+void MeterHub::Publisher::publish(const Snapshot&) noexcept {}
+std::vector<MeterHub::Snapshot> MeterHub::readAll() { return {}; }
+#endif
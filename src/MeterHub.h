@@ -0,0 +1,108 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Meter hub shared-memory layout ("/fatpressor-meters", POSIX shm)
+ *
+ * A header followed by numSlots cache-line-sized slots, one per live
+ * processor instance in any process of the same user. A zero-filled
+ * segment is valid: every slot is free.
+ *
+ * Each slot is a seqlock: the owning instance's audio thread makes the
+ * sequence odd, stores the payload, then makes it even again. Readers copy
+ * the payload and retry when the sequence was odd or moved, so they never
+ * block the writer and never see a torn snapshot. All fields are lock-free
+ * atomics, which work across processes.
+ */
+namespace MeterHubLayout
+{
+constexpr const char* segmentName = "/fatpressor-meters";
+constexpr juce::uint32 magic = 0x484d5046;   // "FPMH"
+constexpr juce::uint32 version = 1;
+constexpr int numSlots = 256;
+
+struct alignas(64) Slot
+{
+    std::atomic<juce::uint32> sequence;      // odd while being written
+    std::atomic<juce::int32> ownerPid;       // 0 = free
+    std::atomic<juce::uint32> instanceId;    // unique within the owning process
+    std::atomic<juce::uint32> updatedMs;     // Time::getMillisecondCounter() at publish
+
+    // Payload
+    std::atomic<float> inputDb[2];
+    std::atomic<float> outputDb[2];
+    std::atomic<float> gainReductionDb;
+    std::atomic<float> cpuLoad;              // block processing time / block duration
+    std::atomic<juce::uint32> presetNameHash; // juce::String::hashCode() of the preset name
+};
+
+struct Segment
+{
+    std::atomic<juce::uint32> magic;
+    std::atomic<juce::uint32> version;
+    std::atomic<juce::uint32> numSlots;
+    Slot slots[MeterHubLayout::numSlots];
+};
+
+static_assert(std::atomic<float>::is_always_lock_free && std::atomic<juce::uint32>::is_always_lock_free,
+              "the meter hub needs address-free atomics");
+}
+
+/**
+ * @brief Console-wide meter overview through shared memory
+ *
+ * Every processor owns a Publisher that claims a slot in the hub and
+ * publishes its meter snapshot once per block (a handful of atomic stores,
+ * no system calls). An overview window or an external tool reads all
+ * instances with readAll(), one scan of the segment, without ever touching
+ * an instance's audio thread.
+ *
+ * POSIX only (macOS, Linux); elsewhere publishing is a no-op and readAll()
+ * returns nothing.
+ */
+class MeterHub
+{
+public:
+    struct Snapshot
+    {
+        int processId = 0;
+        juce::uint32 instanceId = 0;
+        float inputDb[2] { -60.0f, -60.0f };
+        float outputDb[2] { -60.0f, -60.0f };
+        float gainReductionDb = 0.0f;
+        float cpuLoad = 0.0f;
+        juce::uint32 presetNameHash = 0;
+        juce::uint32 ageMs = 0;              // since the last publish (readAll() only)
+    };
+
+    class Publisher
+    {
+    public:
+        /** Maps the segment and claims a slot unless told not to (not real-time safe) */
+        explicit Publisher(bool shouldConnect = true);
+        ~Publisher();
+
+        bool isConnected() const { return slot != nullptr; }
+
+        /** Write a snapshot (audio thread; wait-free) */
+        void publish(const Snapshot& snapshot) noexcept;
+
+    private:
+        std::shared_ptr<MeterHubLayout::Segment> segment;
+        MeterHubLayout::Slot* slot = nullptr;
+
+        JUCE_DECLARE_NON_COPYABLE(Publisher)
+    };
+
+    /**
+     * @brief Consistent snapshots of all live instances (any thread, any process)
+     */
+    static std::vector<Snapshot> readAll();
+
+private:
+    static std::shared_ptr<MeterHubLayout::Segment> mapSegment(bool create);
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+
+/**
+ * @brief Timestamped parameter change for the current block
+ */
+struct ParameterEvent
+{
+    enum class Type
+    {
+        value,        // new parameter value (plain, denormalised)
+        modulation    // non-destructive offset on top of the value (normalised)
+    };
+
+    int sampleOffset = 0;      // position inside the block
+    int parameterIndex = 0;    // index into AudioProcessor::getParameters()
+    float value = 0.0f;
+    Type type = Type::value;
+};
+
+/**
+ * @brief Fixed-capacity list of parameter changes for one block
+ *
+ * Filled on the audio thread by format glue that has sample-accurate
+ * parameter timestamps (the CLAP build), right before processBlock(), and
+ * consumed by it. JUCE's own VST3/AU wrappers only deliver one value per
+ * block, so with those formats the queue stays empty and the block is
+ * processed whole.
+ *
+ * No allocation: events past the capacity are dropped (the parameter still
+ * reaches its final value through the host-side update).
+ */
+class ParameterEventQueue
+{
+public:
+    static constexpr int capacity = 1024;
+
+    void clear() { numEvents = 0; }
+
+    bool isEmpty() const { return numEvents == 0; }
+    int size() const { return numEvents; }
+
+    /**
+     * @brief Add an event; returns false if the queue is full
+     */
+    bool add(int sampleOffset, int parameterIndex, float value,
+             ParameterEvent::Type type = ParameterEvent::Type::value)
+    {
+        if (numEvents >= capacity)
+            return false;
+
+        events[static_cast<size_t>(numEvents++)] = { juce::jmax(0, sampleOffset), parameterIndex, value, type };
+        return true;
+    }
+
+    /**
+     * @brief Stable sort by sample offset (hosts normally deliver in order)
+     */
+    void sortByTime()
+    {
+        // Insertion sort: no allocation, linear for already-ordered input
+        for (int i = 1; i < numEvents; ++i)
+        {
+            const auto event = events[static_cast<size_t>(i)];
+            int j = i - 1;
+            while (j >= 0 && events[static_cast<size_t>(j)].sampleOffset > event.sampleOffset)
+            {
+                events[static_cast<size_t>(j + 1)] = events[static_cast<size_t>(j)];
+                --j;
+            }
+            events[static_cast<size_t>(j + 1)] = event;
+        }
+    }
+
+    const ParameterEvent* begin() const { return events.data(); }
+    const ParameterEvent* end() const { return events.data() + numEvents; }
+
+private:
+    std::array<ParameterEvent, capacity> events {};
+    int numEvents = 0;
+};
@@ -139,6 +139,7 @@ void FatPressorAudioProcessorEditor::timerCallback()
     data->setProperty("outputL", processorRef.outputLevelL.load());
     data->setProperty("outputR", processorRef.outputLevelR.load());
     data->setProperty("gr", processorRef.gainReduction.load());
+    data->setProperty("exp", processorRef.expansion.load());
 
     webView->emitEventIfBrowserIsVisible("metering", juce::var(data.get()));
 }
@@ -1,28 +1,60 @@
 #include "PluginProcessor.h"
-#include "PluginEditor.h"
+
+#if ! FATPRESSOR_HEADLESS
+ #include "PluginEditor.h"
+#endif
+
+#if FATPRESSOR_CLAP
+namespace
+{
+/**
+ * @brief Float parameter flagged as modulatable for CLAP hosts
+ * The modulation itself arrives as direct events and is applied by the processor.
+ */
+class FloatParameter : public juce::AudioParameterFloat,
+                       public clap_juce_extensions::clap_juce_parameter_capabilities
+{
+public:
+    using juce::AudioParameterFloat::AudioParameterFloat;
+
+    bool supportsMonophonicModulation() override { return true; }
+};
+}
+#else
+using FloatParameter = juce::AudioParameterFloat;
+#endif
 
 FatPressorAudioProcessor::FatPressorAudioProcessor()
+    : FatPressorAudioProcessor(Options {})
+{
+}
+
+FatPressorAudioProcessor::FatPressorAudioProcessor(const Options& options)
     : AudioProcessor(BusesProperties()
         .withInput("Input", juce::AudioChannelSet::stereo(), true)
         .withOutput("Output", juce::AudioChannelSet::stereo(), true))
     , parameters(*this, nullptr, "Parameters", createParameterLayout())
     , presetManager(parameters)
+    , meterHub(options.publishMeters)
 {
     // Get raw parameter pointers for real-time access
-    thresholdParam = parameters.getRawParameterValue("threshold");
-    ratioParam = parameters.getRawParameterValue("ratio");
-    attackParam = parameters.getRawParameterValue("attack");
-    releaseParam = parameters.getRawParameterValue("release");
-    fatParam = parameters.getRawParameterValue("fat");
-    outputParam = parameters.getRawParameterValue("output");
-    mixParam = parameters.getRawParameterValue("mix");
+    bindParameters();
+    startTimerHz(parameterWriteBackHz);
+
+    sessionCaptureEnabled = options.sessionCapture;
+
+    // Tables only change when the block start bakes them (see processBlock)
+    inlineTableBuilds = ! options.backgroundTableBuilds;
+    tubeSaturation.getCurveTables().setDeterministic(inlineTableBuilds);
 
     // Initialize preset manager
-    presetManager.initialize();
+    if (options.installFactoryPresets)
+        presetManager.initialize();
 }
 
 FatPressorAudioProcessor::~FatPressorAudioProcessor()
 {
+    stopTimer();
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout
@@ -31,7 +63,7 @@ FatPressorAudioProcessor::createParameterLayout()
     std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
 
     // Threshold: -60 to 0 dB, default -20
-    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+    params.push_back(std::make_unique<FloatParameter>(
         juce::ParameterID { "threshold", 1 },
         "Threshold",
         juce::NormalisableRange<float>(-60.0f, 0.0f, 0.1f),
@@ -39,7 +71,7 @@ FatPressorAudioProcessor::createParameterLayout()
         juce::AudioParameterFloatAttributes().withLabel("dB")));
 
     // Ratio: 1:1 to 20:1, default 4:1, skewed for finer control at low ratios
-    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+    params.push_back(std::make_unique<FloatParameter>(
         juce::ParameterID { "ratio", 1 },
         "Ratio",
         juce::NormalisableRange<float>(1.0f, 20.0f, 0.1f, 0.5f),
@@ -47,7 +79,7 @@ FatPressorAudioProcessor::createParameterLayout()
         juce::AudioParameterFloatAttributes().withLabel(":1")));
 
     // Attack: 0.1 to 100 ms, default 10, logarithmic skew
-    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+    params.push_back(std::make_unique<FloatParameter>(
         juce::ParameterID { "attack", 1 },
         "Attack",
         juce::NormalisableRange<float>(0.1f, 100.0f, 0.1f, 0.3f),
@@ -55,7 +87,7 @@ FatPressorAudioProcessor::createParameterLayout()
         juce::AudioParameterFloatAttributes().withLabel("ms")));
 
     // Release: 10 to 1000 ms, default 100, logarithmic skew
-    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+    params.push_back(std::make_unique<FloatParameter>(
         juce::ParameterID { "release", 1 },
         "Release",
         juce::NormalisableRange<float>(10.0f, 1000.0f, 1.0f, 0.3f),
@@ -63,7 +95,7 @@ FatPressorAudioProcessor::createParameterLayout()
         juce::AudioParameterFloatAttributes().withLabel("ms")));
 
     // FAT: 0 to 100%, default 50 - the signature warmth control
-    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+    params.push_back(std::make_unique<FloatParameter>(
         juce::ParameterID { "fat", 1 },
         "FAT",
         juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f),
@@ -71,7 +103,7 @@ FatPressorAudioProcessor::createParameterLayout()
         juce::AudioParameterFloatAttributes().withLabel("%")));
 
     // Output: -12 to +12 dB, default 0
-    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+    params.push_back(std::make_unique<FloatParameter>(
         juce::ParameterID { "output", 1 },
         "Output",
         juce::NormalisableRange<float>(-12.0f, 12.0f, 0.1f),
@@ -79,30 +111,120 @@ FatPressorAudioProcessor::createParameterLayout()
         juce::AudioParameterFloatAttributes().withLabel("dB")));
 
     // Mix: 0 to 100%, default 100
-    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+    params.push_back(std::make_unique<FloatParameter>(
         juce::ParameterID { "mix", 1 },
         "Mix",
         juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f),
         100.0f,
         juce::AudioParameterFloatAttributes().withLabel("%")));
 
+    // Tube Mode: waveshaper used by the tube stage, default Classic
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID { "tubeMode", 2 },
+        "Tube Mode",
+        juce::StringArray { "Classic", "Harmonic", "Triode" },
+        0));
+
+    // Iron Hysteresis: magnetic core model in the transformer stage, default off
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID { "hysteresis", 2 },
+        "Iron Hysteresis",
+        false));
+
+    // Link Group: instances in the same group compress together, default off
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID { "linkGroup", 3 },
+        "Link Group",
+        juce::StringArray { "Off", "1", "2", "3", "4", "5", "6", "7", "8" },
+        0));
+
+    // Stage switches: take a stage out of the chain entirely, default all in
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID { "tubeEnabled", 4 },
+        "Tube",
+        true));
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID { "compressionEnabled", 4 },
+        "Compression",
+        true));
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID { "ironEnabled", 4 },
+        "Iron",
+        true));
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID { "eqEnabled", 4 },
+        "EQ",
+        true));
+
+    // Chain Order: where compression sits relative to tube and iron, default classic
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID { "chainOrder", 5 },
+        "Chain Order",
+        juce::StringArray { "Tube > Comp > Iron", "Comp > Tube > Iron", "Tube > Iron > Comp" },
+        0));
+
+    // Comp Mode: opto alone, opto into a fast VCA for peaks, or split-band de-essing, default Opto
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID { "compMode", 6 },
+        "Comp Mode",
+        juce::StringArray { "Opto", "Opto + VCA", "De-Ess" },
+        0));
+
+    // Expander Threshold: -80 to 0 dB, default -50 - level the expander opens at
+    // (the detector reads down to -90 dB, so it can still close at -80 with hysteresis)
+    static_assert(SidechainDetector::floorDb <= -80.0f - 10.0f && EnvelopeFollower::floorDb == SidechainDetector::floorDb
+                      && LinkGroup::floorDb == EnvelopeFollower::floorDb,
+                  "the expander's level must reach below its lowest threshold");
+    params.push_back(std::make_unique<FloatParameter>(
+        juce::ParameterID { "expThreshold", 7 },
+        "Expander Threshold",
+        juce::NormalisableRange<float>(-80.0f, 0.0f, 0.1f),
+        -50.0f,
+        juce::AudioParameterFloatAttributes().withLabel("dB")));
+
+    // Expander Ratio: 1:1 (off) to 20:1 (gate), default off
+    params.push_back(std::make_unique<FloatParameter>(
+        juce::ParameterID { "expRatio", 7 },
+        "Expander Ratio",
+        juce::NormalisableRange<float>(1.0f, 20.0f, 0.1f, 0.5f),
+        1.0f,
+        juce::AudioParameterFloatAttributes().withLabel(":1")));
+
+    // Expander Hysteresis: 0 to 12 dB below the threshold before closing, default 3
+    params.push_back(std::make_unique<FloatParameter>(
+        juce::ParameterID { "expHysteresis", 7 },
+        "Expander Hysteresis",
+        juce::NormalisableRange<float>(0.0f, 12.0f, 0.1f),
+        3.0f,
+        juce::AudioParameterFloatAttributes().withLabel("dB")));
+
+    // Expander Hold: 0 to 500 ms open after the level drops, default 20
+    params.push_back(std::make_unique<FloatParameter>(
+        juce::ParameterID { "expHold", 7 },
+        "Expander Hold",
+        juce::NormalisableRange<float>(0.0f, 500.0f, 1.0f, 0.5f),
+        20.0f,
+        juce::AudioParameterFloatAttributes().withLabel("ms")));
+
     return { params.begin(), params.end() };
 }
 
 void FatPressorAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     currentSampleRate = sampleRate;
+    preparedBlockSize = juce::jmax(1, samplesPerBlock);
 
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock);
-    spec.numChannels = static_cast<juce::uint32>(getTotalNumOutputChannels());
+    // Take every parameter as it is now
+    updateParameterSnapshot(true);
+    parameterEvents.clear();
 
-    // Initialize smoothed parameters - fast response for real-time feel
     // Compression params: very fast (2ms) - user expects instant response
     thresholdSmoothed.reset(sampleRate, 0.002);
     ratioSmoothed.reset(sampleRate, 0.002);
-    // Timing params: no smoothing needed (envelope follower handles timing)
+    // Timing params: just enough to avoid coefficient jumps (1ms)
     attackSmoothed.reset(sampleRate, 0.001);
     releaseSmoothed.reset(sampleRate, 0.001);
     // FAT: moderate smoothing (5ms) to avoid clicks in saturation
@@ -110,34 +232,58 @@ void FatPressorAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBl
     // Output/Mix: short smoothing (3ms) for click-free but responsive
     outputSmoothed.reset(sampleRate, 0.003);
     mixSmoothed.reset(sampleRate, 0.003);
+    outputSmoothed.setCurrentAndTargetValue(parameterSnapshot.output);
+    mixSmoothed.setCurrentAndTargetValue(parameterSnapshot.mix);
+
+    // One arena for every stage's scratch, sized once so processBlock never allocates
+    const auto dryFloats = dryChannels.size() * DspArena::regionFloats(static_cast<size_t>(preparedBlockSize));
+    arena.reserve(2 * dryFloats   // dry copy and a fading stage's input
+                  + SidechainDetector::getArenaFloats(sampleRate)
+                  + TubeSaturation::getArenaFloats(samplesPerBlock)
+                  + TransformerColoration::getArenaFloats(samplesPerBlock));
+
+    // Dry copy for the mix
+    for (auto& channel : dryChannels)
+        channel = arena.allocate(static_cast<size_t>(preparedBlockSize));
+    for (auto& channel : stageInputChannels)
+        channel = arena.allocate(static_cast<size_t>(preparedBlockSize));
 
-    // Set initial values
-    thresholdSmoothed.setCurrentAndTargetValue(thresholdParam->load());
-    ratioSmoothed.setCurrentAndTargetValue(ratioParam->load());
-    attackSmoothed.setCurrentAndTargetValue(attackParam->load());
-    releaseSmoothed.setCurrentAndTargetValue(releaseParam->load());
-    fatSmoothed.setCurrentAndTargetValue(fatParam->load());
-    outputSmoothed.setCurrentAndTargetValue(outputParam->load());
-    mixSmoothed.setCurrentAndTargetValue(mixParam->load());
+    for (auto& fade : stageFades)
+        fade.prepare(sampleRate, stageFadeSeconds);
+    chainLevel.reset(sampleRate, stageFadeSeconds / 2.0);
+    chainLevel.setCurrentAndTargetValue(1.0f);
 
     // Prepare DSP components
-    sidechainDetector.prepare(sampleRate, samplesPerBlock);
+    sidechainDetector.prepare(sampleRate, samplesPerBlock, arena);
     envelopeFollower.prepare(sampleRate, samplesPerBlock);
-    envelopeFollower.setAttackMs(attackParam->load());
-    envelopeFollower.setReleaseMs(releaseParam->load());
     gainComputer.prepare(sampleRate, samplesPerBlock);
-    gainComputer.setThreshold(thresholdParam->load());
-    gainComputer.setRatio(ratioParam->load());
     gainComputer.setKneeWidth(6.0f);  // 6dB soft knee per spec
-    tubeSaturation.prepare(sampleRate, samplesPerBlock);
-    tubeSaturation.setDrive(fatParam->load() / 100.0f);  // FAT controls tube drive
-    transformerColoration.prepare(sampleRate, samplesPerBlock);
-    transformerColoration.setAmount(fatParam->load() / 100.0f);  // FAT controls transformer color
+    vcaGainComputer.prepare(sampleRate, samplesPerBlock);
+    vcaGainComputer.setKneeWidth(vcaKneeDb);
+    deEssSplit.prepare(sampleRate, deEssSplitFrequency);
+
+    // Push all values into the stages (FAT set first: the tube stage bakes its
+    // curve and the transformer settles its shelves in prepare)
+    updateDspStages(true);
+    tubeSaturation.prepare(sampleRate, samplesPerBlock, arena);
+    transformerColoration.prepare(sampleRate, samplesPerBlock, arena);
+
+    // The transformer's oversampler is linear-phase with a fixed latency on
+    // every path while its hysteresis core is enabled; report it and delay
+    // the dry signal so Mix does not comb (see updateDspStages())
+    dryDelay.setDelay(transformerColoration.getCoreLatencySamples());
+    dryDelay.setActive(transformerColoration.getLatencySamples() > 0, 0);
+    setLatencySamples(transformerColoration.getLatencySamples());
+
+    // Opt-in capture starts here, so a replay can start from the same state
+    startSessionCapture(sampleRate);
 }
 
 void FatPressorAudioProcessor::releaseResources()
 {
     // Release DSP resources
+    sessionRecorder.stop();
+    linkGroup.leave();
 }
 
 bool FatPressorAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
@@ -157,6 +303,7 @@ void FatPressorAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
 {
     juce::ignoreUnused(midiMessages);
     juce::ScopedNoDenormals noDenormals;
+    const auto blockStartTicks = meterHub.isConnected() ? juce::Time::getHighResolutionTicks() : 0;
 
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -166,14 +313,24 @@ void FatPressorAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, numSamples);
 
-    // Update smoothed parameter targets
-    thresholdSmoothed.setTargetValue(thresholdParam->load());
-    ratioSmoothed.setTargetValue(ratioParam->load());
-    attackSmoothed.setTargetValue(attackParam->load());
-    releaseSmoothed.setTargetValue(releaseParam->load());
-    fatSmoothed.setTargetValue(fatParam->load());
-    outputSmoothed.setTargetValue(outputParam->load());
-    mixSmoothed.setTargetValue(mixParam->load());
+    // Values the host/UI set for this block
+    updateParameterSnapshot(false);
+
+    // Session capture: parameter values as the block starts
+    const bool capturing = sessionRecorder.isRecording();
+    auto& curveTables = tubeSaturation.getCurveTables();
+    capturedHandOffs.clear();
+
+    // Embedded instances have no builder thread: bake the table FAT asked for
+    // last block here (allocates, only when FAT moved)
+    if (inlineTableBuilds)
+        curveTables.buildRequestedNow();
+    if (capturing)
+    {
+        const auto& allParameters = getParameters();
+        for (int i = 0; i < allParameters.size(); ++i)
+            capturedParameterValues[static_cast<size_t>(i)] = allParameters.getUnchecked(i)->getValue();
+    }
 
     // Measure input level
     float inL = buffer.getMagnitude(0, 0, numSamples);
@@ -181,122 +338,930 @@ void FatPressorAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     inputLevelL.store(juce::Decibels::gainToDecibels(inL, -60.0f));
     inputLevelR.store(juce::Decibels::gainToDecibels(inR, -60.0f));
 
-    // Store dry signal for mix
-    juce::AudioBuffer<float> dryBuffer;
-    dryBuffer.makeCopyOf(buffer);
+    // Store dry signal for mix (refers to the arena; only a block longer than
+    // the host announced makes the buffer allocate its own storage)
+    if (numSamples <= preparedBlockSize)
+        dryBuffer.setDataToReferTo(dryChannels.data(), juce::jmin(buffer.getNumChannels(), static_cast<int>(dryChannels.size())),
+                                   numSamples);
+    else
+        dryBuffer.setSize(buffer.getNumChannels(), numSamples, false, false, true);
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        dryBuffer.copyFrom(channel, 0, buffer, channel, 0, numSamples);
 
     // ============================================
     // FULL DSP CHAIN: FatPressor Compression
     // ============================================
     // Signal flow: Input → TubeSat → Compression → Transformer → Output → Mix
+    // (first three in the order picked by Chain Order)
+    //
+    // The block is split at timestamped parameter changes so automation
+    // lands on the right sample instead of at the next block.
 
-    // Skip smoothing to target for fast response - these need instant feel
-    thresholdSmoothed.skip(numSamples);
-    ratioSmoothed.skip(numSamples);
-    attackSmoothed.skip(numSamples);
-    releaseSmoothed.skip(numSamples);
-    fatSmoothed.skip(numSamples);
+    float peakGainReduction = 0.0f;
+    peakExpansion = 0.0f;
 
-    // Get current parameter values (now at target after skip)
-    const float currentThreshold = thresholdSmoothed.getCurrentValue();
-    const float currentRatio = ratioSmoothed.getCurrentValue();
-    const float currentAttack = attackSmoothed.getCurrentValue();
-    const float currentRelease = releaseSmoothed.getCurrentValue();
-    const float currentFat = fatSmoothed.getCurrentValue() / 100.0f;  // 0-1
+    // Link group: glide from the level the other members published last
+    // block to what they have published now (at most one block of skew)
+    linkedLevelStart = linkedLevelEnd;
+    linkedLevelEnd = linkGroup.readOthers();
+    linkBlockLength = juce::jmax(1, numSamples);
+    ownLinkLevel = LinkGroup::floorDb;
 
-    // Update envelope follower timing
-    envelopeFollower.setAttackMs(currentAttack);
-    envelopeFollower.setReleaseMs(currentRelease);
+    parameterEvents.sortByTime();
+    auto event = parameterEvents.begin();
+    auto scheduledHandOff = scheduledHandOffs.begin();
+    int startSample = 0;
 
-    // Update gain computer settings
-    gainComputer.setThreshold(currentThreshold);
-    gainComputer.setRatio(currentRatio);
+    while (startSample < numSamples)
+    {
+        for (; event != parameterEvents.end() && event->sampleOffset <= startSample; ++event)
+            applyParameterEvent(*event);
 
-    // Update saturation amounts
-    tubeSaturation.setDrive(currentFat);
-    transformerColoration.setAmount(currentFat);
+        // Split at the next event, but not closer than minSubBlockSize
+        // and never past what the stages were prepared for
+        int endSample = numSamples;
+        if (event != parameterEvents.end())
+            endSample = juce::jmin(numSamples, juce::jmax(startSample + minSubBlockSize, event->sampleOffset));
+        endSample = juce::jmin(endSample, startSample + juce::jmax(1, preparedBlockSize));
 
-    // 1. PRE-COMPRESSION: Tube Saturation (adds warmth before compression)
-    tubeSaturation.processBlock(buffer);
+        // FAT glides in steps (the target may change in this sub-block's updateDspStages)
+        if (fatSmoothed.isSmoothing() || parameterSnapshot.fat != fatSmoothed.getTargetValue())
+            endSample = juce::jmin(endSample, startSample + fatSmoothingStep);
 
-    // 2. COMPRESSION: Per-sample processing for smooth gain reduction
-    float peakGainReduction = 0.0f;
+        // So is an order swap, so the chain comes back in as soon as it is silent
+        if (isChainOrderSwapping() || juce::roundToInt(parameterSnapshot.chainOrder) != chainOrder)
+            endSample = juce::jmin(endSample, startSample + minSubBlockSize);
+
+        // Replay: hand over the tables the live instance picked up here
+        for (; scheduledHandOff != scheduledHandOffs.end() && scheduledHandOff->sampleOffset <= startSample; ++scheduledHandOff)
+            curveTables.buildNow(scheduledHandOff->drive);
 
-    for (int sample = 0; sample < numSamples; ++sample)
+        const int handOffsBefore = curveTables.getHandOffCount();
+        processSubBlock(buffer, startSample, endSample - startSample, peakGainReduction);
+
+        // Sub-blocks are at least minSubBlockSize long, so the capacity reserved
+        // in startSessionCapture() holds every hand-off of a prepared-size block
+        if (capturing && curveTables.getHandOffCount() != handOffsBefore
+            && capturedHandOffs.size() < capturedHandOffs.capacity())
+            capturedHandOffs.push_back({ startSample, curveTables.getCurrentDrive() });
+
+        startSample = endSample;
+    }
+
+    scheduledHandOffs.clear();
+
+    // Events stamped past the end still set the value the next block starts from
+    for (; event != parameterEvents.end(); ++event)
+        applyParameterEvent(*event);
+
+    if (capturing)
+        sessionRecorder.recordBlock(dryBuffer, numSamples, capturedParameterValues, parameterEvents,
+                                    hostProgram.load(), capturedHandOffs);
+
+    parameterEvents.clear();
+    writeBackParameterEvents();
+
+    linkGroup.publish(ownLinkLevel);
+
+    // Store gain reduction for metering (positive value for display),
+    // compression and expansion apart
+    gainReduction.store(-peakGainReduction);
+    expansion.store(-peakExpansion);
+
+    // Measure output level
+    float outL = buffer.getMagnitude(0, 0, numSamples);
+    float outR = buffer.getNumChannels() > 1 ? buffer.getMagnitude(1, 0, numSamples) : outL;
+    outputLevelL.store(juce::Decibels::gainToDecibels(outL, -60.0f));
+    outputLevelR.store(juce::Decibels::gainToDecibels(outR, -60.0f));
+
+    if (meterHub.isConnected() && numSamples > 0)
     {
+        const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - blockStartTicks);
+        const auto load = static_cast<float>(seconds * currentSampleRate / numSamples);
+        cpuLoad += 0.1f * (load - cpuLoad);
+
+        MeterHub::Snapshot snapshot;
+        snapshot.inputDb[0] = inputLevelL.load(std::memory_order_relaxed);
+        snapshot.inputDb[1] = inputLevelR.load(std::memory_order_relaxed);
+        snapshot.outputDb[0] = outputLevelL.load(std::memory_order_relaxed);
+        snapshot.outputDb[1] = outputLevelR.load(std::memory_order_relaxed);
+        snapshot.gainReductionDb = -peakGainReduction;
+        snapshot.cpuLoad = cpuLoad;
+        snapshot.presetNameHash = presetManager.getCurrentPresetNameHash();
+        meterHub.publish(snapshot);
+    }
+}
+
+#if FATPRESSOR_CLAP
+bool FatPressorAudioProcessor::supportsDirectEvent(uint16_t spaceId, uint16_t type)
+{
+    return spaceId == CLAP_CORE_EVENT_SPACE_ID
+        && (type == CLAP_EVENT_PARAM_VALUE || type == CLAP_EVENT_PARAM_MOD);
+}
+
+void FatPressorAudioProcessor::handleDirectEvent(const clap_event_header_t* event, int sampleOffset)
+{
+    // The wrapper hands over the block's events before processBlock();
+    // values and modulation amounts are in the normalised 0-1 range.
+    // sampleOffset is where the event falls in the block the wrapper passes
+    // to processBlock(), which is not event->time when it splits the
+    // host's block.
+    const auto queueEvent = [this, sampleOffset](clap_id paramId, double amount, ParameterEvent::Type type)
+    {
+        for (size_t index = 0; index < parameterBindings.size(); ++index)
+        {
+            const auto& binding = parameterBindings[index];
+            if (binding.field == nullptr || binding.clapId != paramId)
+                continue;
+
+            const float value = type == ParameterEvent::Type::value
+                                  ? binding.parameter->convertFrom0to1(juce::jlimit(0.0f, 1.0f, static_cast<float>(amount)))
+                                  : static_cast<float>(amount);
+
+            parameterEvents.add(sampleOffset, static_cast<int>(index), value, type);
+            return;
+        }
+    };
+
+    if (event->type == CLAP_EVENT_PARAM_VALUE)
+    {
+        const auto* valueEvent = reinterpret_cast<const clap_event_param_value_t*>(event);
+        queueEvent(valueEvent->param_id, valueEvent->value, ParameterEvent::Type::value);
+    }
+    else if (event->type == CLAP_EVENT_PARAM_MOD)
+    {
+        const auto* modEvent = reinterpret_cast<const clap_event_param_mod_t*>(event);
+        queueEvent(modEvent->param_id, modEvent->amount, ParameterEvent::Type::modulation);
+    }
+}
+#endif
+
+/**
+ * @brief Tube saturation (adds warmth, normally before compression)
+ */
+struct FatPressorAudioProcessor::TubeChainStage
+{
+    static constexpr Stage timingStage = tubeStage;
+
+    template <int stageMask>
+    static void process(FatPressorAudioProcessor& processor, SubBlock& subBlock)
+    {
+        if constexpr ((stageMask & tubeSwitch) != 0)
+        {
+            if (processor.isStageFading(tubeSwitch))
+                processor.keepStageInput(subBlock);
+
+            processor.tubeSaturation.processBlock(subBlock.block);
+            processor.blendStageFade(subBlock, tubeSwitch);
+        }
+    }
+};
+
+/**
+ * @brief Per-sample compression for smooth gain reduction
+ */
+struct FatPressorAudioProcessor::CompressionChainStage
+{
+    static constexpr Stage timingStage = compressionStage;
+
+    template <int stageMask>
+    static void process(FatPressorAudioProcessor& processor, SubBlock& subBlock)
+    {
+        if constexpr ((stageMask & compressionSwitch) != 0)
+        {
+            if (processor.isStageFading(compressionSwitch))
+                processor.keepStageInput(subBlock);
+
+            // Mode picked per sub-block; each mode is its own loop
+            switch (processor.compressionMode)
+            {
+                case CompressionMode::optoVca:
+                    processor.processCompression<CompressionMode::optoVca>(subBlock);
+                    break;
+                case CompressionMode::deEss:
+                    processor.processCompression<CompressionMode::deEss>(subBlock);
+                    break;
+                case CompressionMode::opto:
+                default:
+                    processor.processCompression<CompressionMode::opto>(subBlock);
+                    break;
+            }
+
+            processor.blendStageFade(subBlock, compressionSwitch);
+        }
+        else
+        {
+            processor.skipCompressorSmoothing(subBlock.endSample - subBlock.startSample);
+        }
+    }
+};
+
+/**
+ * @brief Transformer coloration (adds "iron" character)
+ */
+struct FatPressorAudioProcessor::TransformerChainStage
+{
+    static constexpr Stage timingStage = transformerStage;
+
+    template <int stageMask>
+    static void process(FatPressorAudioProcessor& processor, SubBlock& subBlock)
+    {
+        if constexpr ((stageMask & ironSwitch) != 0)
+        {
+            // The iron fades against its aligned dry path, not its raw input
+            if (processor.isStageFading(ironSwitch))
+                processor.transformerColoration.copyIronDry(subBlock.block, processor.stageInputChannels.data());
+
+            processor.transformerColoration.processIron(subBlock.block);
+            processor.blendStageFade(subBlock, ironSwitch);
+        }
+        else
+        {
+            processor.transformerColoration.processIronBypassed(subBlock.block);  // keeps the latency
+        }
+
+        if constexpr ((stageMask & shelvesSwitch) != 0)
+        {
+            if (processor.isStageFading(shelvesSwitch))
+                processor.keepStageInput(subBlock);
+
+            processor.transformerColoration.processShelves(subBlock.block);
+            processor.blendStageFade(subBlock, shelvesSwitch);
+        }
+    }
+};
+
+template <size_t... kernels>
+constexpr std::array<FatPressorAudioProcessor::StageKernel, sizeof...(kernels)>
+FatPressorAudioProcessor::makeStageKernels(std::index_sequence<kernels...>)
+{
+    constexpr size_t numSwitchMasks = allStageSwitches + 1;
+    return { &FatPressorAudioProcessor::processStages<static_cast<int>(kernels / numSwitchMasks),
+                                                      static_cast<int>(kernels % numSwitchMasks)>... };
+}
+
+void FatPressorAudioProcessor::processSubBlock(juce::AudioBuffer<float>& buffer, int startSample,
+                                               int numSamples, float& peakGainReduction)
+{
+    // One kernel per chain order and combination of stage switches
+    static constexpr auto stageKernels = makeStageKernels(
+        std::make_index_sequence<static_cast<size_t>(numChainOrders * (allStageSwitches + 1))>());
+
+    updateDspStages(false);
+
+    // processBlock() keeps these sub-blocks at most fatSmoothingStep long
+    if (fatSmoothed.isSmoothing())
+        applyFat(fatSmoothed.skip(numSamples));
+
+    // New chain order: fade the chain out, swap once it is silent, fade back in
+    if (requestedChainOrder != chainOrder)
+    {
+        chainLevel.setTargetValue(0.0f);
+        if (! chainLevel.isSmoothing())
+        {
+            chainOrder = requestedChainOrder;
+            chainLevel.setTargetValue(1.0f);
+        }
+    }
+
+    // A stage gliding out stays in the kernel until its fade is over
+    kernelChainOrder = chainOrder;
+    kernelStages = enabledStages | fadingStages;
+    const auto kernel = static_cast<size_t>(kernelChainOrder * (allStageSwitches + 1) + kernelStages);
+    (this->*stageKernels[kernel])(buffer, startSample, numSamples, peakGainReduction);
+
+    for (int bit = 0; bit < numStageSwitches; ++bit)
+        if (stageFades[static_cast<size_t>(bit)].advance(numSamples))
+            fadingStages &= ~(1 << bit);
+}
+
+void FatPressorAudioProcessor::keepStageInput(const SubBlock& subBlock)
+{
+    const auto numChannels = juce::jmin(subBlock.block.getNumChannels(), stageInputChannels.size());
+    for (size_t channel = 0; channel < numChannels; ++channel)
+        std::copy_n(subBlock.block.getChannelPointer(channel), subBlock.block.getNumSamples(), stageInputChannels[channel]);
+}
+
+void FatPressorAudioProcessor::blendStageFade(SubBlock& subBlock, int stageSwitch)
+{
+    if (! isStageFading(stageSwitch))
+        return;
+
+    // Switch bit to fade index
+    int bit = 0;
+    while ((stageSwitch >> bit) != 1)
+        ++bit;
+
+    const auto& fade = stageFades[static_cast<size_t>(bit)];
+    const bool fadingIn = (enabledStages & stageSwitch) != 0;
+    const auto numChannels = juce::jmin(subBlock.block.getNumChannels(), stageInputChannels.size());
+    const int numSamples = static_cast<int>(subBlock.block.getNumSamples());
+
+    for (size_t channel = 0; channel < numChannels; ++channel)
+    {
+        auto* stageOutput = subBlock.block.getChannelPointer(channel);
+        auto* stageInput = stageInputChannels[channel];
+
+        // Fading out glides toward the input; past the fade only the input is left
+        if (fadingIn)
+        {
+            fade.blend(stageInput, stageOutput, numSamples);
+        }
+        else
+        {
+            fade.blend(stageOutput, stageInput, numSamples);
+            std::copy_n(stageInput, numSamples, stageOutput);
+        }
+    }
+}
+
+template <int stageMask, typename... ChainStages>
+void FatPressorAudioProcessor::processChain(SubBlock& subBlock, const std::tuple<ChainStages...>&)
+{
+    // Unrolled at compile time in the order of the tuple
+    ((ChainStages::template process<stageMask>(*this, subBlock), markStage(subBlock, ChainStages::timingStage)), ...);
+}
+
+template <int order, int stageMask>
+void FatPressorAudioProcessor::processStages(juce::AudioBuffer<float>& buffer, int startSample,
+                                             int numSamples, float& peakGainReduction)
+{
+    const auto& params = parameterSnapshot;
+    const int endSample = startSample + numSamples;
+
+    SubBlock subBlock {
+        buffer,
+        juce::dsp::AudioBlock<float>(buffer).getSubBlock(static_cast<size_t>(startSample), static_cast<size_t>(numSamples)),
+        startSample,
+        endSample,
+        peakGainReduction,
+        stageTimingEnabled ? juce::Time::getHighResolutionTicks() : 0
+    };
+
+    // 1-3. Tube, compression and transformer, in the selected order
+    processChain<stageMask>(subBlock, std::tuple_element_t<static_cast<size_t>(order), ChainOrders> {});
+
+    // 4. OUTPUT GAIN AND MIX
+    outputSmoothed.setTargetValue(params.output);
+    mixSmoothed.setTargetValue(params.mix);
+
+    // Wet level across a chain order swap, stepped linearly over the sub-block
+    const float chainLevelStart = chainLevel.getCurrentValue();
+    const float chainLevelStep = (chainLevel.skip(numSamples) - chainLevelStart) / static_cast<float>(juce::jmax(1, numSamples));
+
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        auto* wetData = buffer.getWritePointer(channel);
+        const auto* dryData = dryBuffer.getReadPointer(channel);
+
+        for (int sample = startSample; sample < endSample; ++sample)
+        {
+            const float outputGainDb = outputSmoothed.getNextValue();
+            const float mixPercent = mixSmoothed.getNextValue();
+            const float outputGain = juce::Decibels::decibelsToGain(outputGainDb);
+            const float chainGain = chainLevelStart + chainLevelStep * static_cast<float>(sample - startSample + 1);
+            const float mixAmount = mixPercent / 100.0f * chainGain;
+
+            // Apply output gain to wet signal
+            float wetSample = wetData[sample] * outputGain;
+
+            // Blend wet/dry (dry delayed by the chain's latency)
+            const float drySample = dryDelay.processSample(static_cast<size_t>(channel), dryData[sample]);
+            wetData[sample] = wetSample * mixAmount + drySample * (1.0f - mixAmount);
+        }
+
+        // Reset smoothed values for next channel
+        outputSmoothed.setCurrentAndTargetValue(params.output);
+        mixSmoothed.setCurrentAndTargetValue(params.mix);
+    }
+
+    markStage(subBlock, outputStage);
+}
+
+void FatPressorAudioProcessor::stepCompressorSmoothing()
+{
+    if (thresholdSmoothed.isSmoothing())
+    {
+        const float threshold = thresholdSmoothed.getNextValue();
+        gainComputer.setThreshold(threshold);
+        vcaGainComputer.setThreshold(threshold + vcaThresholdOffsetDb);
+    }
+    if (ratioSmoothed.isSmoothing())
+    {
+        const float ratio = ratioSmoothed.getNextValue();
+        gainComputer.setRatio(ratio);
+        vcaGainComputer.setRatio(ratio);
+    }
+    if (attackSmoothed.isSmoothing())
+        envelopeFollower.setAttackMs(attackSmoothed.getNextValue());
+    if (releaseSmoothed.isSmoothing())
+        envelopeFollower.setReleaseMs(releaseSmoothed.getNextValue());
+}
+
+void FatPressorAudioProcessor::skipCompressorSmoothing(int numSamples)
+{
+    // Compression switched off: the ramps still run out, in one go
+    if (thresholdSmoothed.isSmoothing())
+    {
+        const float threshold = thresholdSmoothed.skip(numSamples);
+        gainComputer.setThreshold(threshold);
+        vcaGainComputer.setThreshold(threshold + vcaThresholdOffsetDb);
+    }
+    if (ratioSmoothed.isSmoothing())
+    {
+        const float ratio = ratioSmoothed.skip(numSamples);
+        gainComputer.setRatio(ratio);
+        vcaGainComputer.setRatio(ratio);
+    }
+    if (attackSmoothed.isSmoothing())
+        envelopeFollower.setAttackMs(attackSmoothed.skip(numSamples));
+    if (releaseSmoothed.isSmoothing())
+        envelopeFollower.setReleaseMs(releaseSmoothed.skip(numSamples));
+}
+
+void FatPressorAudioProcessor::applyFat(float fat)
+{
+    tubeSaturation.setDrive(fat / 100.0f);
+    transformerColoration.setAmount(fat / 100.0f);
+}
+
+template <FatPressorAudioProcessor::CompressionMode mode>
+void FatPressorAudioProcessor::processCompression(SubBlock& subBlock)
+{
+    auto& buffer = subBlock.buffer;
+    auto& peakGainReduction = subBlock.peakGainReduction;
+
+    // Only a ramp in progress costs anything per sample
+    const bool smoothing = thresholdSmoothed.isSmoothing() || ratioSmoothed.isSmoothing()
+                        || attackSmoothed.isSmoothing() || releaseSmoothed.isSmoothing();
+
+    for (int sample = subBlock.startSample; sample < subBlock.endSample; ++sample)
+    {
+        if (smoothing)
+            stepCompressorSmoothing();
+
         // Get stereo samples
         float leftSample = buffer.getSample(0, sample);
         float rightSample = buffer.getNumChannels() > 1 ? buffer.getSample(1, sample) : leftSample;
 
-        // Sidechain detection (hybrid RMS-Peak)
-        float detectionDb = sidechainDetector.processSample(leftSample, rightSample);
+        // Sidechain detection (hybrid RMS-Peak), one pass shared by both stages;
+        // de-essing hears the same detector through its sibilance band-pass
+        const auto levels = mode == CompressionMode::deEss ? sidechainDetector.processSibilanceLevels(leftSample, rightSample)
+                                                           : sidechainDetector.processLevels(leftSample, rightSample);
+        float detectionDb = sidechainDetector.toHybridDecibels(levels);
 
         // Envelope following (attack/release with two-stage optical release)
         float envelopeDb = envelopeFollower.processSample(detectionDb);
 
+        // The expander gates on this track's own level: a loud group member
+        // does not hold a quiet one open
+        const float expansionDb = gainComputer.computeExpansion(envelopeDb);
+
+        // Linked: compress on the loudest member of the group
+        if (linkGroup.isLinked())
+        {
+            ownLinkLevel = juce::jmax(ownLinkLevel, envelopeDb);
+
+            const float position = static_cast<float>(sample + 1) / static_cast<float>(linkBlockLength);
+            envelopeDb = juce::jmax(envelopeDb, linkedLevelStart + position * (linkedLevelEnd - linkedLevelStart));
+        }
+
         // Gain computation (soft-knee compression)
         float grDb = gainComputer.computeGainReduction(envelopeDb);
 
-        // Track peak gain reduction for metering
+        // VCA in series: the detector's fast peak envelope, as it comes out of
+        // the expander and the opto, catches what the opto lets through
+        if constexpr (mode == CompressionMode::optoVca)
+            grDb = vcaGainComputer.computeSeriesGainReduction(grDb + expansionDb, juce::Decibels::gainToDecibels(levels.peak, -60.0f))
+                 - expansionDb;
+
+        // Track peak gain reduction and expansion for metering, apart
         if (grDb < peakGainReduction)
             peakGainReduction = grDb;
+        if (expansionDb < peakExpansion)
+            peakExpansion = expansionDb;
 
         // Convert gain reduction to linear
-        float grLinear = juce::Decibels::decibelsToGain(grDb);
+        float grLinear = juce::Decibels::decibelsToGain(grDb + expansionDb);
 
         // Apply gain reduction to all channels
-        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        if constexpr (mode == CompressionMode::deEss)
+        {
+            // High band only, through a complementary LR2 split: flat (an
+            // allpass) while there is no gain reduction
+            const int numChannels = juce::jmin(buffer.getNumChannels(), LinkwitzRileyCrossover::maxChannels);
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                float* channelData = buffer.getWritePointer(channel);
+                channelData[sample] = deEssSplit.processSample(static_cast<size_t>(channel), channelData[sample], grLinear);
+            }
+        }
+        else
         {
-            float* channelData = buffer.getWritePointer(channel);
-            channelData[sample] *= grLinear;
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            {
+                float* channelData = buffer.getWritePointer(channel);
+                channelData[sample] *= grLinear;
+            }
         }
     }
 
-    // Store gain reduction for metering (positive value for display)
-    gainReduction.store(-peakGainReduction);
+    if constexpr (mode == CompressionMode::deEss)
+    {
+        deEssSplit.snapToZero();
+        sidechainDetector.endSibilanceBlock();
+    }
+}
+
+void FatPressorAudioProcessor::markStage(SubBlock& subBlock, Stage stage)
+{
+    if (! stageTimingEnabled)
+        return;
 
-    // 3. POST-COMPRESSION: Transformer Coloration (adds "iron" character)
-    transformerColoration.processBlock(buffer);
+    const auto now = juce::Time::getHighResolutionTicks();
+    stageTicks[static_cast<size_t>(stage)] += now - subBlock.lastTick;
+    subBlock.lastTick = now;
+}
 
-    // 4. OUTPUT GAIN AND MIX
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+FatPressorAudioProcessor::MemoryFootprint FatPressorAudioProcessor::getMemoryFootprint() const
+{
+    MemoryFootprint footprint;
+    footprint.instanceBytes = sizeof(*this);
+    footprint.arenaBytes = arena.getCapacityBytes();
+    footprint.arenaUsedBytes = arena.getUsedBytes();
+    footprint.parameterBytes = parameterBindings.capacity() * sizeof(ParameterBinding)
+                             + capturedParameterValues.capacity() * sizeof(float);
+    footprint.sharedTableBytes = SharedTableCache::getTotalBytes();
+    return footprint;
+}
+
+juce::File FatPressorAudioProcessor::getSessionCaptureDirectory() const
+{
+    return presetManager.getDataDirectory().getChildFile("Captures");
+}
+
+void FatPressorAudioProcessor::startSessionCapture(double sampleRate)
+{
+    sessionRecorder.stop();
+    capturedParameterValues.assign(static_cast<size_t>(getParameters().size()), 0.0f);
+    capturedHandOffs.clear();
+    capturedHandOffs.reserve(static_cast<size_t>(preparedBlockSize / minSubBlockSize + 1));
+
+    if (! sessionCaptureEnabled)
+        return;
+
+    const auto directory = getSessionCaptureDirectory();
+    if (! directory.isDirectory())
+        return;
+
+    juce::StringArray parameterIds;
+    for (auto* parameter : getParameters())
     {
-        auto* wetData = buffer.getWritePointer(channel);
-        const auto* dryData = dryBuffer.getReadPointer(channel);
+        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+        parameterIds.add(ranged != nullptr ? ranged->getParameterID() : juce::String());
+    }
+
+    const auto file = directory.getChildFile("session-" + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S") + ".fpcap")
+                          .getNonexistentSibling();
+
+    sessionRecorder.start(file, sampleRate, juce::jmax(1, getTotalNumOutputChannels()), preparedBlockSize, parameterIds);
+}
+
+void FatPressorAudioProcessor::setDeterministicReplay(bool shouldBeDeterministic)
+{
+    tubeSaturation.getCurveTables().setDeterministic(shouldBeDeterministic || inlineTableBuilds);
+    setSessionCaptureEnabled(! shouldBeDeterministic);
+}
+
+void FatPressorAudioProcessor::setSessionCaptureEnabled(bool shouldBeEnabled)
+{
+    sessionCaptureEnabled = shouldBeEnabled;
+    if (! shouldBeEnabled)
+        sessionRecorder.stop();
+}
 
-        for (int sample = 0; sample < numSamples; ++sample)
+void FatPressorAudioProcessor::scheduleCurveTable(int sampleOffset, float drive)
+{
+    scheduledHandOffs.push_back({ sampleOffset, drive });
+}
+
+void FatPressorAudioProcessor::bakeRequestedCurveTable()
+{
+    tubeSaturation.getCurveTables().buildRequestedNow();
+}
+
+void FatPressorAudioProcessor::bindParameters()
+{
+    const std::pair<const char*, float ParameterSnapshot::*> fields[] = {
+        { "threshold", &ParameterSnapshot::threshold },
+        { "ratio", &ParameterSnapshot::ratio },
+        { "attack", &ParameterSnapshot::attack },
+        { "release", &ParameterSnapshot::release },
+        { "fat", &ParameterSnapshot::fat },
+        { "output", &ParameterSnapshot::output },
+        { "mix", &ParameterSnapshot::mix },
+        { "tubeMode", &ParameterSnapshot::tubeMode },
+        { "hysteresis", &ParameterSnapshot::hysteresis },
+        { "linkGroup", &ParameterSnapshot::linkGroup },
+        { "tubeEnabled", &ParameterSnapshot::tubeEnabled },
+        { "compressionEnabled", &ParameterSnapshot::compressionEnabled },
+        { "ironEnabled", &ParameterSnapshot::ironEnabled },
+        { "eqEnabled", &ParameterSnapshot::eqEnabled },
+        { "chainOrder", &ParameterSnapshot::chainOrder },
+        { "compMode", &ParameterSnapshot::compMode },
+        { "expThreshold", &ParameterSnapshot::expThreshold },
+        { "expRatio", &ParameterSnapshot::expRatio },
+        { "expHysteresis", &ParameterSnapshot::expHysteresis },
+        { "expHold", &ParameterSnapshot::expHold },
+    };
+
+    for (auto* parameter : getParameters())
+    {
+        ParameterBinding binding;
+
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
         {
-            const float outputGainDb = outputSmoothed.getNextValue();
-            const float mixPercent = mixSmoothed.getNextValue();
-            const float outputGain = juce::Decibels::decibelsToGain(outputGainDb);
-            const float mixAmount = mixPercent / 100.0f;
+            for (const auto& [id, field] : fields)
+            {
+                if (ranged->getParameterID() == id)
+                {
+                    binding.parameter = ranged;
+                    binding.source = parameters.getRawParameterValue(id);
+                    binding.field = field;
+                }
+            }
 
-            // Apply output gain to wet signal
-            float wetSample = wetData[sample] * outputGain;
+#if FATPRESSOR_CLAP
+            // clap-juce-extensions derives CLAP ids from the JUCE parameter ID hash
+            binding.clapId = static_cast<juce::uint32>(ranged->getParameterID().hashCode());
+#endif
+        }
+
+        parameterBindings.push_back(binding);
+    }
+
+    pendingWriteBacks = std::vector<std::atomic<float>>(parameterBindings.size());
+    for (auto& pending : pendingWriteBacks)
+        pending.store(std::numeric_limits<float>::quiet_NaN());
+}
+
+void FatPressorAudioProcessor::updateParameterSnapshot(bool force)
+{
+    for (auto& binding : parameterBindings)
+    {
+        if (binding.field == nullptr)
+            continue;
+
+        // Only take values the host/UI changed, so the last timestamped
+        // event of the previous block is not undone by a stale value
+        const float value = binding.source->load();
 
-            // Blend wet/dry
-            wetData[sample] = wetSample * mixAmount + dryData[sample] * (1.0f - mixAmount);
+        // Our own write-back reaching the adapter: the value is already
+        // applied, and a later event may have moved past it
+        if (! force && value == binding.writeBackEcho)
+        {
+            binding.lastSourceValue = value;
+            binding.writeBackEcho = std::numeric_limits<float>::quiet_NaN();
+            continue;
         }
 
-        // Reset smoothed values for next channel
-        outputSmoothed.setCurrentAndTargetValue(outputParam->load());
-        mixSmoothed.setCurrentAndTargetValue(mixParam->load());
+        if (force || value != binding.lastSourceValue)
+        {
+            binding.baseValue = value;
+            binding.lastSourceValue = value;
+
+            if (force)
+                binding.modulation = 0.0f;
+
+            parameterSnapshot.*binding.field = modulatedValue(binding);
+        }
     }
+}
 
-    // Measure output level
-    float outL = buffer.getMagnitude(0, 0, numSamples);
-    float outR = buffer.getNumChannels() > 1 ? buffer.getMagnitude(1, 0, numSamples) : outL;
-    outputLevelL.store(juce::Decibels::gainToDecibels(outL, -60.0f));
-    outputLevelR.store(juce::Decibels::gainToDecibels(outR, -60.0f));
+void FatPressorAudioProcessor::applyParameterEvent(const ParameterEvent& event)
+{
+    if (! juce::isPositiveAndBelow(event.parameterIndex, static_cast<int>(parameterBindings.size())))
+        return;
+
+    auto& binding = parameterBindings[static_cast<size_t>(event.parameterIndex)];
+    if (binding.field == nullptr)
+        return;
+
+    if (event.type == ParameterEvent::Type::modulation)
+    {
+        binding.modulation = event.value;
+    }
+    else
+    {
+        binding.baseValue = binding.parameter->getNormalisableRange().snapToLegalValue(event.value);
+        binding.needsWriteBack = true;
+    }
+
+    parameterSnapshot.*binding.field = modulatedValue(binding);
+}
+
+float FatPressorAudioProcessor::modulatedValue(const ParameterBinding& binding)
+{
+    if (binding.modulation == 0.0f)
+        return binding.baseValue;
+
+    const float normalised = binding.parameter->convertTo0to1(binding.baseValue) + binding.modulation;
+    return binding.parameter->convertFrom0to1(juce::jlimit(0.0f, 1.0f, normalised));
+}
+
+void FatPressorAudioProcessor::writeBackParameterEvents()
+{
+    // Event values bypassed the parameters: bring them up to where automation
+    // ended. Modulation is never written. setValue() keeps the parameter's own
+    // value current (the host reads it back at once); listeners must not run
+    // here, so the adapter, the saved state and the editor are notified on the
+    // message thread (notifyParameterWriteBacks()).
+    for (size_t index = 0; index < parameterBindings.size(); ++index)
+    {
+        auto& binding = parameterBindings[index];
+        if (! binding.needsWriteBack)
+            continue;
+
+        const float normalised = binding.parameter->convertTo0to1(binding.baseValue);
+        binding.parameter->setValue(normalised);
+        pendingWriteBacks[index].store(normalised, std::memory_order_release);
+
+        // What the adapter will hold once notified, so it is not taken for a new edit
+        binding.writeBackEcho = binding.parameter->convertFrom0to1(normalised);
+        binding.needsWriteBack = false;
+    }
+}
+
+void FatPressorAudioProcessor::notifyParameterWriteBacks()
+{
+    // The host is told a value it already holds (it sent it); the echo guard
+    // in updateParameterSnapshot() keeps the adapter's update from undoing a
+    // newer event
+    for (size_t index = 0; index < pendingWriteBacks.size(); ++index)
+    {
+        const float normalised = pendingWriteBacks[index].exchange(std::numeric_limits<float>::quiet_NaN(), std::memory_order_acq_rel);
+        if (! std::isnan(normalised))
+            parameterBindings[index].parameter->setValueNotifyingHost(normalised);
+    }
+}
+
+void FatPressorAudioProcessor::timerCallback()
+{
+    notifyParameterWriteBacks();
+}
+
+void FatPressorAudioProcessor::updateDspStages(bool force)
+{
+    const auto& params = parameterSnapshot;
+    auto& applied = stageParameters;
+
+    // Setters cost exp/pow (and FAT requests a table rebuild): only on change
+
+    // Compressor controls: new targets ramp per sample in the compression
+    // loop (stepCompressorSmoothing); force jumps straight to the value
+    if (force)
+    {
+        thresholdSmoothed.setCurrentAndTargetValue(params.threshold);
+        ratioSmoothed.setCurrentAndTargetValue(params.ratio);
+        attackSmoothed.setCurrentAndTargetValue(params.attack);
+        releaseSmoothed.setCurrentAndTargetValue(params.release);
+
+        envelopeFollower.setAttackMs(params.attack);
+        envelopeFollower.setReleaseMs(params.release);
+        gainComputer.setThreshold(params.threshold);
+        vcaGainComputer.setThreshold(params.threshold + vcaThresholdOffsetDb);
+        gainComputer.setRatio(params.ratio);
+        vcaGainComputer.setRatio(params.ratio);
+    }
+    else
+    {
+        if (params.threshold != applied.threshold)
+            thresholdSmoothed.setTargetValue(params.threshold);
+        if (params.ratio != applied.ratio)
+            ratioSmoothed.setTargetValue(params.ratio);
+        if (params.attack != applied.attack)
+            attackSmoothed.setTargetValue(params.attack);
+        if (params.release != applied.release)
+            releaseSmoothed.setTargetValue(params.release);
+    }
+
+    // Expander shares the gain computer (and so the envelope)
+    if (force || params.expThreshold != applied.expThreshold)
+        gainComputer.setExpanderThreshold(params.expThreshold);
+    if (force || params.expRatio != applied.expRatio)
+        gainComputer.setExpanderRatio(params.expRatio);
+    if (force || params.expHysteresis != applied.expHysteresis)
+        gainComputer.setExpanderHysteresis(params.expHysteresis);
+    if (force || params.expHold != applied.expHold)
+        gainComputer.setExpanderHoldMs(params.expHold);
+
+    // Update saturation amounts (FAT controls tube drive and transformer color);
+    // a new target glides in steps, see processSubBlock()
+    if (force)
+    {
+        fatSmoothed.setCurrentAndTargetValue(params.fat);
+        applyFat(params.fat);
+    }
+    else if (params.fat != applied.fat)
+    {
+        fatSmoothed.setTargetValue(params.fat);
+    }
+
+    tubeSaturation.setMode(static_cast<TubeSaturation::Mode>(static_cast<int>(params.tubeMode)));
+    transformerColoration.setHysteresisEnabled(params.hysteresis >= 0.5f);
+
+    // Switching the core in or out adds or removes the oversampler's latency:
+    // the dry path follows over the same fade and the host is told
+    const int latency = transformerColoration.getLatencySamples();
+    if (latency != getLatencySamples())
+    {
+        dryDelay.setActive(latency > 0, transformerColoration.getLatencyFadeSamples());
+        setLatencySamples(latency);
+    }
+
+    // Stage switches pick the kernel; a stage coming back starts from clean
+    // state rather than from wherever it was when it was switched off, and
+    // each switch glides in or out over its own fade
+    const int stages = (params.tubeEnabled >= 0.5f ? tubeSwitch : 0)
+                     | (params.compressionEnabled >= 0.5f ? compressionSwitch : 0)
+                     | (params.ironEnabled >= 0.5f ? ironSwitch : 0)
+                     | (params.eqEnabled >= 0.5f ? shelvesSwitch : 0);
+    const int switched = force ? 0 : stages ^ enabledStages;
+    const int switchedOn = switched & stages;
+
+    // A stage that is still fading out keeps its state, and its fade turns round
+    if ((switchedOn & ~fadingStages & tubeSwitch) != 0)
+        tubeSaturation.reset();
+    if ((switchedOn & ~fadingStages & compressionSwitch) != 0)
+    {
+        sidechainDetector.reset();
+        envelopeFollower.reset();
+        gainComputer.reset();
+    }
+    // The iron needs no reset: bypassed, it kept its delay line fed, and the
+    // core is reset and primed the first time it runs again
+    if ((switchedOn & ~fadingStages & shelvesSwitch) != 0)
+        transformerColoration.resetShelves();
+
+    if (force)
+    {
+        for (auto& fade : stageFades)
+            fade.stop();
+        fadingStages = 0;
+    }
+
+    for (int bit = 0; bit < numStageSwitches; ++bit)
+    {
+        if ((switched & (1 << bit)) != 0)
+        {
+            stageFades[static_cast<size_t>(bit)].startOrReverse();
+            fadingStages |= 1 << bit;
+        }
+    }
+
+    enabledStages = stages;
+    // A new order is swapped in by processSubBlock() once the chain has faded out
+    requestedChainOrder = juce::jlimit(0, numChainOrders - 1, juce::roundToInt(params.chainOrder));
+    if (force)
+    {
+        chainOrder = requestedChainOrder;
+        chainLevel.setCurrentAndTargetValue(1.0f);
+    }
+    const auto mode = static_cast<CompressionMode>(juce::jlimit(0, numCompressionModes - 1, juce::roundToInt(params.compMode)));
+    if (mode == CompressionMode::deEss && compressionMode != CompressionMode::deEss)
+    {
+        deEssSplit.reset();
+        sidechainDetector.resetSibilanceBand();
+    }
+    compressionMode = mode;
+
+    // Joining is lock-free, so group changes are fine mid-stream. Only a new
+    // group is joined: with the table full the instance stays unlinked
+    // until the parameter changes, rather than rescanning it every sub-block
+    const int group = juce::roundToInt(params.linkGroup);
+    if (group != linkGroup.getRequestedGroup())
+    {
+        linkGroup.join(group);
+        linkedLevelStart = linkedLevelEnd = LinkGroup::floorDb;
+    }
+
+    applied = params;
 }
 
 juce::AudioProcessorEditor* FatPressorAudioProcessor::createEditor()
 {
+#if FATPRESSOR_HEADLESS
+    return nullptr;
+#else
     return new FatPressorAudioProcessorEditor(*this);
+#endif
 }
 
 void FatPressorAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
+    // Automation written back since the last timer tick belongs in the state
+    notifyParameterWriteBacks();
+
     auto state = parameters.copyState();
     std::unique_ptr<juce::XmlElement> xml(state.createXml());
     copyXmlToBinary(*xml, destData);
@@ -305,7 +1270,11 @@ void FatPressorAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 void FatPressorAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
     std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
-    if (xml && xml->hasTagName(parameters.state.getType()))
+
+    // Hosts hand us arbitrary bytes: a non-finite or out-of-range value would
+    // end up in the DSP state, so such a state is rejected as a whole
+    if (xml && xml->hasTagName(parameters.state.getType())
+        && PresetManager::isValidParameterState(*xml, parameters))
         parameters.replaceState(juce::ValueTree::fromXml(*xml));
 }
 
@@ -323,6 +1292,7 @@ int FatPressorAudioProcessor::getCurrentProgram()
 
 void FatPressorAudioProcessor::setCurrentProgram(int index)
 {
+    hostProgram.store(index);
     presetManager.loadPresetByIndex(index);
 }
 
@@ -2,13 +2,35 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
+#include "dsp/Biquad.h"
+#include "dsp/DspArena.h"
+#include "dsp/LatencyDelay.h"
+#include "dsp/LinkwitzRileyCrossover.h"
+#include "dsp/LinearCrossfade.h"
 #include "dsp/SidechainDetector.h"
 #include "dsp/EnvelopeFollower.h"
 #include "dsp/GainComputer.h"
 #include "dsp/TubeSaturation.h"
 #include "dsp/TransformerColoration.h"
+#include "LinkGroup.h"
+#include "MeterHub.h"
+#include "ParameterEventQueue.h"
+#include "SessionRecorder.h"
 #include "PresetManager.h"
 
+#ifndef FATPRESSOR_CLAP
+ #define FATPRESSOR_CLAP 0
+#endif
+
+// GUI-less build for render nodes (no WebView editor)
+#ifndef FATPRESSOR_HEADLESS
+ #define FATPRESSOR_HEADLESS 0
+#endif
+
+#if FATPRESSOR_CLAP
+ #include <clap-juce-extensions/clap-juce-extensions.h>
+#endif
+
 /**
  * @brief FatPressor - Tube-Driven Optical Compressor
  *
@@ -20,11 +42,36 @@
  *
  * Signal Flow:
  * Input → TubeSaturation → Compression → TransformerColor → Output → Mix
+ * (tube, compression, iron and EQ can each be switched out, and the
+ * chain can run in a few other orders, e.g. compression before the tube)
  */
 class FatPressorAudioProcessor : public juce::AudioProcessor
+#if FATPRESSOR_CLAP
+                               , public clap_juce_extensions::clap_juce_audio_processor_capabilities
+#endif
+                               , private juce::Timer
 {
 public:
+    /**
+     * @brief What an instance does besides processing
+     * The plugin uses the defaults; libraries and tools embedding the
+     * processor use embedded(), which has no side effects outside the
+     * instance: no factory preset files written, no builder thread, no
+     * session capture, no meter overview slot. Without the builder thread
+     * waveshaper tables are baked at the start of the block after FAT moved.
+     */
+    struct Options
+    {
+        bool installFactoryPresets = true;  // write missing factory presets, scan the preset folders
+        bool backgroundTableBuilds = true;  // bake waveshaper tables on the shared builder thread
+        bool sessionCapture = true;         // record while the Captures folder exists
+        bool publishMeters = true;          // claim a slot in the console-wide meter overview
+
+        static Options embedded() { return { false, false, false, false }; }
+    };
+
     FatPressorAudioProcessor();
+    explicit FatPressorAudioProcessor(const Options& options);
     ~FatPressorAudioProcessor() override;
 
     // AudioProcessor interface
@@ -35,9 +82,15 @@ public:
 
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
+#if FATPRESSOR_CLAP
+    // CLAP: parameter values and modulation arrive as timestamped events
+    bool supportsDirectEvent(uint16_t spaceId, uint16_t type) override;
+    void handleDirectEvent(const clap_event_header_t* event, int sampleOffset) override;
+#endif
+
     // Editor
     juce::AudioProcessorEditor* createEditor() override;
-    bool hasEditor() const override { return true; }
+    bool hasEditor() const override { return ! FATPRESSOR_HEADLESS; }
 
     // Plugin info
     const juce::String getName() const override { return JucePlugin_Name; }
@@ -60,37 +113,287 @@ public:
     // Parameters
     juce::AudioProcessorValueTreeState parameters;
 
+    /**
+     * @brief Timestamped parameter changes for the next processBlock()
+     * Filled by format glue with sample-accurate automation; processBlock()
+     * splits the block at these offsets and clears the queue.
+     */
+    ParameterEventQueue& getParameterEventQueue() noexcept { return parameterEvents; }
+
+    /**
+     * @brief Opt-in session capture folder ("Captures" in the data directory)
+     * When the folder exists, every prepareToPlay() starts a new .fpcap
+     * capture there and releaseResources() closes it.
+     */
+    juce::File getSessionCaptureDirectory() const;
+
+    // Session replay hooks (headless host): table hand-offs only happen
+    // through scheduleCurveTable(), as recorded in the capture, or through
+    // bakeRequestedCurveTable() between blocks (scripted sessions).
+    // Deterministic replay also turns session capture off, so replaying a
+    // capture does not record a new one.
+    void setDeterministicReplay(bool shouldBeDeterministic);
+    void scheduleCurveTable(int sampleOffset, float drive);
+    void bakeRequestedCurveTable();
+
+    // Session capture follows the Captures folder unless turned off here
+    // (batch tools and libraries embedding the processor); call before prepareToPlay
+    void setSessionCaptureEnabled(bool shouldBeEnabled);
+
+    // Per-stage timing, accumulated in high-resolution ticks (off by default)
+    enum Stage
+    {
+        tubeStage = 0,
+        compressionStage,
+        transformerStage,
+        outputStage,
+        numStages
+    };
+
+    void setStageTimingEnabled(bool shouldBeEnabled) { stageTimingEnabled = shouldBeEnabled; }
+    const std::array<juce::int64, numStages>& getStageTicks() const { return stageTicks; }
+
+    /**
+     * @brief Stage switches, one bit per stage that can be taken out of the chain
+     * Every combination is its own specialisation of processStages(): a
+     * disabled stage is not in the kernel at all, instead of being tested
+     * per sample. A switch glides over stageFadeSeconds: while it does, the
+     * kernel with the stage still (or already) in it runs, and the stage's
+     * output is crossfaded with its input (see blendStageFade()).
+     */
+    enum StageSwitch
+    {
+        tubeSwitch = 1 << 0,
+        compressionSwitch = 1 << 1,
+        ironSwitch = 1 << 2,
+        shelvesSwitch = 1 << 3,
+        allStageSwitches = tubeSwitch | compressionSwitch | ironSwitch | shelvesSwitch
+    };
+
+    // The kernel the last sub-block ran: its chain order and StageSwitch bits
+    // (a stage still fading in or out is in it)
+    int getKernelChainOrder() const { return kernelChainOrder; }
+    int getKernelStages() const { return kernelStages; }
+
+    /**
+     * @brief Memory held by this instance
+     * Heap owned by JUCE internals (the oversampler, the APVTS tree) is not counted.
+     */
+    struct MemoryFootprint
+    {
+        size_t instanceBytes = 0;     // the processor object, DSP state included
+        size_t arenaBytes = 0;        // DSP buffer arena, as allocated
+        size_t arenaUsedBytes = 0;    // ... of which handed out to stages
+        size_t parameterBytes = 0;    // parameter bindings and capture scratch
+        size_t sharedTableBytes = 0;  // SharedTableCache, process-wide (not in the total)
+
+        size_t getTotalBytes() const { return instanceBytes + arenaBytes + parameterBytes; }
+    };
+
+    MemoryFootprint getMemoryFootprint() const;
+
     // Preset Manager
     PresetManager presetManager;
 
-    // Metering (atomic for thread-safe UI access)
-    std::atomic<float> inputLevelL { -60.0f };
+    // Metering (atomic for thread-safe UI access), on a cache line of their
+    // own: the DSP state below starts on the next line
+    alignas(DspArena::alignment) std::atomic<float> inputLevelL { -60.0f };
     std::atomic<float> inputLevelR { -60.0f };
     std::atomic<float> outputLevelL { -60.0f };
     std::atomic<float> outputLevelR { -60.0f };
-    std::atomic<float> gainReduction { 0.0f };
+    std::atomic<float> gainReduction { 0.0f };   // compression only (positive dB)
+    std::atomic<float> expansion { 0.0f };       // expander/gate, apart from it (positive dB)
 
 private:
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
     // DSP components
-    SidechainDetector sidechainDetector;
+    alignas(DspArena::alignment) SidechainDetector sidechainDetector;
     EnvelopeFollower envelopeFollower;
     GainComputer gainComputer;
+    GainComputer vcaGainComputer;       // Opto + VCA: peak stage in series with the opto
+    LinkwitzRileyCrossover deEssSplit;  // De-Ess: LR2 split, gain reduction on the high band
     TubeSaturation tubeSaturation;
     TransformerColoration transformerColoration;
     // CompressorCore compressor;        // Task 8
 
-    // Parameter pointers for real-time access
-    std::atomic<float>* thresholdParam = nullptr;
-    std::atomic<float>* ratioParam = nullptr;
-    std::atomic<float>* attackParam = nullptr;
-    std::atomic<float>* releaseParam = nullptr;
-    std::atomic<float>* fatParam = nullptr;
-    std::atomic<float>* outputParam = nullptr;
-    std::atomic<float>* mixParam = nullptr;
+    /**
+     * @brief Plain parameter values the DSP is running with
+     */
+    struct ParameterSnapshot
+    {
+        float threshold = -20.0f;
+        float ratio = 4.0f;
+        float attack = 10.0f;
+        float release = 100.0f;
+        float fat = 50.0f;
+        float output = 0.0f;
+        float mix = 100.0f;
+        float tubeMode = 0.0f;
+        float hysteresis = 0.0f;
+        float linkGroup = 0.0f;
+        float tubeEnabled = 1.0f;
+        float compressionEnabled = 1.0f;
+        float ironEnabled = 1.0f;
+        float eqEnabled = 1.0f;
+        float chainOrder = 0.0f;
+        float compMode = 0.0f;
+        float expThreshold = -50.0f;
+        float expRatio = 1.0f;
+        float expHysteresis = 3.0f;
+        float expHold = 20.0f;
+    };
+
+    /**
+     * @brief Parameter (in getParameters() order) feeding a snapshot field
+     */
+    struct ParameterBinding
+    {
+        juce::RangedAudioParameter* parameter = nullptr;
+        std::atomic<float>* source = nullptr;
+        float ParameterSnapshot::* field = nullptr;
+        float lastSourceValue = 0.0f;
+        float baseValue = 0.0f;         // plain value before modulation
+        float modulation = 0.0f;        // normalised offset, never written to the parameter
+        bool needsWriteBack = false;    // changed by an event, parameter not updated yet
+        float writeBackEcho = std::numeric_limits<float>::quiet_NaN();  // source value the write-back will produce
+#if FATPRESSOR_CLAP
+        juce::uint32 clapId = 0;
+#endif
+    };
+
+    void bindParameters();
+    void updateParameterSnapshot(bool force);
+    void applyParameterEvent(const ParameterEvent& event);
+    void writeBackParameterEvents();
+    void notifyParameterWriteBacks();
+    void timerCallback() override;
+    static float modulatedValue(const ParameterBinding& binding);
+    void updateDspStages(bool force);
+    void stepCompressorSmoothing();
+    void skipCompressorSmoothing(int numSamples);
+    void applyFat(float fat);
+    void processSubBlock(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                         float& peakGainReduction);
+
+    /**
+     * @brief Chain stages as types; a chain order is a std::tuple of them
+     * (ChainOrders in the .cpp, indexed by the chainOrder parameter). Each
+     * order is a separate kernel too, so reordering costs nothing per sample.
+     *
+     * Within a kernel the stages still run one after the other over the
+     * sub-block, each with its own loop, rather than fused into one
+     * per-sample loop: the tube and iron oversample and work on whole
+     * blocks, so there is no common per-sample step to fuse them on.
+     *
+     * Both orders cannot run side by side (they share one set of stage
+     * state), so a new order is not crossfaded against the old one directly:
+     * the wet chain fades to the aligned dry signal over half of
+     * stageFadeSeconds, the order swaps there, and it fades back in
+     * (chainLevel, applied with Mix).
+     */
+    struct SubBlock
+    {
+        juce::AudioBuffer<float>& buffer;
+        juce::dsp::AudioBlock<float> block;
+        int startSample;
+        int endSample;
+        float& peakGainReduction;
+        juce::int64 lastTick;   // stage timing
+    };
+
+    struct TubeChainStage;
+    struct CompressionChainStage;
+    struct TransformerChainStage;
+
+    using ChainOrders = std::tuple<
+        std::tuple<TubeChainStage, CompressionChainStage, TransformerChainStage>,   // classic
+        std::tuple<CompressionChainStage, TubeChainStage, TransformerChainStage>,   // tube after compression
+        std::tuple<TubeChainStage, TransformerChainStage, CompressionChainStage>>;  // compression last
 
-    // Smoothed parameters for zipper-free automation
+    static constexpr int numChainOrders = static_cast<int>(std::tuple_size<ChainOrders>::value);
+
+    template <int order, int stageMask>
+    void processStages(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                       float& peakGainReduction);
+
+    template <int stageMask, typename... ChainStages>
+    void processChain(SubBlock& subBlock, const std::tuple<ChainStages...>&);
+
+    /**
+     * @brief Compression character (compMode parameter)
+     * Opto + VCA adds a fast VCA in series after the opto: it reads the
+     * detector's peak component (same pass) less the opto's gain reduction,
+     * and both reductions go into the one gain multiply. De-Ess listens
+     * through the detector's sibilance band-pass and applies the gain
+     * reduction to the band above deEssSplitFrequency only, split off with
+     * a Linkwitz-Riley crossover (LR2).
+     */
+    enum class CompressionMode
+    {
+        opto = 0,
+        optoVca,
+        deEss
+    };
+
+    static constexpr int numCompressionModes = 3;
+    static constexpr float deEssSplitFrequency = 4000.0f;
+    static constexpr float vcaThresholdOffsetDb = 6.0f;   // VCA sits above the opto threshold
+    static constexpr float vcaKneeDb = 2.0f;
+
+    template <CompressionMode mode>
+    void processCompression(SubBlock& subBlock);
+    void markStage(SubBlock& subBlock, Stage stage);
+
+    static constexpr int numStageSwitches = 4;
+    static constexpr double stageFadeSeconds = 0.005;
+
+    bool isStageFading(int stageSwitch) const { return (fadingStages & stageSwitch) != 0; }
+    bool isChainOrderSwapping() const { return requestedChainOrder != chainOrder || chainLevel.isSmoothing(); }
+    void keepStageInput(const SubBlock& subBlock);
+    void blendStageFade(SubBlock& subBlock, int stageSwitch);
+
+    using StageKernel = void (FatPressorAudioProcessor::*)(juce::AudioBuffer<float>&, int, int, float&);
+
+    template <size_t... kernels>
+    static constexpr std::array<StageKernel, sizeof...(kernels)> makeStageKernels(std::index_sequence<kernels...>);
+
+    int enabledStages = allStageSwitches;   // StageSwitch bits, set in updateDspStages()
+    int fadingStages = 0;                   // ... of switches still gliding in or out
+    std::array<LinearCrossfade, numStageSwitches> stageFades;   // indexed by switch bit
+    int chainOrder = 0;                     // index into ChainOrders, swapped in processSubBlock()
+    int requestedChainOrder = 0;            // ... as the parameter has it, set in updateDspStages()
+    juce::SmoothedValue<float> chainLevel;  // wet chain level while the order swaps (1 otherwise)
+    int kernelChainOrder = 0;               // what the last sub-block ran, for getKernelChainOrder()
+    int kernelStages = allStageSwitches;    // ... and getKernelStages()
+    CompressionMode compressionMode = CompressionMode::opto;
+
+    // Sub-blocks are never split shorter than this. An event stamped inside
+    // the first minSubBlockSize samples after a split lands on the next
+    // boundary, so it takes effect up to minSubBlockSize - 1 samples late;
+    // that is below every smoothing time, so for the smoothed controls it
+    // only shifts the start of the ramp.
+    static constexpr int minSubBlockSize = 16;
+
+    // How often automation written back by the audio thread is announced to
+    // the parameter listeners (adapter, saved state, editor, host)
+    static constexpr int parameterWriteBackHz = 30;
+
+    // While FAT glides, sub-blocks are cut at this length and the tube and
+    // transformer stages get the glided value at every cut
+    static constexpr int fatSmoothingStep = minSubBlockSize;
+
+    // Parameter access for real-time use
+    std::vector<ParameterBinding> parameterBindings;  // indexed like getParameters()
+    ParameterSnapshot parameterSnapshot;               // current values (block start + events)
+    ParameterSnapshot stageParameters;                 // values last pushed into the DSP stages
+    ParameterEventQueue parameterEvents;
+    std::vector<std::atomic<float>> pendingWriteBacks;  // normalised, NaN when none; notified on the message thread
+
+    // Smoothed parameters for zipper-free automation: events and host
+    // changes set the targets, the values ramp inside the sub-blocks.
+    // Compressor controls step per sample in the compression loop; FAT steps
+    // every fatSmoothingStep samples (its stages glide in between).
     juce::SmoothedValue<float> thresholdSmoothed;
     juce::SmoothedValue<float> ratioSmoothed;
     juce::SmoothedValue<float> attackSmoothed;
@@ -99,6 +402,44 @@ private:
     juce::SmoothedValue<float> outputSmoothed;
     juce::SmoothedValue<float> mixSmoothed;
 
+    // Scratch buffers of all stages, one allocation made in prepareToPlay
+    DspArena arena;
+
+    // Dry copy for the mix (arena regions, referenced per block), delayed to
+    // line up with the wet chain's latency
+    std::array<float*, 2> dryChannels {};
+    std::array<float*, 2> stageInputChannels {};   // a fading stage's input (arena regions)
+    juce::AudioBuffer<float> dryBuffer;
+    LatencyDelay dryDelay;
+    int preparedBlockSize = 0;
+
+    // Session capture
+    void startSessionCapture(double sampleRate);
+
+    SessionRecorder sessionRecorder;
+    bool sessionCaptureEnabled = true;
+    bool inlineTableBuilds = false;   // Options::backgroundTableBuilds off
+    std::vector<float> capturedParameterValues;  // normalised, getParameters() order
+    std::vector<SessionRecorder::TableHandOff> capturedHandOffs;  // this block's, capacity set in startSessionCapture
+    std::vector<SessionRecorder::TableHandOff> scheduledHandOffs;  // replay, applied at sub-block starts
+    std::atomic<int> hostProgram { -1 };
+
+    // Cross-instance link group: other members' level, ramped across the block
+    LinkGroup linkGroup;
+    float linkedLevelStart = LinkGroup::floorDb;
+    float linkedLevelEnd = LinkGroup::floorDb;
+    float ownLinkLevel = LinkGroup::floorDb;   // loudest own envelope this block, published at the end
+    float peakExpansion = 0.0f;                // deepest expansion this block (dB, negative)
+    int linkBlockLength = 1;
+
+    // Console-wide overview: meter snapshot published every block
+    MeterHub::Publisher meterHub;
+    float cpuLoad = 0.0f;   // smoothed processing time / block duration
+
+    // Per-stage timing
+    bool stageTimingEnabled = false;
+    std::array<juce::int64, numStages> stageTicks {};
+
     // Sample rate for DSP
     double currentSampleRate = 44100.0;
 
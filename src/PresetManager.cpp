@@ -1,4 +1,30 @@
 #include "PresetManager.h"
+#include <cmath>
+
+namespace
+{
+// Parses a PARAM element's value; false when missing, malformed or non-finite
+bool readParameterValue(const juce::XmlElement& paramXml, float& value)
+{
+    const auto text = paramXml.getStringAttribute("value").trim();
+    if (text.isEmpty() || !text.containsOnly("0123456789+-.eE"))
+        return false;
+
+    const auto parsed = text.getDoubleValue();
+    if (!std::isfinite(parsed))
+        return false;
+
+    value = static_cast<float>(parsed);
+    return std::isfinite(value);
+}
+
+bool isInRange(const juce::RangedAudioParameter& param, float value)
+{
+    const auto& range = param.getNormalisableRange();
+    const auto tolerance = 1.0e-4f * (range.end - range.start);
+    return value >= range.start - tolerance && value <= range.end + tolerance;
+}
+}
 
 PresetManager::PresetManager(juce::AudioProcessorValueTreeState& apvts_)
     : apvts(apvts_)
@@ -50,6 +76,8 @@ void PresetManager::initialize()
         currentPreset.category = "Uncategorized";
         currentPreset.isFactory = false;
     }
+
+    currentPresetNameHash.store(static_cast<juce::uint32>(currentPreset.name.hashCode()));
 }
 
 void PresetManager::createDirectoryStructure()
@@ -77,10 +105,19 @@ void PresetManager::createDirectoryStructure()
 
 bool PresetManager::areFactoryPresetsInstalled() const
 {
-    // Check if at least one factory preset exists
+    return getInstalledFactoryPresetsVersion() >= factoryPresetsVersion;
+}
+
+int PresetManager::getInstalledFactoryPresetsVersion() const
+{
+    auto versionFile = factoryDirectory.getChildFile(factoryVersionFileName);
+    if (versionFile.existsAsFile())
+        return versionFile.loadFileAsString().trim().getIntValue();
+
+    // Installs from before the version file: version 1 if any factory preset exists
     auto drumsDir = factoryDirectory.getChildFile("Drums");
     return drumsDir.exists() &&
-           drumsDir.getNumberOfChildFiles(juce::File::findFiles, "*.fppreset") > 0;
+           drumsDir.getNumberOfChildFiles(juce::File::findFiles, "*.fppreset") > 0 ? 1 : 0;
 }
 
 void PresetManager::installFactoryPresets()
@@ -171,15 +208,19 @@ void PresetManager::installFactoryPresets()
         0.0f,     // output
         100.0f);  // mix
 
-    // 9. De-Harsh - Tame harsh vocals
+    // 9. De-Harsh - Tame harsh vocals (split-band de-essing, only the highs duck)
+    juce::NamedValueSet deEssing;
+    deEssing.set("compMode", 2.0f);  // De-Ess
+
     createFactoryPreset("De-Harsh", "Vocals",
-        -16.0f,   // threshold
-        3.0f,     // ratio
-        5.0f,     // attack
-        200.0f,   // release
-        70.0f,    // fat (round off harshness)
-        2.0f,     // output
-        85.0f);   // mix
+        -32.0f,   // threshold (sibilance band level)
+        4.0f,     // ratio
+        1.0f,     // attack
+        80.0f,    // release
+        40.0f,    // fat (round off harshness)
+        0.0f,     // output
+        100.0f,   // mix
+        deEssing);
 
     // 10. Background Vox - Sit vocals back in mix
     createFactoryPreset("Background Vox", "Vocals",
@@ -294,6 +335,8 @@ void PresetManager::installFactoryPresets()
         25.0f,    // fat
         1.0f,     // output
         100.0f);  // mix
+
+    factoryDirectory.getChildFile(factoryVersionFileName).replaceWithText(juce::String(factoryPresetsVersion));
 }
 
 void PresetManager::scanPresets()
@@ -561,6 +604,31 @@ bool PresetManager::savePresetToFile(const juce::File& file, const juce::String&
     return xml->writeTo(file);
 }
 
+bool PresetManager::isValidParameterState(const juce::XmlElement& parametersXml,
+                                          const juce::AudioProcessorValueTreeState& apvts)
+{
+    for (auto* paramXml : parametersXml.getChildIterator())
+    {
+        if (!paramXml->hasTagName("PARAM"))
+            continue;
+
+        // Unknown ids are ignored on load, so they can't do any harm
+        auto* param = apvts.getParameter(paramXml->getStringAttribute("id"));
+        if (param == nullptr)
+            continue;
+
+        float value = 0.0f;
+        if (!readParameterValue(*paramXml, value) || !isInRange(*param, value))
+        {
+            DBG("[PresetManager] ERROR: Bad value for " + param->paramID + ": "
+                + paramXml->getStringAttribute("value"));
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool PresetManager::loadPresetFromFile(const juce::File& file)
 {
     DBG("[PresetManager] loadPresetFromFile: " + file.getFullPathName());
@@ -572,18 +640,34 @@ bool PresetManager::loadPresetFromFile(const juce::File& file)
     }
 
     auto xml = juce::XmlDocument::parse(file);
-    if (!xml || !xml->hasTagName("FatPressorPreset"))
+    if (!xml)
+    {
+        DBG("[PresetManager] ERROR: Invalid XML");
+        return false;
+    }
+
+    return loadPresetFromXml(*xml);
+}
+
+bool PresetManager::loadPresetFromXml(const juce::XmlElement& presetXml)
+{
+    if (!presetXml.hasTagName("FatPressorPreset"))
     {
-        DBG("[PresetManager] ERROR: Invalid XML or wrong tag name");
+        DBG("[PresetManager] ERROR: Wrong tag name");
         return false;
     }
 
     // Find Parameters element
-    auto* paramsXml = xml->getChildByName("Parameters");
+    auto* paramsXml = presetXml.getChildByName("Parameters");
     if (paramsXml)
     {
+        // Validate everything first so a bad preset leaves the current state alone
+        if (!isValidParameterState(*paramsXml, apvts))
+            return false;
+
         DBG("[PresetManager] Found Parameters element, iterating...");
         int paramCount = 0;
+        juce::StringArray loadedIds;
 
         // Iterate through PARAM elements and set each parameter individually
         // This ensures WebSliderAttachments get notified properly
@@ -592,15 +676,19 @@ bool PresetManager::loadPresetFromFile(const juce::File& file)
             if (paramXml->hasTagName("PARAM"))
             {
                 juce::String paramId = paramXml->getStringAttribute("id");
-                float value = static_cast<float>(paramXml->getDoubleAttribute("value"));
+                float value = 0.0f;
+
+                if (sessionParameters.contains(paramId))
+                    continue;
 
-                if (auto* param = apvts.getParameter(paramId))
+                if (auto* param = apvts.getParameter(paramId); param != nullptr && readParameterValue(*paramXml, value))
                 {
                     // Convert from actual value to normalized 0-1 range
                     float normalized = param->convertTo0to1(value);
                     DBG("[PresetManager] Setting " + paramId + ": scaled=" + juce::String(value)
                         + " -> normalized=" + juce::String(normalized));
                     param->setValueNotifyingHost(normalized);
+                    loadedIds.add(paramId);
                     paramCount++;
                 }
                 else
@@ -611,6 +699,18 @@ bool PresetManager::loadPresetFromFile(const juce::File& file)
         }
 
         DBG("[PresetManager] Set " + juce::String(paramCount) + " parameters");
+
+        // Presets saved before a parameter existed don't mention it -
+        // reset those to defaults so settings don't leak between presets
+        for (auto* param : apvts.processor.getParameters())
+        {
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(param))
+            {
+                if (!loadedIds.contains(ranged->paramID) && !sessionParameters.contains(ranged->paramID))
+                    ranged->setValueNotifyingHost(ranged->getDefaultValue());
+            }
+        }
+
         return true;
     }
 
@@ -630,7 +730,8 @@ void PresetManager::removeListener(Listener* listener)
 
 void PresetManager::createFactoryPreset(const juce::String& name, const juce::String& category,
                                          float threshold, float ratio, float attack, float release,
-                                         float fat, float output, float mix)
+                                         float fat, float output, float mix,
+                                         const juce::NamedValueSet& extraParameters)
 {
     auto categoryDir = factoryDirectory.getChildFile(category);
     if (!categoryDir.exists())
@@ -638,9 +739,8 @@ void PresetManager::createFactoryPreset(const juce::String& name, const juce::St
 
     auto presetFile = categoryDir.getChildFile(name + presetExtension);
 
-    // Don't overwrite existing factory presets
-    if (presetFile.exists())
-        return;
+    // Factory presets belong to the plugin (user saves never land in the
+    // factory folder), so an outdated set is simply written again
 
     // Temporarily set parameters to preset values
     auto setParam = [this](const juce::String& id, float value) {
@@ -656,12 +756,22 @@ void PresetManager::createFactoryPreset(const juce::String& name, const juce::St
     setParam("output", output);
     setParam("mix", mix);
 
+    for (const auto& extra : extraParameters)
+        setParam(extra.name.toString(), static_cast<float>(extra.value));
+
     // Save using the standard method (ensures correct APVTS format)
     savePresetToFile(presetFile, name, category, true);
+
+    // Extras must not leak into the presets created after this one
+    for (const auto& extra : extraParameters)
+        if (auto* param = apvts.getParameter(extra.name.toString()))
+            param->setValueNotifyingHost(param->getDefaultValue());
 }
 
 void PresetManager::notifyPresetChanged()
 {
+    currentPresetNameHash.store(static_cast<juce::uint32>(currentPreset.name.hashCode()));
+
     listeners.call([this](Listener& l) {
         l.presetChanged(currentPreset);
     });
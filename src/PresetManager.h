@@ -30,6 +30,12 @@ public:
         "Drums", "Vocals", "Bass", "Mix Bus", "Uncategorized"
     };
 
+    // Routing parameters that belong to the session, not the sound:
+    // loading a preset leaves them as they are
+    static inline const juce::StringArray sessionParameters = {
+        "linkGroup"
+    };
+
     // Preset info structure
     struct PresetInfo
     {
@@ -57,6 +63,9 @@ public:
 
     // Current preset
     const PresetInfo& getCurrentPreset() const { return currentPreset; }
+
+    // Hash of the current preset's name, readable from any thread (meter hub)
+    juce::uint32 getCurrentPresetNameHash() const { return currentPresetNameHash.load(std::memory_order_relaxed); }
     int getCurrentPresetIndex() const;
     int getTotalPresetCount() const { return allPresets.size(); }
 
@@ -71,9 +80,28 @@ public:
     bool deleteUserPreset(const PresetInfo& preset);
     bool deleteUserPreset(int index);
 
-    // Factory preset installation
+    // Load a preset document already in memory (the file loader and fuzzing
+    // harnesses go through this). Rejected as a whole if any parameter value
+    // is non-finite or outside its range; nothing is changed then.
+    bool loadPresetFromXml(const juce::XmlElement& presetXml);
+
+    // True when every known PARAM under a "Parameters" element carries a
+    // finite value inside its parameter's range (shared with setStateInformation)
+    static bool isValidParameterState(const juce::XmlElement& parametersXml,
+                                      const juce::AudioProcessorValueTreeState& apvts);
+
+    // Per-user data folder (presets, session captures)
+    const juce::File& getDataDirectory() const { return presetsDirectory; }
+
+    // Factory preset installation; an install older than factoryPresetsVersion
+    // counts as not installed, and installing rewrites the whole factory set
     void installFactoryPresets();
     bool areFactoryPresetsInstalled() const;
+    int getInstalledFactoryPresetsVersion() const;
+
+    // Bump whenever a factory preset is added or changed
+    // (2: De-Harsh, the De-Ess mode preset)
+    static constexpr int factoryPresetsVersion = 2;
 
     // Listeners
     class Listener
@@ -97,12 +125,16 @@ private:
     juce::Array<PresetInfo> allPresets;
     PresetInfo currentPreset;
     int currentPresetIndex = 0;
+    std::atomic<juce::uint32> currentPresetNameHash { 0 };
 
     juce::ListenerList<Listener> listeners;
 
     // File extension
     static constexpr const char* presetExtension = ".fppreset";
 
+    // Installed factory set version, in the factory folder
+    static constexpr const char* factoryVersionFileName = ".factory-version";
+
     // Internal methods
     void createDirectoryStructure();
     void scanPresets();
@@ -112,10 +144,12 @@ private:
                           const juce::String& category, bool isFactory);
     bool loadPresetFromFile(const juce::File& file);
 
-    // Factory preset creation helper
+    // Factory preset creation helper; extraParameters (id -> plain value) are
+    // set for this preset only and put back to their defaults afterwards
     void createFactoryPreset(const juce::String& name, const juce::String& category,
                              float threshold, float ratio, float attack, float release,
-                             float fat, float output, float mix);
+                             float fat, float output, float mix,
+                             const juce::NamedValueSet& extraParameters = {});
 
     void notifyPresetChanged();
     void notifyPresetListChanged();
@@ -0,0 +1,185 @@
+#include "SessionRecorder.h"
+#include <cstring>
+
+namespace
+{
+/**
+ * @brief Copies a record into the (possibly wrapped) region reserved in the ring
+ */
+struct RingWriter
+{
+    char* ring;
+    const juce::AbstractFifo::ScopedWrite& region;
+    int offset = 0;
+
+    void put(const void* data, int numBytes)
+    {
+        auto* bytes = static_cast<const char*>(data);
+
+        const int first = juce::jlimit(0, numBytes, region.blockSize1 - offset);
+        if (first > 0)
+            std::memcpy(ring + region.startIndex1 + offset, bytes, static_cast<size_t>(first));
+
+        if (numBytes > first)
+            std::memcpy(ring + region.startIndex2 + (offset + first - region.blockSize1), bytes + first,
+                        static_cast<size_t>(numBytes - first));
+
+        offset += numBytes;
+    }
+
+    template <typename Value>
+    void put(Value value)
+    {
+        put(&value, static_cast<int>(sizeof(Value)));
+    }
+};
+}
+
+SessionRecorder::SessionRecorder()
+    : juce::Thread("FatPressor session capture")
+{
+}
+
+SessionRecorder::~SessionRecorder()
+{
+    stop();
+}
+
+bool SessionRecorder::start(const juce::File& file, double sampleRate, int newNumChannels, int maxBlockSize,
+                            const juce::StringArray& parameterIds)
+{
+    stop();
+
+    file.getParentDirectory().createDirectory();
+    file.deleteFile();
+
+    auto newStream = file.createOutputStream();
+    if (newStream == nullptr)
+        return false;
+
+    newStream->write(SessionCaptureFormat::magic, sizeof(SessionCaptureFormat::magic));
+    newStream->writeInt(static_cast<int>(SessionCaptureFormat::version));
+    newStream->writeDouble(sampleRate);
+    newStream->writeInt(newNumChannels);
+    newStream->writeInt(maxBlockSize);
+    newStream->writeInt(parameterIds.size());
+
+    for (const auto& id : parameterIds)
+    {
+        const auto utf8 = id.toUTF8();
+        const auto length = static_cast<short>(utf8.sizeInBytes() - 1);
+        newStream->writeShort(length);
+        newStream->write(utf8.getAddress(), static_cast<size_t>(length));
+    }
+
+    if (ring.size() != static_cast<size_t>(ringBytes))
+        ring.resize(static_cast<size_t>(ringBytes));
+
+    fifo.reset();
+    stream = std::move(newStream);
+    numChannels = newNumChannels;
+    droppedBlocks.store(0);
+    pendingGap = 0;
+
+    recording.store(true, std::memory_order_release);
+    startThread();
+    return true;
+}
+
+void SessionRecorder::stop()
+{
+    if (! recording.exchange(false))
+        return;
+
+    stopThread(2000);
+    drain();
+    stream->flush();
+    stream.reset();
+}
+
+void SessionRecorder::recordBlock(const juce::AudioBuffer<float>& input, int numSamples,
+                                  const std::vector<float>& normalisedValues, const ParameterEventQueue& events,
+                                  int program, const std::vector<TableHandOff>& handOffs)
+{
+    if (! isRecording())
+        return;
+
+    const int channels = juce::jmin(numChannels, input.getNumChannels());
+    const int gapBytes = pendingGap > 0 ? 1 + 4 : 0;
+    const int blockBytes = 1 + 4 + 4
+                         + 4 + static_cast<int>(handOffs.size()) * (4 + 4)
+                         + 4 * static_cast<int>(normalisedValues.size())
+                         + 4 + events.size() * (4 + 4 + 4 + 1)
+                         + 4 * numChannels * numSamples;
+
+    if (fifo.getFreeSpace() < gapBytes + blockBytes)
+    {
+        ++pendingGap;
+        droppedBlocks.fetch_add(1);
+        return;
+    }
+
+    const auto region = fifo.write(gapBytes + blockBytes);
+    RingWriter writer { ring.data(), region };
+
+    if (pendingGap > 0)
+    {
+        writer.put(SessionCaptureFormat::gapTag);
+        writer.put(static_cast<juce::uint32>(pendingGap));
+        pendingGap = 0;
+    }
+
+    writer.put(SessionCaptureFormat::blockTag);
+    writer.put(static_cast<juce::uint32>(numSamples));
+    writer.put(static_cast<juce::int32>(program));
+    writer.put(static_cast<juce::uint32>(handOffs.size()));
+    for (const auto& handOff : handOffs)
+    {
+        writer.put(static_cast<juce::uint32>(handOff.sampleOffset));
+        writer.put(handOff.drive);
+    }
+
+    writer.put(normalisedValues.data(), 4 * static_cast<int>(normalisedValues.size()));
+
+    writer.put(static_cast<juce::uint32>(events.size()));
+    for (const auto& event : events)
+    {
+        writer.put(static_cast<juce::int32>(event.sampleOffset));
+        writer.put(static_cast<juce::int32>(event.parameterIndex));
+        writer.put(event.value);
+        writer.put(static_cast<juce::uint8>(event.type));
+    }
+
+    // Missing channels (mono input into a stereo capture) are written as silence
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        if (channel < channels)
+        {
+            writer.put(input.getReadPointer(channel), 4 * numSamples);
+        }
+        else
+        {
+            for (int sample = 0; sample < numSamples; ++sample)
+                writer.put(0.0f);
+        }
+    }
+}
+
+void SessionRecorder::run()
+{
+    while (! threadShouldExit())
+    {
+        drain();
+        wait(10);
+    }
+}
+
+void SessionRecorder::drain()
+{
+    const auto region = fifo.read(fifo.getNumReady());
+
+    if (region.blockSize1 > 0)
+        stream->write(ring.data() + region.startIndex1, static_cast<size_t>(region.blockSize1));
+    if (region.blockSize2 > 0)
+        stream->write(ring.data() + region.startIndex2, static_cast<size_t>(region.blockSize2));
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include "ParameterEventQueue.h"
+#include <atomic>
+#include <vector>
+
+/**
+ * @brief Session capture file layout (.fpcap, little endian)
+ *
+ * Header:
+ *   "FPCP", version u32, sampleRate f64, numChannels u32, maxBlockSize u32,
+ *   numParameters u32, then per parameter: id length u16 + UTF-8 id
+ *
+ * Records, each starting with a one-byte tag:
+ *   'B' block:  numSamples u32, program i32,
+ *               numHandOffs u32, table hand-offs × (sampleOffset u32, drive f32),
+ *               normalised parameter values f32 × numParameters,
+ *               numEvents u32, events × (offset i32, index i32, value f32, type u8),
+ *               input samples f32 × numChannels × numSamples (channel-major)
+ *   'G' gap:    droppedBlocks u32 (the writer fell behind; replay is no longer exact)
+ *
+ * Version 1 recorded one hand-off count and drive per block instead of the
+ * hand-off list; the replay still reads it (hand-offs at the block start).
+ */
+namespace SessionCaptureFormat
+{
+constexpr char magic[4] = { 'F', 'P', 'C', 'P' };
+constexpr juce::uint32 version = 2;
+constexpr char blockTag = 'B';
+constexpr char gapTag = 'G';
+}
+
+/**
+ * @brief Opt-in session capture for reproducing CPU spikes and glitches
+ *
+ * Records everything needed to replay a session bit-exactly in the headless
+ * host: input audio, block sizes, sample rate, parameter values and events
+ * per block, host program changes and waveshaper table hand-offs.
+ *
+ * The audio thread serialises each block into a preallocated ring
+ * (juce::AbstractFifo, no locks, no allocation); a background thread drains
+ * it to disk. If the disk cannot keep up, whole blocks are dropped and a gap
+ * record marks where.
+ */
+class SessionRecorder : private juce::Thread
+{
+public:
+    SessionRecorder();
+    ~SessionRecorder() override;
+
+    /**
+     * @brief Open a capture file and start the writer (not real-time safe)
+     */
+    bool start(const juce::File& file, double sampleRate, int numChannels, int maxBlockSize,
+               const juce::StringArray& parameterIds);
+
+    /**
+     * @brief Flush and close the capture (not real-time safe)
+     */
+    void stop();
+
+    /**
+     * @brief A waveshaper table picked up at the start of the sub-block at sampleOffset
+     */
+    struct TableHandOff
+    {
+        int sampleOffset = 0;
+        float drive = 0.0f;
+    };
+
+    bool isRecording() const { return recording.load(std::memory_order_acquire); }
+    int getDroppedBlocks() const { return droppedBlocks.load(); }
+
+    /**
+     * @brief Record one block (audio thread)
+     * @param input The block's input, before processing
+     * @param normalisedValues Parameter values at block start (getParameters() order)
+     * @param handOffs Table hand-offs in this block, in sample order
+     */
+    void recordBlock(const juce::AudioBuffer<float>& input, int numSamples,
+                     const std::vector<float>& normalisedValues, const ParameterEventQueue& events,
+                     int program, const std::vector<TableHandOff>& handOffs);
+
+private:
+    void run() override;
+    void drain();
+
+    static constexpr int ringBytes = 8 * 1024 * 1024;  // several seconds of stereo audio at 192 kHz
+
+    juce::AbstractFifo fifo { ringBytes };
+    std::vector<char> ring;
+    std::unique_ptr<juce::FileOutputStream> stream;
+
+    std::atomic<bool> recording { false };
+    std::atomic<int> droppedBlocks { 0 };
+    int pendingGap = 0;  // audio thread: blocks dropped since the last gap record
+    int numChannels = 0;
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <complex>
+
+/**
+ * @brief Fixed second-order IIR filter for up to two channels, stored inline
+ *
+ * Same transposed direct form II as juce::dsp::IIR::Filter, but the
+ * coefficients and per-channel state live in the object itself instead of a
+ * reference-counted heap Coefficients plus one Filter per channel
+ * (ProcessorDuplicator), so a stage's filters sit next to the rest of its
+ * state.
+ *
+ * Coefficients come from juce::dsp::IIR::ArrayCoefficients, which computes
+ * them without allocating.
+ */
+class Biquad
+{
+public:
+    static constexpr int maxChannels = 2;
+
+    /**
+     * @brief Set from { b0, b1, b2, a0, a1, a2 } (normalised by a0 here)
+     */
+    void setCoefficients(const std::array<float, 6>& coefficients) noexcept
+    {
+        const float a0 = coefficients[3];
+        b0 = coefficients[0] / a0;
+        b1 = coefficients[1] / a0;
+        b2 = coefficients[2] / a0;
+        a1 = coefficients[4] / a0;
+        a2 = coefficients[5] / a0;
+    }
+
+    void reset() noexcept
+    {
+        state1.fill(0.0f);
+        state2.fill(0.0f);
+    }
+
+    void process(const juce::dsp::AudioBlock<float>& block) noexcept
+    {
+        const auto numChannels = juce::jmin(block.getNumChannels(), static_cast<size_t>(maxChannels));
+        const auto numSamples = block.getNumSamples();
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            auto* data = block.getChannelPointer(channel);
+            float s1 = state1[channel];
+            float s2 = state2[channel];
+
+            for (size_t sample = 0; sample < numSamples; ++sample)
+            {
+                const float input = data[sample];
+                const float output = input * b0 + s1;
+                data[sample] = output;
+                s1 = (input * b1) - (output * a1) + s2;
+                s2 = (input * b2) - (output * a2);
+            }
+
+            juce::dsp::util::snapToZero(s1);
+            juce::dsp::util::snapToZero(s2);
+            state1[channel] = s1;
+            state2[channel] = s2;
+        }
+    }
+
+    /**
+     * @brief One sample of one channel, for per-sample loops
+     */
+    float processSample(size_t channel, float input) noexcept
+    {
+        const float output = input * b0 + state1[channel];
+        state1[channel] = (input * b1) - (output * a1) + state2[channel];
+        state2[channel] = (input * b2) - (output * a2);
+        return output;
+    }
+
+    /**
+     * @brief Flush denormal state left by processSample() (once per block)
+     */
+    void snapToZero() noexcept
+    {
+        for (size_t channel = 0; channel < static_cast<size_t>(maxChannels); ++channel)
+        {
+            juce::dsp::util::snapToZero(state1[channel]);
+            juce::dsp::util::snapToZero(state2[channel]);
+        }
+    }
+
+    /**
+     * @brief Complex frequency response H(e^jw), for calibrating around the filter
+     */
+    std::complex<double> getResponse(double frequency, double sampleRate) const noexcept
+    {
+        const auto z1 = std::polar(1.0, -juce::MathConstants<double>::twoPi * frequency / sampleRate);
+        const auto z2 = z1 * z1;
+        return (static_cast<double>(b0) + static_cast<double>(b1) * z1 + static_cast<double>(b2) * z2)
+             / (1.0 + static_cast<double>(a1) * z1 + static_cast<double>(a2) * z2);
+    }
+
+private:
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    std::array<float, maxChannels> state1 {};
+    std::array<float, maxChannels> state2 {};
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <cmath>
+
+/**
+ * @brief Chebyshev Harmonic Synthesis Waveshaper
+ *
+ * Adds exact harmonic levels to the signal instead of relying on the shape
+ * of a saturation curve. For a full-scale sine (amplitude 1.0) the Chebyshev
+ * polynomial T_k turns cos(wt) into cos(k*wt), so each harmonic amplitude is
+ * exactly its weight h_k:
+ *
+ *   y = x + h2*T2(x) + h3*T3(x) + h4*T4(x) + h6*T6(x)
+ *
+ * FAT calibration (per spec, relative to a 0 dBFS fundamental at the output
+ * of the stage this shaper sits in, see setDrive()):
+ * - 50%:  2nd harmonic at -40 dB
+ * - 100%: 2nd harmonic at -18 dB
+ * - 3rd/4th/6th follow the 2nd at fixed offsets (even-order dominant)
+ *
+ * The weighted sum is collapsed into a single degree-6 polynomial that is
+ * evaluated with Horner's rule, four samples at a time with SIMDRegister.
+ * The harmonic part is fed a clamped input (|x| <= 1) so loud peaks keep
+ * their fundamental untouched while the added harmonics stay bounded.
+ */
+class ChebyshevHarmonics
+{
+public:
+    ChebyshevHarmonics() = default;
+
+    /**
+     * @brief Set harmonic amount (0.0 to 1.0)
+     * Maps from FAT parameter percentage
+     * @param fundamentalGain Gain of the surrounding stage on the fundamental,
+     *        so the levels hold relative to the stage output rather than here
+     * @param inputGain Gain from the stage input to this shaper's input; the
+     *        k-th harmonic scales with inputGain^k, so the weights compensate
+     */
+    void setDrive(float driveAmount, float fundamentalGain = 1.0f, float inputGain = 1.0f)
+    {
+        drive = juce::jlimit(0.0f, 1.0f, driveAmount);
+
+        // 2nd harmonic level in dB: -40 dB at 50%, -18 dB at 100% (44 dB per unit FAT)
+        // Fades to silence over the first 5% so FAT 0 stays perfectly clean
+        const float secondDb = -18.0f + (drive - 1.0f) * 44.0f;
+        const float fadeIn = juce::jmin(1.0f, drive / 0.05f);
+        const float h2 = juce::Decibels::decibelsToGain(secondDb) * fadeIn;
+
+        harmonicLevels = { h2, h2 * thirdRelative, h2 * fourthRelative, h2 * sixthRelative };
+
+        // Weights that land those levels at the stage output
+        const float input = juce::jlimit(0.1f, 1.0f, inputGain);
+        const float w2 = harmonicLevels[0] * fundamentalGain / std::pow(input, 2.0f);
+        const float w3 = harmonicLevels[1] * fundamentalGain / std::pow(input, 3.0f);
+        const float w4 = harmonicLevels[2] * fundamentalGain / std::pow(input, 4.0f);
+        const float w6 = harmonicLevels[3] * fundamentalGain / std::pow(input, 6.0f);
+
+        // Power-series coefficients of sum(w_k * (T_k(x) - T_k(0)))
+        // T2 = 2x^2 - 1, T3 = 4x^3 - 3x, T4 = 8x^4 - 8x^2 + 1, T6 = 32x^6 - 48x^4 + 18x^2 - 1
+        // Removing T_k(0) keeps silence silent (no DC step when FAT moves)
+        coefficients[0] = -3.0f * w3;                           // x
+        coefficients[1] = 2.0f * w2 - 8.0f * w4 + 18.0f * w6;  // x^2
+        coefficients[2] = 4.0f * w3;                            // x^3
+        coefficients[3] = 8.0f * w4 - 48.0f * w6;               // x^4
+        coefficients[4] = 0.0f;                                 // x^5
+        coefficients[5] = 32.0f * w6;                           // x^6
+    }
+
+    /**
+     * @brief Process a single sample
+     */
+    inline float processSample(float input) const
+    {
+        const float x = juce::jlimit(-1.0f, 1.0f, input);
+
+        float poly = coefficients[5];
+        for (int i = 4; i >= 0; --i)
+            poly = poly * x + coefficients[static_cast<size_t>(i)];
+
+        return input + poly * x;
+    }
+
+    /**
+     * @brief Process a channel in place, SIMD across samples
+     */
+    void processBlock(float* data, int numSamples) const
+    {
+        using Vec = juce::dsp::SIMDRegister<float>;
+        constexpr int width = static_cast<int>(Vec::SIMDNumElements);
+
+        int sample = 0;
+
+        // Scalar head until the pointer is SIMD-aligned
+        while (sample < numSamples && !Vec::isSIMDAligned(data + sample))
+        {
+            data[sample] = processSample(data[sample]);
+            ++sample;
+        }
+
+        const Vec lower = Vec::expand(-1.0f);
+        const Vec upper = Vec::expand(1.0f);
+
+        for (; sample + width <= numSamples; sample += width)
+        {
+            const Vec input = Vec::fromRawArray(data + sample);
+            const Vec x = Vec::min(upper, Vec::max(lower, input));
+
+            Vec poly = Vec::expand(coefficients[5]);
+            for (int i = 4; i >= 0; --i)
+                poly = poly * x + Vec::expand(coefficients[static_cast<size_t>(i)]);
+
+            (input + poly * x).copyToRawArray(data + sample);
+        }
+
+        // Scalar tail
+        for (; sample < numSamples; ++sample)
+            data[sample] = processSample(data[sample]);
+    }
+
+    /**
+     * @brief Target harmonic amplitudes (2nd, 3rd, 4th, 6th) relative to the fundamental
+     */
+    const std::array<float, 4>& getHarmonicLevels() const { return harmonicLevels; }
+
+private:
+    float drive = 0.0f;
+
+    // Horner coefficients for x^1..x^6 (harmonic part only)
+    std::array<float, 6> coefficients {};
+    std::array<float, 4> harmonicLevels {};
+
+    // Upper harmonics relative to the 2nd (even-order dominant tube voicing)
+    static constexpr float thirdRelative = 0.2f;     // -14 dB
+    static constexpr float fourthRelative = 0.35f;   // -9 dB
+    static constexpr float sixthRelative = 0.1f;     // -20 dB
+};
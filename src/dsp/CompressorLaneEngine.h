@@ -0,0 +1,397 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/**
+ * @brief Many independent compressor channels advanced together (lane engine)
+ *
+ * The same detector → envelope → gain computer chain as SidechainDetector,
+ * EnvelopeFollower and GainComputer, for N tracks at once. Each track is a
+ * lane with its own state and parameters, stored structure-of-arrays so the
+ * per-sample kernel is one loop over contiguous lanes: no branches (the
+ * attack/release and knee decisions are selects) and no libm calls (dB
+ * conversions and the RMS square root use the bit-level approximations
+ * below), which the compiler turns into 4/8/16-wide SIMD depending on the
+ * target.
+ *
+ * The detector's dB round trip is folded away: the envelope sees the hybrid
+ * level directly, floored at -90 dB as before. Gain tracks the scalar
+ * classes to within a few hundredths of a dB; the attack/release-stage
+ * decisions can flip a sample earlier or later.
+ *
+ * Usage: prepare(), set per-lane parameters, then process() with one
+ * left/right pointer pair per lane (right may equal left for mono tracks);
+ * the computed gain is applied in place.
+ */
+class CompressorLaneEngine
+{
+public:
+    CompressorLaneEngine() = default;
+
+    /**
+     * @brief Allocate state for numLanes tracks (not real-time safe)
+     */
+    void prepare(double newSampleRate, int maxBlockSize, int newNumLanes)
+    {
+        sampleRate = newSampleRate;
+        numLanes = juce::jmax(1, newNumLanes);
+        stride = (numLanes + laneAlignment - 1) / laneAlignment * laneAlignment;
+        maxSamples = juce::jmax(1, maxBlockSize);
+
+        rmsWindowSize = juce::jmax(1, static_cast<int>(sampleRate * 0.01));
+        rmsScale = 1.0f / static_cast<float>(rmsWindowSize);
+        peakAttackCoeff = static_cast<float>(std::exp(-1.0 / (sampleRate * 0.0001)));
+        peakReleaseCoeff = static_cast<float>(std::exp(-1.0 / (sampleRate * 0.05)));
+
+        const auto lanes = static_cast<size_t>(stride);
+        for (auto* array : { &rmsSum, &peakEnvelope, &envelope, &peakLevel, &slowRelease, &peakGainReduction })
+            array->assign(lanes, 0.0f);
+
+        rmsRing.assign(lanes * static_cast<size_t>(rmsWindowSize), 0.0f);
+        frames.assign(lanes * static_cast<size_t>(maxSamples), 0.0f);
+
+        attackMs.assign(lanes, 10.0f);
+        releaseMs.assign(lanes, 100.0f);
+        attackCoeff.resize(lanes);
+        releaseCoeffFast.resize(lanes);
+        releaseCoeffSlow.resize(lanes);
+        for (int lane = 0; lane < stride; ++lane)
+            updateTimeCoefficients(lane);
+
+        threshold.assign(lanes, -20.0f);
+        slope.assign(lanes, 1.0f - 1.0f / 4.0f);
+        kneeWidth.assign(lanes, 6.0f);
+        halfSlopeOverKnee.resize(lanes);
+        for (int lane = 0; lane < stride; ++lane)
+            updateKnee(lane);
+
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto* array : { &rmsSum, &peakEnvelope, &envelope, &peakLevel, &slowRelease, &rmsRing })
+            std::fill(array->begin(), array->end(), 0.0f);
+
+        rmsWriteIndex = 0;
+        resetPeakGainReduction();
+    }
+
+    int getNumLanes() const { return numLanes; }
+
+    // Per-lane parameters (message or audio thread, between process() calls)
+    void setThreshold(int lane, float thresholdDb)
+    {
+        threshold[static_cast<size_t>(lane)] = thresholdDb;
+    }
+
+    void setRatio(int lane, float ratio)
+    {
+        slope[static_cast<size_t>(lane)] = 1.0f - 1.0f / juce::jmax(1.0f, ratio);
+        updateKnee(lane);
+    }
+
+    void setKneeWidth(int lane, float kneeDb)
+    {
+        kneeWidth[static_cast<size_t>(lane)] = juce::jmax(0.0f, kneeDb);
+        updateKnee(lane);
+    }
+
+    void setAttackMs(int lane, float newAttackMs)
+    {
+        attackMs[static_cast<size_t>(lane)] = juce::jlimit(0.1f, 100.0f, newAttackMs);
+        updateTimeCoefficients(lane);
+    }
+
+    void setReleaseMs(int lane, float newReleaseMs)
+    {
+        releaseMs[static_cast<size_t>(lane)] = juce::jlimit(10.0f, 1000.0f, newReleaseMs);
+        updateTimeCoefficients(lane);
+    }
+
+    /**
+     * @brief Compress every lane in place
+     * @param left One pointer per lane
+     * @param right One pointer per lane; may equal left (mono track)
+     */
+    void process(float* const* left, float* const* right, int numSamples)
+    {
+        for (int start = 0; start < numSamples; start += maxSamples)
+        {
+            const int length = juce::jmin(maxSamples, numSamples - start);
+
+            // Transpose the mono detector input to [sample][lane]
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                const float* l = left[lane] + start;
+                const float* r = right[lane] + start;
+                float* column = frames.data() + lane;
+
+                for (int sample = 0; sample < length; ++sample)
+                    column[static_cast<size_t>(sample * stride)] = (l[sample] + r[sample]) * 0.5f;
+            }
+
+            // Padding lanes would otherwise be fed last block's gains
+            for (int sample = 0; sample < length; ++sample)
+                std::fill_n(frames.data() + static_cast<size_t>(sample * stride + numLanes), stride - numLanes, 0.0f);
+
+            for (int sample = 0; sample < length; ++sample)
+                computeGains(frames.data() + static_cast<size_t>(sample * stride));
+
+            // Apply the gains (frames now hold linear gain per sample and lane)
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                float* l = left[lane] + start;
+                float* r = right[lane] + start;
+                const float* column = frames.data() + lane;
+
+                for (int sample = 0; sample < length; ++sample)
+                    l[sample] *= column[static_cast<size_t>(sample * stride)];
+
+                if (r != l)
+                    for (int sample = 0; sample < length; ++sample)
+                        r[sample] *= column[static_cast<size_t>(sample * stride)];
+            }
+        }
+    }
+
+    /**
+     * @brief Deepest gain reduction (negative dB) per lane since the last reset
+     */
+    float getPeakGainReductionDb(int lane) const { return peakGainReduction[static_cast<size_t>(lane)]; }
+    void resetPeakGainReduction() { std::fill(peakGainReduction.begin(), peakGainReduction.end(), 0.0f); }
+
+    /**
+     * @brief log2(x) for x > 0, ~1e-7 absolute error, vectorisable
+     */
+    static float fastLog2(float x) noexcept
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+
+        // x = m * 2^e with m in [sqrt(0.5), sqrt(2))
+        const auto offset = (bits - 0x3f3504f3u) & 0xff800000u;
+        const auto exponent = static_cast<float>(static_cast<std::int32_t>(offset) >> 23);
+        const std::uint32_t mantissaBits = bits - offset;
+        float m;
+        std::memcpy(&m, &mantissaBits, sizeof(m));
+
+        // log2(m) = 2/ln2 * atanh(z), z = (m - 1) / (m + 1), |z| < 0.172
+        const float z = (m - 1.0f) / (m + 1.0f);
+        const float z2 = z * z;
+        const float series = z * (2.8853900f + z2 * (0.9617967f + z2 * (0.5770780f + z2 * 0.4121986f)));
+        return exponent + series;
+    }
+
+    /**
+     * @brief 2^x, ~2e-6 relative error, vectorisable; clamped to the normal range
+     */
+    static float fastExp2(float x) noexcept
+    {
+        x = minOf(126.0f, maxOf(-126.0f, x));
+
+        // x = i + f, f in [-0.5, 0.5] (the offset keeps the truncation positive)
+        const float rounded = static_cast<float>(static_cast<std::int32_t>(x + 127.5f) - 127);
+        const float f = x - rounded;
+        const float p = 1.0f + f * (0.6931472f + f * (0.2402265f + f * (0.0555041f + f * (0.0096181f + f * 0.0013333f))));
+
+        const auto exponentBits = static_cast<std::uint32_t>(static_cast<std::int32_t>(rounded) + 127) << 23;
+        float scale;
+        std::memcpy(&scale, &exponentBits, sizeof(scale));
+        return p * scale;
+    }
+
+    /**
+     * @brief 1/sqrt(x), ~1e-7 relative error; finite for x = 0 (so x * it is 0)
+     * std::sqrt would keep the kernel scalar: its errno path is a branch
+     */
+    static float fastInverseSqrt(float x) noexcept
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        bits = 0x5f375a86u - (bits >> 1);
+
+        float y;
+        std::memcpy(&y, &bits, sizeof(y));
+        const float half = 0.5f * x;
+        y = y * (1.5f - half * y * y);
+        y = y * (1.5f - half * y * y);
+        return y * (1.5f - half * y * y);
+    }
+
+private:
+    /**
+     * @brief cond ? a : b as a bitwise blend, so nothing is computed conditionally
+     * (a ternary lets the compiler sink one side into a branch, which keeps
+     * the lane loop scalar unless floating-point traps are disabled)
+     */
+    static float select(bool condition, float a, float b) noexcept
+    {
+        const auto mask = 0u - static_cast<std::uint32_t>(condition);
+        std::uint32_t aBits, bBits;
+        std::memcpy(&aBits, &a, sizeof(aBits));
+        std::memcpy(&bBits, &b, sizeof(bBits));
+
+        const std::uint32_t blended = (aBits & mask) | (bBits & ~mask);
+        float result;
+        std::memcpy(&result, &blended, sizeof(result));
+        return result;
+    }
+
+    static float maxOf(float a, float b) noexcept { return select(a > b, a, b); }
+    static float minOf(float a, float b) noexcept { return select(a < b, a, b); }
+
+    static constexpr int laneAlignment = 16;                   // AVX-512 width in floats
+    static constexpr float dbPerLog2 = 6.0205999f;             // 20 * log10(2)
+    static constexpr float log2PerDb = 1.0f / 6.0205999f;
+    static constexpr float floorLevel = 3.1622777e-5f;         // -90 dB, SidechainDetector::floorDb
+    static constexpr float rmsWeight = 0.7f;
+    static constexpr float peakWeight = 0.3f;
+    static constexpr float fastReleaseRatio = 0.3f;
+    static constexpr float slowReleaseRatio = 1.5f;
+    static constexpr float releaseStageThreshold = 0.5f;
+
+    /**
+     * @brief One sample for every lane: mono input in, linear gain out (in place)
+     */
+    void computeGains(float* frame)
+    {
+        float* ring = rmsRing.data() + static_cast<size_t>(rmsWriteIndex * stride);
+        if (++rmsWriteIndex == rmsWindowSize)
+            rmsWriteIndex = 0;
+
+        // Raw pointers and values hoisted out of the lane loop, so every
+        // load is unconditional and the selects below become blends
+        float* const sums = rmsSum.data();
+        float* const peaks = peakEnvelope.data();
+        float* const envelopes = envelope.data();
+        float* const peakLevels = peakLevel.data();
+        float* const slowStages = slowRelease.data();
+        float* const deepest = peakGainReduction.data();
+        const float* const attacks = attackCoeff.data();
+        const float* const fastReleases = releaseCoeffFast.data();
+        const float* const slowReleases = releaseCoeffSlow.data();
+        const float* const thresholds = threshold.data();
+        const float* const slopes = slope.data();
+        const float* const knees = kneeWidth.data();
+        const float* const kneeCurves = halfSlopeOverKnee.data();
+        const float scale = rmsScale;
+        const float peakAttack = peakAttackCoeff;
+        const float peakRelease = peakReleaseCoeff;
+
+#if defined(__clang__)
+#pragma clang loop vectorize(assume_safety)
+#elif defined(__GNUC__)
+#pragma GCC ivdep
+#elif defined(_MSC_VER)
+#pragma loop(ivdep)
+#endif
+        for (int lane = 0; lane < stride; ++lane)
+        {
+            // Hybrid RMS/peak detector
+            const float mono = frame[lane];
+            const float squared = mono * mono;
+            const float magnitude = std::abs(mono);
+
+            const float sum = sums[lane] - ring[lane] + squared;
+            sums[lane] = sum;
+            ring[lane] = squared;
+            const float meanSquare = maxOf(0.0f, sum * scale);
+            const float rms = meanSquare * fastInverseSqrt(meanSquare);
+
+            const float peak = peaks[lane];
+            const float peakAttacked = peakAttack * peak + (1.0f - peakAttack) * magnitude;
+            const float peakNext = select(magnitude > peak, peakAttacked, peakRelease * peak);
+            peaks[lane] = peakNext;
+
+            const float hybrid = rms * rmsWeight + peakNext * peakWeight;
+            const float detection = select(hybrid > floorLevel, hybrid, 0.0f);
+
+            // Optical two-stage envelope
+            const float env = envelopes[lane];
+            const float peakLevelNow = peakLevels[lane];
+            const float attack = attacks[lane];
+            const float fastRelease = fastReleases[lane];
+            const float slowReleaseCoeff = slowReleases[lane];
+
+            const bool rising = detection > env;
+            const bool slow = ! rising & ((slowStages[lane] != 0.0f) | (env < peakLevelNow * releaseStageThreshold));
+            const float releaseCoeff = select(slow, slowReleaseCoeff, fastRelease);
+            const float coeff = select(rising, attack, releaseCoeff);
+            const float envNext = coeff * env + (1.0f - coeff) * detection;
+            envelopes[lane] = envNext;
+            peakLevels[lane] = select(rising, envNext, peakLevelNow);
+            slowStages[lane] = select(slow, 1.0f, 0.0f);
+
+            const float envelopeDb = maxOf(-90.0f, dbPerLog2 * fastLog2(maxOf(envNext, 1.0e-30f)));
+
+            // Soft-knee gain computer
+            const float halfKnee = 0.5f * knees[lane];
+            const float overshoot = envelopeDb - thresholds[lane];
+            const float intoKnee = overshoot + halfKnee;
+            const float kneeReduction = -kneeCurves[lane] * intoKnee * intoKnee;
+            const float fullReduction = -slopes[lane] * overshoot;
+            const float compressed = select(overshoot >= halfKnee, fullReduction, kneeReduction);
+            const float grDb = select(intoKnee <= 0.0f, 0.0f, compressed);
+
+            deepest[lane] = minOf(deepest[lane], grDb);
+            frame[lane] = fastExp2(grDb * log2PerDb);
+        }
+    }
+
+    void updateTimeCoefficients(int lane)
+    {
+        const auto index = static_cast<size_t>(lane);
+        const double attackSec = attackMs[index] / 1000.0;
+        const double releaseSec = releaseMs[index] / 1000.0;
+
+        attackCoeff[index] = static_cast<float>(std::exp(-1.0 / (sampleRate * attackSec)));
+        releaseCoeffFast[index] = static_cast<float>(std::exp(-1.0 / (sampleRate * releaseSec * fastReleaseRatio)));
+        releaseCoeffSlow[index] = static_cast<float>(std::exp(-1.0 / (sampleRate * releaseSec * slowReleaseRatio)));
+    }
+
+    void updateKnee(int lane)
+    {
+        const auto index = static_cast<size_t>(lane);
+        const float knee = kneeWidth[index];
+        halfSlopeOverKnee[index] = knee > 0.0f ? slope[index] * 0.5f / knee : 0.0f;
+    }
+
+    double sampleRate = 44100.0;
+    int numLanes = 0;
+    int stride = 0;        // lanes rounded up to laneAlignment; padding lanes are fed silence
+    int maxSamples = 0;
+
+    // Detector (shared timing, per-lane state)
+    int rmsWindowSize = 1;
+    int rmsWriteIndex = 0;
+    float rmsScale = 1.0f;
+    float peakAttackCoeff = 0.0f;
+    float peakReleaseCoeff = 0.0f;
+    std::vector<float> rmsRing;        // [window position][lane]
+    std::vector<float> rmsSum;
+    std::vector<float> peakEnvelope;
+
+    // Envelope state and per-lane coefficients
+    std::vector<float> envelope;
+    std::vector<float> peakLevel;
+    std::vector<float> slowRelease;    // 0 or 1
+    std::vector<float> attackMs, releaseMs;
+    std::vector<float> attackCoeff, releaseCoeffFast, releaseCoeffSlow;
+
+    // Gain computer parameters
+    std::vector<float> threshold;
+    std::vector<float> slope;          // 1 - 1/ratio
+    std::vector<float> kneeWidth;
+    std::vector<float> halfSlopeOverKnee;
+
+    std::vector<float> peakGainReduction;
+
+    // Block scratch, [sample][lane]: mono input, then linear gain
+    std::vector<float> frames;
+};
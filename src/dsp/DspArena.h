@@ -0,0 +1,94 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief One contiguous, cache-line-aligned allocation for an instance's DSP buffers
+ *
+ * Stages report how many floats they need (getArenaFloats()), the processor
+ * reserves the total once in prepareToPlay, and each stage carves its
+ * regions out in order. Every region starts on its own cache line, so
+ * neighbouring buffers never share one and SIMD loads are aligned.
+ *
+ * Regions are only carved in prepare(), never on the audio thread. A stage
+ * that asks for more than its getArenaFloats() trips an assertion and, in
+ * release builds, gets a separate heap region instead of a null pointer.
+ */
+class DspArena
+{
+public:
+    static constexpr size_t alignment = 64;
+    static constexpr size_t floatsPerLine = alignment / sizeof(float);
+
+    /**
+     * @brief Floats a region of numFloats takes up, including padding to the next line
+     */
+    static constexpr size_t regionFloats(size_t numFloats) noexcept
+    {
+        return (numFloats + floatsPerLine - 1) / floatsPerLine * floatsPerLine;
+    }
+
+    /**
+     * @brief Make room for numFloats and forget previous regions (not real-time safe)
+     * Keeps the existing allocation when it is already large enough.
+     */
+    void reserve(size_t numFloats)
+    {
+        if (numFloats > capacity)
+        {
+            storage.free();
+            storage.allocate(numFloats * sizeof(float) + alignment, false);
+
+            const auto address = reinterpret_cast<std::uintptr_t>(storage.get());
+            base = reinterpret_cast<float*>((address + alignment - 1) & ~(alignment - 1));
+            capacity = numFloats;
+        }
+
+        used = 0;
+        overflow.clear();
+        overflowFloats = 0;
+    }
+
+    /**
+     * @brief Next zeroed, line-aligned region of numFloats (prepare time only)
+     * Past the reserved capacity the region comes from the heap, so it is
+     * never null; the arena is resized on the next reserve().
+     */
+    float* allocate(size_t numFloats)
+    {
+        const auto size = regionFloats(numFloats);
+        jassert(used + size <= capacity);  // a stage asked for more than its getArenaFloats()
+
+        if (used + size > capacity)
+        {
+            overflow.emplace_back(size + floatsPerLine, true);
+            overflowFloats += size;
+
+            const auto address = reinterpret_cast<std::uintptr_t>(overflow.back().get());
+            return reinterpret_cast<float*>((address + alignment - 1) & ~(alignment - 1));
+        }
+
+        auto* region = base + used;
+        std::fill(region, region + size, 0.0f);
+        used += size;
+        return region;
+    }
+
+    size_t getCapacityBytes() const noexcept { return (capacity + overflowFloats) * sizeof(float); }
+    size_t getUsedBytes() const noexcept { return (used + overflowFloats) * sizeof(float); }
+
+    /**
+     * @brief Bytes handed out past the reserved capacity (0 unless a stage under-reports)
+     */
+    size_t getOverflowBytes() const noexcept { return overflowFloats * sizeof(float); }
+
+private:
+    juce::HeapBlock<char> storage;
+    float* base = nullptr;
+    size_t capacity = 0;
+    size_t used = 0;
+    std::vector<juce::HeapBlock<float>> overflow;
+    size_t overflowFloats = 0;
+};
@@ -62,7 +62,7 @@ public:
     float processSample(float detectionDb)
     {
         // Convert dB to linear for envelope following
-        float detectionLinear = juce::Decibels::decibelsToGain(detectionDb, -60.0f);
+        float detectionLinear = juce::Decibels::decibelsToGain(detectionDb, floorDb);
 
         if (detectionLinear > envelope)
         {
@@ -88,7 +88,7 @@ public:
         }
 
         // Convert back to dB
-        return juce::Decibels::gainToDecibels(envelope, -60.0f);
+        return juce::Decibels::gainToDecibels(envelope, floorDb);
     }
 
     /**
@@ -107,9 +107,14 @@ public:
      */
     float getCurrentEnvelopeDb() const
     {
-        return juce::Decibels::gainToDecibels(envelope, -60.0f);
+        return juce::Decibels::gainToDecibels(envelope, floorDb);
     }
 
+    /**
+     * @brief Lowest level in and out (dB), the detector's floor
+     */
+    static constexpr float floorDb = -90.0f;
+
 private:
     void updateCoefficients()
     {
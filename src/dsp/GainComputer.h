@@ -18,20 +18,32 @@
  * - Below knee: output = input (no compression)
  * - In knee: gradual transition (quadratic interpolation)
  * - Above knee: output = threshold + (input - threshold) / ratio
+ *
+ * Optional downward expander/gate on the same envelope (off at 1:1):
+ * - Opens at the expander threshold, closes only hysteresis dB below it
+ *   and not before the hold time has run out
+ * - Closed: output = threshold + (input - threshold) * ratio, at most
+ *   expanderRangeDb down, smoothed over ~2ms against clicks
+ * processSample() returns compression and expansion together.
  */
 class GainComputer
 {
 public:
     GainComputer() = default;
 
-    void prepare(double /*sampleRate*/, int /*samplesPerBlock*/)
+    void prepare(double newSampleRate, int /*samplesPerBlock*/)
     {
-        // No sample-rate dependent state
+        sampleRate = newSampleRate;
+        expanderSmoothingCoeff = static_cast<float>(std::exp(-1.0 / (sampleRate * 0.002)));
+        updateHoldSamples();
+        reset();
     }
 
     void reset()
     {
-        // No state to reset
+        expanderOpen = true;
+        holdCounter = 0;
+        expansionDb = 0.0f;
     }
 
     /**
@@ -60,6 +72,83 @@ public:
         updateKneeBounds();
     }
 
+    /**
+     * @brief Set expander threshold in dB (the level it opens at)
+     */
+    void setExpanderThreshold(float thresholdDb)
+    {
+        expanderThreshold = thresholdDb;
+    }
+
+    /**
+     * @brief Set expansion ratio (1.0 = expander off, 20.0 = gate-like)
+     */
+    void setExpanderRatio(float newRatio)
+    {
+        expanderSlope = juce::jmax(1.0f, newRatio) - 1.0f;
+    }
+
+    /**
+     * @brief Set how far below the threshold the level must fall to close (dB)
+     */
+    void setExpanderHysteresis(float hysteresisDb)
+    {
+        expanderHysteresis = juce::jmax(0.0f, hysteresisDb);
+    }
+
+    /**
+     * @brief Set how long the expander stays open after the level drops (ms)
+     */
+    void setExpanderHoldMs(float holdMs)
+    {
+        expanderHoldMs = juce::jmax(0.0f, holdMs);
+        updateHoldSamples();
+    }
+
+    /**
+     * @brief Compression and expansion for one envelope sample (stateful)
+     * @param inputDb Input level in dB (from envelope follower)
+     * @return Total gain reduction in dB (negative value)
+     */
+    float processSample(float inputDb)
+    {
+        return computeGainReduction(inputDb) + computeExpansion(inputDb);
+    }
+
+    /**
+     * @brief Expander gain for one envelope sample (stateful: hysteresis, hold)
+     * @return Expansion in dB (0 when open or off, negative when closed)
+     */
+    float computeExpansion(float inputDb)
+    {
+        if (expanderSlope <= 0.0f && expansionDb == 0.0f)
+            return 0.0f;
+
+        if (inputDb >= expanderThreshold)
+        {
+            expanderOpen = true;
+            holdCounter = holdSamples;
+        }
+        else if (holdCounter > 0)
+        {
+            --holdCounter;
+        }
+        else if (inputDb < expanderThreshold - expanderHysteresis)
+        {
+            expanderOpen = false;
+        }
+
+        const float target = expanderOpen ? 0.0f
+                                          : juce::jmax(-expanderRangeDb, (inputDb - expanderThreshold) * expanderSlope);
+        expansionDb = target + expanderSmoothingCoeff * (expansionDb - target);
+
+        // Settle exactly at 0 so a switched-off expander takes the early out again
+        if (expansionDb > -1.0e-4f && target == 0.0f)
+            expansionDb = 0.0f;
+
+        return expansionDb;
+    }
+
     /**
      * @brief Compute gain reduction for a given input level
      * @param inputDb Input level in dB (from envelope follower)
@@ -93,6 +182,21 @@ public:
         return outputDb - inputDb;
     }
 
+    /**
+     * @brief This stage in series after another: it hears the other's output
+     * @param previousGainReductionDb What the earlier stage takes off (negative)
+     * @param inputDb This stage's detector level before the earlier stage's gain
+     * @return Both stages' gain reduction together, in dB (negative value)
+     *
+     * Each stage's curve rises with its input, so the pair does too; summing
+     * two computers fed the same input does not (past 2:1 the sum's slope
+     * goes negative).
+     */
+    float computeSeriesGainReduction(float previousGainReductionDb, float inputDb) const
+    {
+        return previousGainReductionDb + computeGainReduction(inputDb + previousGainReductionDb);
+    }
+
     /**
      * @brief Compute output level for a given input (for visualization)
      * @param inputDb Input level in dB
@@ -120,6 +224,9 @@ public:
     float getKneeWidth() const { return kneeWidth; }
     float getKneeStart() const { return kneeStart; }
     float getKneeEnd() const { return kneeEnd; }
+    bool isExpanderOpen() const { return expanderOpen; }
+
+    static constexpr float expanderRangeDb = 40.0f;  // deepest expansion (gate floor)
 
 private:
     void updateKneeBounds()
@@ -128,6 +235,13 @@ private:
         kneeEnd = threshold + kneeWidth * 0.5f;
     }
 
+    void updateHoldSamples()
+    {
+        holdSamples = static_cast<int>(sampleRate * expanderHoldMs / 1000.0);
+    }
+
+    double sampleRate = 44100.0;
+
     float threshold = -20.0f;    // dB
     float ratio = 4.0f;          // :1
     float kneeWidth = 6.0f;      // dB (soft knee)
@@ -135,4 +249,16 @@ private:
     // Precomputed knee bounds
     float kneeStart = -23.0f;    // threshold - knee/2
     float kneeEnd = -17.0f;      // threshold + knee/2
+
+    // Expander/gate
+    float expanderThreshold = -50.0f;   // dB
+    float expanderSlope = 0.0f;         // ratio - 1 (0 = off)
+    float expanderHysteresis = 3.0f;    // dB
+    float expanderHoldMs = 20.0f;
+    int holdSamples = 882;
+    float expanderSmoothingCoeff = 0.0f;
+
+    bool expanderOpen = true;
+    int holdCounter = 0;
+    float expansionDb = 0.0f;
 };
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+
+/**
+ * @brief Integer-sample delay for keeping parallel paths time-aligned
+ *
+ * When one path of a stage has latency (the linear-phase oversampler in
+ * the transformer), every path it is mixed or crossfaded with is delayed by
+ * the same amount through one of these. Ring buffers are stored inline, so
+ * the delay never allocates; it holds at most maxDelay samples.
+ *
+ * The delay can be switched out (setActive()) when the latent path is off:
+ * the line keeps running, so switching it back in lines up at once, and
+ * either switch crossfades between the delayed and undelayed signal.
+ */
+class LatencyDelay
+{
+public:
+    static constexpr int maxChannels = 2;
+    static constexpr int maxDelay = 256;
+
+    /**
+     * @brief Set the delay in samples and clear the line
+     */
+    void setDelay(int numSamples) noexcept
+    {
+        jassert(numSamples >= 0 && numSamples <= maxDelay);
+        delay = juce::jlimit(0, maxDelay, numSamples);
+        reset();
+    }
+
+    int getDelay() const noexcept { return delay; }
+
+    /**
+     * @brief Switch the delay in or out, crossfading over fadeSamples (0 switches at once)
+     */
+    void setActive(bool shouldBeActive, int fadeSamples) noexcept
+    {
+        if (shouldBeActive == active)
+            return;
+
+        active = shouldBeActive;
+        fadeLength = juce::jmax(0, fadeSamples);
+        fadeRemaining.fill(fadeLength);
+    }
+
+    bool isActive() const noexcept { return active; }
+
+    /**
+     * @brief Delay the output has once any switch has faded: getDelay() or 0
+     */
+    int getLatency() const noexcept { return active ? delay : 0; }
+
+    void reset() noexcept
+    {
+        for (auto& line : lines)
+            line.fill(0.0f);
+        positions.fill(0);
+        fadeRemaining.fill(0);
+    }
+
+    /**
+     * @brief One sample of one channel, for per-sample loops
+     */
+    float processSample(size_t channel, float input) noexcept
+    {
+        if (delay == 0)
+            return input;
+
+        auto& position = positions[channel];
+        const float output = lines[channel][static_cast<size_t>(position)];
+        lines[channel][static_cast<size_t>(position)] = input;
+        position = position + 1 == delay ? 0 : position + 1;
+
+        auto& remaining = fadeRemaining[channel];
+        if (remaining == 0)
+            return active ? output : input;
+
+        // Still leaving the other signal
+        const float from = static_cast<float>(remaining--) / static_cast<float>(fadeLength + 1);
+        return active ? output + from * (input - output) : input + from * (output - input);
+    }
+
+    /**
+     * @brief Delay one channel from input to output (may be the same buffer)
+     */
+    void process(size_t channel, const float* input, float* output, size_t numSamples) noexcept
+    {
+        for (size_t sample = 0; sample < numSamples; ++sample)
+            output[sample] = processSample(channel, input[sample]);
+    }
+
+    /**
+     * @brief Delay a block in place
+     */
+    void process(const juce::dsp::AudioBlock<float>& block) noexcept
+    {
+        const auto numChannels = juce::jmin(block.getNumChannels(), static_cast<size_t>(maxChannels));
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            auto* data = block.getChannelPointer(channel);
+            process(channel, data, data, block.getNumSamples());
+        }
+    }
+
+    /**
+     * @brief The last getDelay() inputs of a channel, oldest first (whether or not the delay is active)
+     */
+    void copyHistory(size_t channel, float* destination) const noexcept
+    {
+        const auto& line = lines[channel];
+        const int position = positions[channel];
+
+        for (int sample = 0; sample < delay; ++sample)
+            destination[sample] = line[static_cast<size_t>((position + sample) % delay)];
+    }
+
+    /**
+     * @brief The next numSamples outputs of a channel (at most getDelay()), without moving the line
+     */
+    void copyPending(size_t channel, float* destination, int numSamples) const noexcept
+    {
+        const auto& line = lines[channel];
+        const int position = positions[channel];
+
+        for (int sample = 0; sample < juce::jmin(numSamples, delay); ++sample)
+            destination[sample] = line[static_cast<size_t>((position + sample) % delay)];
+    }
+
+private:
+    int delay = 0;
+    bool active = true;
+    int fadeLength = 0;
+    std::array<int, maxChannels> fadeRemaining {};
+    std::array<std::array<float, maxDelay>, maxChannels> lines {};
+    std::array<int, maxChannels> positions {};
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+/**
+ * @brief Linear crossfade over a fixed number of samples, spread across blocks
+ *
+ * Used wherever a stage swaps one processing path for another mid-stream
+ * (a new waveshaper table, a different tube mode): both paths run while the
+ * fade is active and the output glides from the old one to the new one.
+ *
+ * Per block: blend() every channel, then advance(numSamples) once.
+ */
+class LinearCrossfade
+{
+public:
+    static constexpr double defaultSeconds = 0.005;   // matches FAT smoothing time
+
+    void prepare(double sampleRate, double seconds = defaultSeconds)
+    {
+        length = juce::jmax(1, static_cast<int>(sampleRate * seconds));
+        remaining = 0;
+    }
+
+    void start() { remaining = length; }
+
+    /**
+     * @brief start(), or turn a running fade round from where it has got to
+     * The paths swap roles: blend() now glides back toward the old one.
+     */
+    void startOrReverse() { remaining = isActive() ? juce::jmax(1, length - remaining) : length; }
+    void stop() { remaining = 0; }
+    bool isActive() const { return remaining > 0; }
+
+    /**
+     * @brief Weight of the new path after the next sample is blended
+     */
+    float getNextFade() const { return 1.0f - static_cast<float>(remaining - 1) * getStep(); }
+    float getStep() const { return 1.0f / static_cast<float>(length); }
+
+    /**
+     * @brief Number of samples of a block that are still inside the fade
+     */
+    int getFadeSamples(int numSamples) const { return juce::jmin(numSamples, remaining); }
+
+    /**
+     * @brief Glide one channel from the old path's output to the new path's, in place
+     * @param from Old path, same samples
+     * @param to New path, overwritten with the blend
+     */
+    void blend(const float* from, float* to, int numSamples) const
+    {
+        const float step = getStep();
+        float fade = getNextFade();
+
+        for (int sample = 0; sample < getFadeSamples(numSamples); ++sample, fade += step)
+            to[sample] = from[sample] + fade * (to[sample] - from[sample]);
+    }
+
+    /**
+     * @brief Move the fade on by a block; returns true when it just finished
+     */
+    bool advance(int numSamples)
+    {
+        if (remaining <= 0)
+            return false;
+
+        remaining = juce::jmax(0, remaining - numSamples);
+        return remaining == 0;
+    }
+
+private:
+    int length = 1;
+    int remaining = 0;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <complex>
+#include "Biquad.h"
+
+/**
+ * @brief Second-order Linkwitz-Riley (LR2) band split with a gain on the high band
+ *
+ * The bands are Q = 0.5 low- and high-pass biquads at the same frequency
+ * (first-order Butterworth, squared). With the high band's polarity
+ * flipped they are in phase, and low - high is a first-order allpass:
+ * unity gain at every frequency, so the split is inaudible while the high
+ * band is left alone. Turning the high band down dips everything above the
+ * crossover at 12 dB/octave, without the bump around the crossover that
+ * subtracting a high-pass from the input leaves.
+ *
+ * Used by the De-Ess mode, per sample inside the compression loop.
+ */
+class LinkwitzRileyCrossover
+{
+public:
+    static constexpr int maxChannels = Biquad::maxChannels;
+
+    void prepare(double sampleRate, float frequency) noexcept
+    {
+        lowPass.setCoefficients(juce::dsp::IIR::ArrayCoefficients<float>::makeLowPass(sampleRate, frequency, 0.5f));
+        highPass.setCoefficients(juce::dsp::IIR::ArrayCoefficients<float>::makeHighPass(sampleRate, frequency, 0.5f));
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        lowPass.reset();
+        highPass.reset();
+    }
+
+    /**
+     * @brief One sample of one channel: low band plus the high band at highGain
+     */
+    float processSample(size_t channel, float input, float highGain) noexcept
+    {
+        const float low = lowPass.processSample(channel, input);
+        const float high = highPass.processSample(channel, input);
+        return low - highGain * high;
+    }
+
+    /**
+     * @brief Flush denormal state left by processSample() (once per block)
+     */
+    void snapToZero() noexcept
+    {
+        lowPass.snapToZero();
+        highPass.snapToZero();
+    }
+
+    /**
+     * @brief Complex frequency response with the high band at highGain
+     */
+    std::complex<double> getResponse(double frequency, double sampleRate, double highGain) const noexcept
+    {
+        return lowPass.getResponse(frequency, sampleRate) - highGain * highPass.getResponse(frequency, sampleRate);
+    }
+
+private:
+    Biquad lowPass;
+    Biquad highPass;
+};
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+/**
+ * @brief Process-wide cache of immutable DSP tables shared by all instances
+ *
+ * Tables are keyed by (sample rate, type, quality, index) and handed out as
+ * shared_ptr<const Table>: the first instance to ask builds the table, every
+ * later one gets the same copy, and the table is freed when the last
+ * instance lets go. Builds happen outside the cache lock, so different
+ * tables are built in parallel; a second request for a table that is still
+ * being built waits for that build instead of repeating it.
+ *
+ * If a build throws, acquire() rethrows to its caller and to everyone
+ * waiting on that build, and nothing is cached for the key.
+ *
+ * Not real-time safe: acquire tables in prepare() or on a background thread,
+ * and only read them from the audio thread.
+ */
+class SharedTableCache
+{
+public:
+    enum class Type
+    {
+        tubeCurve = 0    // TubeSaturation::transferCurve, index = drive step
+    };
+
+    struct Key
+    {
+        double sampleRate = 0.0;   // 0 for tables that do not depend on it
+        Type type = Type::tubeCurve;
+        int quality = 0;           // table resolution
+        int index = 0;             // table-specific variant (e.g. drive step)
+
+        bool operator<(const Key& other) const
+        {
+            return std::tie(sampleRate, type, quality, index)
+                 < std::tie(other.sampleRate, other.type, other.quality, other.index);
+        }
+    };
+
+    /**
+     * @brief Shared table for a key, built with build() if no instance holds it
+     * @param build Callable filling a default-constructed Table in place
+     */
+    template <typename Table, typename Builder>
+    static std::shared_ptr<const Table> acquire(const Key& key, Builder&& build)
+    {
+        auto& cache = getInstance();
+        std::unique_lock<std::mutex> lock(cache.mutex);
+
+        auto& entry = cache.entries[key];
+        if (auto existing = entry.table.lock())
+            return std::static_pointer_cast<const Table>(existing);
+
+        if (entry.pending.valid())
+        {
+            // Another thread is building it
+            auto pending = entry.pending;
+            lock.unlock();
+            return std::static_pointer_cast<const Table>(pending.get());
+        }
+
+        std::promise<std::shared_ptr<const void>> promise;
+        entry.pending = promise.get_future().share();
+        lock.unlock();
+
+        std::shared_ptr<const Table> shared;
+        try
+        {
+            auto table = std::make_shared<Table>();
+            build(*table);
+            shared = std::move(table);
+        }
+        catch (...)
+        {
+            // Waiters get the exception instead of waiting for good, and the
+            // entry goes, so a later acquire() tries the build again
+            lock.lock();
+            cache.entries.erase(key);
+            lock.unlock();
+
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+
+        lock.lock();
+        cache.removeExpired();
+        auto& built = cache.entries[key];
+        built.table = shared;
+        built.bytes = sizeof(Table);
+        built.pending = {};
+        lock.unlock();
+
+        promise.set_value(shared);
+        return shared;
+    }
+
+    /**
+     * @brief Tables currently alive and the memory they take (all instances together)
+     */
+    static int getNumTables()
+    {
+        int numTables = 0;
+        forEachLive([&numTables](size_t) { ++numTables; });
+        return numTables;
+    }
+
+    static size_t getTotalBytes()
+    {
+        size_t totalBytes = 0;
+        forEachLive([&totalBytes](size_t bytes) { totalBytes += bytes; });
+        return totalBytes;
+    }
+
+private:
+    struct Entry
+    {
+        std::weak_ptr<const void> table;
+        std::shared_future<std::shared_ptr<const void>> pending;
+        size_t bytes = 0;
+    };
+
+    static SharedTableCache& getInstance()
+    {
+        static SharedTableCache instance;
+        return instance;
+    }
+
+    template <typename Callback>
+    static void forEachLive(Callback&& callback)
+    {
+        auto& cache = getInstance();
+        const std::lock_guard<std::mutex> lock(cache.mutex);
+
+        for (const auto& [key, entry] : cache.entries)
+            if (! entry.table.expired())
+                callback(entry.bytes);
+    }
+
+    // Lock held
+    void removeExpired()
+    {
+        for (auto it = entries.begin(); it != entries.end();)
+        {
+            if (it->second.table.expired() && ! it->second.pending.valid())
+                it = entries.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    std::mutex mutex;
+    std::map<Key, Entry> entries;
+};
@@ -2,6 +2,8 @@
 
 #include <juce_dsp/juce_dsp.h>
 #include <cmath>
+#include "Biquad.h"
+#include "DspArena.h"
 
 /**
  * @brief Hybrid RMS-Peak Sidechain Detector
@@ -12,22 +14,36 @@
  *
  * The RMS window is ~10ms for good transient response while
  * maintaining the smooth optical feel.
+ *
+ * processLevels() returns both components of one pass, so a second gain
+ * stage (the VCA in Opto + VCA mode) reads the peak level without a
+ * detector of its own.
+ *
+ * processSibilanceLevels() is the same pass heard through a sibilance
+ * band-pass (de-essing): one filter in front of the shared RMS/peak state.
  */
 class SidechainDetector
 {
 public:
     SidechainDetector() = default;
 
-    void prepare(double newSampleRate, int samplesPerBlock)
+    /**
+     * @brief Arena space prepare() takes for the RMS window
+     */
+    static size_t getArenaFloats(double sampleRate)
+    {
+        return DspArena::regionFloats(static_cast<size_t>(windowSizeFor(sampleRate)));
+    }
+
+    void prepare(double newSampleRate, int samplesPerBlock, DspArena& arena)
     {
         sampleRate = newSampleRate;
 
         // RMS window of ~10ms for good balance
-        rmsWindowSize = static_cast<int>(sampleRate * 0.01);
-        rmsWindowSize = std::max(1, rmsWindowSize);
+        rmsWindowSize = windowSizeFor(sampleRate);
 
-        // Circular buffer for RMS calculation
-        rmsBuffer.resize(static_cast<size_t>(rmsWindowSize), 0.0f);
+        // Circular buffer for RMS calculation (zeroed arena region)
+        rmsBuffer = arena.allocate(static_cast<size_t>(rmsWindowSize));
         rmsWriteIndex = 0;
         rmsSum = 0.0f;
 
@@ -37,17 +53,33 @@ public:
         peakReleaseCoeff = static_cast<float>(std::exp(-1.0 / (sampleRate * 0.05)));
         peakEnvelope = 0.0f;
 
+        // Sibilance band-pass for de-essing (~4-10kHz)
+        sibilanceBand.setCoefficients(juce::dsp::IIR::ArrayCoefficients<float>::makeBandPass(
+            sampleRate, juce::jmin(sibilanceFrequency, static_cast<float>(sampleRate * 0.45)), sibilanceQ));
+        sibilanceBand.reset();
+
         juce::ignoreUnused(samplesPerBlock);
     }
 
     void reset()
     {
-        std::fill(rmsBuffer.begin(), rmsBuffer.end(), 0.0f);
+        if (rmsBuffer != nullptr)
+            std::fill(rmsBuffer, rmsBuffer + rmsWindowSize, 0.0f);
         rmsWriteIndex = 0;
         rmsSum = 0.0f;
         peakEnvelope = 0.0f;
+        sibilanceBand.reset();
     }
 
+    /**
+     * @brief RMS and peak components of one detection pass (linear)
+     */
+    struct Levels
+    {
+        float rms = 0.0f;
+        float peak = 0.0f;
+    };
+
     /**
      * @brief Process a single sample and return hybrid detection level in dB
      * @param inputL Left channel sample
@@ -55,35 +87,64 @@ public:
      * @return Detection level in dB
      */
     float processSample(float inputL, float inputR)
+    {
+        return toHybridDecibels(processLevels(inputL, inputR));
+    }
+
+    /**
+     * @brief Process a single sample and return the RMS and peak components
+     */
+    Levels processLevels(float inputL, float inputR)
     {
         // Sum to mono for detection
-        float monoInput = (inputL + inputR) * 0.5f;
-        float inputSquared = monoInput * monoInput;
-        float inputAbs = std::abs(monoInput);
+        return processMonoLevels((inputL + inputR) * 0.5f);
+    }
 
-        // === RMS Detection (sliding window) ===
-        // Remove oldest sample from sum
-        rmsSum -= rmsBuffer[static_cast<size_t>(rmsWriteIndex)];
-        // Add new squared sample
-        rmsBuffer[static_cast<size_t>(rmsWriteIndex)] = inputSquared;
-        rmsSum += inputSquared;
-        // Advance write index
-        rmsWriteIndex = (rmsWriteIndex + 1) % rmsWindowSize;
+    /**
+     * @brief As processLevels(), listening through the sibilance band-pass
+     */
+    Levels processSibilanceLevels(float inputL, float inputR)
+    {
+        return processMonoLevels(sibilanceBand.processSample(0, (inputL + inputR) * 0.5f));
+    }
 
-        // Calculate RMS
-        float rmsLevel = std::sqrt(rmsSum / static_cast<float>(rmsWindowSize));
+    /**
+     * @brief Clear the band-pass, so de-essing starts without the stale tail
+     * of the last time it ran
+     */
+    void resetSibilanceBand()
+    {
+        sibilanceBand.reset();
+    }
 
-        // === Peak Detection (envelope follower) ===
-        if (inputAbs > peakEnvelope)
-            peakEnvelope = peakAttackCoeff * peakEnvelope + (1.0f - peakAttackCoeff) * inputAbs;
-        else
-            peakEnvelope = peakReleaseCoeff * peakEnvelope;
+    /**
+     * @brief Flush the band-pass state (once per block in de-essing mode)
+     */
+    void endSibilanceBlock()
+    {
+        sibilanceBand.snapToZero();
+    }
+
+    /**
+     * @brief Lowest level reported (dB), below the expander's lowest threshold
+     */
+    static constexpr float floorDb = -90.0f;
+
+    /**
+     * @brief Sibilance band-pass centre frequency (Hz)
+     */
+    static constexpr float sibilanceFrequency = 6500.0f;
+    static constexpr float sibilanceQ = 0.8f;
 
-        // === Hybrid Blend (70% RMS, 30% Peak) ===
-        float hybridLevel = rmsLevel * rmsWeight + peakEnvelope * peakWeight;
+    /**
+     * @brief Hybrid blend (70% RMS, 30% Peak) of one pass, in dB
+     */
+    float toHybridDecibels(const Levels& levels) const
+    {
+        float hybridLevel = levels.rms * rmsWeight + levels.peak * peakWeight;
 
-        // Convert to dB (with floor at -60dB)
-        return juce::Decibels::gainToDecibels(hybridLevel, -60.0f);
+        // Convert to dB (with floor at floorDb)
+        return juce::Decibels::gainToDecibels(hybridLevel, floorDb);
     }
 
     /**
@@ -105,10 +166,41 @@ public:
     }
 
 private:
+    Levels processMonoLevels(float monoInput)
+    {
+        float inputSquared = monoInput * monoInput;
+        float inputAbs = std::abs(monoInput);
+
+        // === RMS Detection (sliding window) ===
+        // Remove oldest sample from sum
+        rmsSum -= rmsBuffer[rmsWriteIndex];
+        // Add new squared sample
+        rmsBuffer[rmsWriteIndex] = inputSquared;
+        rmsSum += inputSquared;
+        // Advance write index
+        rmsWriteIndex = (rmsWriteIndex + 1) % rmsWindowSize;
+
+        // Calculate RMS
+        float rmsLevel = std::sqrt(rmsSum / static_cast<float>(rmsWindowSize));
+
+        // === Peak Detection (envelope follower) ===
+        if (inputAbs > peakEnvelope)
+            peakEnvelope = peakAttackCoeff * peakEnvelope + (1.0f - peakAttackCoeff) * inputAbs;
+        else
+            peakEnvelope = peakReleaseCoeff * peakEnvelope;
+
+        return { rmsLevel, peakEnvelope };
+    }
+
+    static int windowSizeFor(double rate)
+    {
+        return std::max(1, static_cast<int>(rate * 0.01));
+    }
+
     double sampleRate = 44100.0;
 
     // RMS detection
-    std::vector<float> rmsBuffer;
+    float* rmsBuffer = nullptr;  // region of the processor's arena
     int rmsWindowSize = 441; // ~10ms at 44.1kHz
     int rmsWriteIndex = 0;
     float rmsSum = 0.0f;
@@ -118,6 +210,9 @@ private:
     float peakReleaseCoeff = 0.0f;
     float peakEnvelope = 0.0f;
 
+    // De-essing: detection through a sibilance band-pass (mono, channel 0)
+    Biquad sibilanceBand;
+
     // Hybrid blend weights (70% RMS, 30% Peak)
     float rmsWeight = 0.7f;
     float peakWeight = 0.3f;
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <cmath>
+
+/**
+ * @brief Modulation-Safe Shelving Filter (TPT State-Variable)
+ *
+ * Topology-preserving transform SVF (trapezoidal integrators) configured as
+ * a low or high shelf. Unlike a biquad whose coefficients are swapped per
+ * block, the SVF keeps its state meaningful when coefficients move, so the
+ * shelf gain can glide every sample without zipper noise or spikes.
+ *
+ * Gain changes are ramped linearly across each block (in sqrt-amplitude,
+ * so A and A^2 fall out without a pow or sqrt per sample). All channels are
+ * advanced together in one SIMDRegister: lane = channel.
+ */
+class TptShelf
+{
+public:
+    enum class Type
+    {
+        lowShelf,
+        highShelf
+    };
+
+    static constexpr int maxChannels = 4;
+
+    TptShelf() = default;
+
+    void prepare(double sampleRate, Type newType, float cutoffHz, float q)
+    {
+        type = newType;
+        warpedCutoff = static_cast<float>(std::tan(juce::MathConstants<double>::pi * cutoffHz / sampleRate));
+        damping = 1.0f / q;
+
+        currentRootGain = targetRootGain;
+        reset();
+    }
+
+    void reset()
+    {
+        ic1eq = Vec::expand(0.0f);
+        ic2eq = Vec::expand(0.0f);
+    }
+
+    /**
+     * @brief Set the shelf gain; reached at the end of the next block
+     */
+    void setGainDecibels(float gainDb)
+    {
+        targetRootGain = std::pow(10.0f, gainDb / 80.0f);  // sqrt(A), A = 10^(dB/40)
+    }
+
+    /**
+     * @brief Process channels in place, gliding the gain across the block
+     */
+    void process(float* const* channels, int numChannels, int numSamples)
+    {
+        const int lanes = juce::jmin(numChannels, maxChannels);
+        const float rootStep = (targetRootGain - currentRootGain) / static_cast<float>(juce::jmax(1, numSamples));
+
+        alignas(16) float frame[Vec::SIMDNumElements] {};
+
+        float rootGain = currentRootGain;
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            rootGain += rootStep;
+
+            // Per-sample coefficients (one division)
+            const float a = rootGain * rootGain;
+            const float g = type == Type::lowShelf ? warpedCutoff / rootGain : warpedCutoff * rootGain;
+            const float a1 = 1.0f / (1.0f + g * (g + damping));
+            const float a2 = g * a1;
+            const float a3 = g * a2;
+
+            float m0, m1, m2;
+            if (type == Type::lowShelf)
+            {
+                m0 = 1.0f;
+                m1 = damping * (a - 1.0f);
+                m2 = a * a - 1.0f;
+            }
+            else
+            {
+                m0 = a * a;
+                m1 = damping * (1.0f - a) * a;
+                m2 = 1.0f - a * a;
+            }
+
+            for (int lane = 0; lane < lanes; ++lane)
+                frame[lane] = channels[lane][sample];
+
+            const Vec v0 = Vec::fromRawArray(frame);
+            const Vec v3 = v0 - ic2eq;
+            const Vec v1 = ic1eq * a1 + v3 * a2;
+            const Vec v2 = ic2eq + ic1eq * a2 + v3 * a3;
+            ic1eq = v1 * 2.0f - ic1eq;
+            ic2eq = v2 * 2.0f - ic2eq;
+
+            (v0 * m0 + v1 * m1 + v2 * m2).copyToRawArray(frame);
+
+            for (int lane = 0; lane < lanes; ++lane)
+                channels[lane][sample] = frame[lane];
+        }
+
+        currentRootGain = targetRootGain;
+    }
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static_assert(Vec::SIMDNumElements >= static_cast<size_t>(maxChannels), "one SIMD lane per channel");
+
+    Type type = Type::lowShelf;
+    float warpedCutoff = 0.0f;
+    float damping = 2.0f;
+
+    float currentRootGain = 1.0f;
+    float targetRootGain = 1.0f;
+
+    // Trapezoidal integrator states, one lane per channel
+    Vec ic1eq = Vec::expand(0.0f);
+    Vec ic2eq = Vec::expand(0.0f);
+};
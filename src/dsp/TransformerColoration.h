@@ -1,7 +1,12 @@
 #pragma once
 
 #include <juce_dsp/juce_dsp.h>
+#include <algorithm>
 #include <cmath>
+#include "DspArena.h"
+#include "LatencyDelay.h"
+#include "TransformerHysteresis.h"
+#include "TptShelf.h"
 
 /**
  * @brief Transformer Coloration - Output Stage Character
@@ -15,34 +20,111 @@
  * harmonics which give the "iron" character.
  *
  * Controlled by the FAT parameter (0-100%).
+ *
+ * Optional hysteresis model: a Jiles-Atherton core run at 2x oversampling
+ * inside this stage only. Below hysteresisMinAmount it falls back to the
+ * memoryless curve (the core is inaudible there), crossfading over one
+ * block whenever the path changes.
+ *
+ * The oversampler is a linear-phase FIR halfband, so the core path is a pure
+ * delay of getCoreLatencySamples() apart from the coloration. While the core
+ * is enabled every other iron path (memoryless curve, bypass, iron switched
+ * off) goes through a LatencyDelay of the same length, so path changes
+ * crossfade between aligned signals and the processor can report the
+ * latency and delay the dry signal to match (no comb filtering in Mix).
+ * With the core disabled the delay is switched out and the stage has no
+ * latency; the switch crossfades over getLatencyFadeSamples().
+ *
+ * The FAT-driven shelves are TPT state-variable filters whose gain glides
+ * per sample from one block's FAT value to the next. Iron and shelves can
+ * also be run on their own (processIron(), processShelves()).
  */
 class TransformerColoration
 {
 public:
     TransformerColoration() = default;
 
-    void prepare(double newSampleRate, int samplesPerBlock)
+    /**
+     * @brief Arena space prepare() takes for the crossfade scratch
+     */
+    static size_t getArenaFloats(int samplesPerBlock)
+    {
+        return TransformerHysteresis::maxChannels * DspArena::regionFloats(static_cast<size_t>(getTransitionSize(samplesPerBlock)));
+    }
+
+    void prepare(double newSampleRate, int samplesPerBlock, DspArena& arena)
     {
         sampleRate = newSampleRate;
-        juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(samplesPerBlock), 2 };
 
-        // Low shelf for bass enhancement (~100Hz)
-        lowShelf.prepare(spec);
-        *lowShelf.state = *juce::dsp::IIR::Coefficients<float>::makeLowShelf(
-            sampleRate, 100.0f, 0.7f, 1.0f);
+        // Hysteresis core runs at 2x (linear-phase FIR halfband, integer latency)
+        oversampler.initProcessing(static_cast<size_t>(samplesPerBlock));
+        oversampler.reset();
+        hysteresis.prepare(sampleRate * static_cast<double>(oversampler.getOversamplingFactor()));
+        hysteresis.setDrive(colorAmount);
+        preparedBlockSize = juce::jmax(1, samplesPerBlock);
+        transitionSize = getTransitionSize(samplesPerBlock);
+        for (auto& channel : transitionBuffer)
+            channel = arena.allocate(static_cast<size_t>(transitionSize));
+        hysteresisActive = false;
+
+        // Every other iron path is delayed to line up with the core path,
+        // as long as the core is enabled
+        ironDelay.setDelay(juce::roundToInt(oversampler.getLatencyInSamples()));
+        ironDelay.setActive(hysteresisEnabled, 0);
+        latencyFadeSamples = juce::roundToInt(sampleRate * latencyFadeSeconds);
 
-        // High shelf for subtle HF rolloff (~8kHz)
-        highShelf.prepare(spec);
-        *highShelf.state = *juce::dsp::IIR::Coefficients<float>::makeHighShelf(
-            sampleRate, 8000.0f, 0.7f, 1.0f);
+        // Low shelf for bass enhancement, wide Q for smooth bass
+        lowShelf.prepare(sampleRate, TptShelf::Type::lowShelf, 120.0f, 0.5f);
+
+        // High shelf for subtle HF rolloff, higher freq for less darkening
+        highShelf.prepare(sampleRate, TptShelf::Type::highShelf, 8000.0f, 0.5f);
     }
 
     void reset()
+    {
+        resetIron();
+        resetShelves();
+    }
+
+    void resetIron()
+    {
+        oversampler.reset();
+        hysteresis.reset();
+        ironDelay.reset();
+        hysteresisActive = false;
+    }
+
+    /**
+     * @brief Latency of the stage in samples, the same on every path
+     * The oversampler's latency while the hysteresis core is enabled, 0 otherwise.
+     */
+    int getLatencySamples() const { return ironDelay.getLatency(); }
+
+    /**
+     * @brief Latency the stage has while the hysteresis core is enabled
+     */
+    int getCoreLatencySamples() const { return ironDelay.getDelay(); }
+
+    /**
+     * @brief Length of the crossfade when the latency switches in or out
+     */
+    int getLatencyFadeSamples() const { return latencyFadeSamples; }
+
+    void resetShelves()
     {
         lowShelf.reset();
         highShelf.reset();
     }
 
+    /**
+     * @brief Enable the Jiles-Atherton core model (falls back at low FAT)
+     */
+    void setHysteresisEnabled(bool shouldBeEnabled)
+    {
+        hysteresisEnabled = shouldBeEnabled;
+        ironDelay.setActive(hysteresisEnabled, latencyFadeSamples);
+    }
+
     /**
      * @brief Set coloration amount (0.0 to 1.0)
      * Maps from FAT parameter percentage
@@ -50,19 +132,14 @@ public:
     void setAmount(float amount)
     {
         colorAmount = juce::jlimit(0.0f, 1.0f, amount);
+        hysteresis.setDrive(colorAmount);
 
         // === TRANSFORMER MAGIC ===
         // Low shelf: moderate bass boost (up to +3dB) - subtle weight
-        float lowGainDb = colorAmount * 3.0f;
-        float lowGain = juce::Decibels::decibelsToGain(lowGainDb);
-        *lowShelf.state = *juce::dsp::IIR::Coefficients<float>::makeLowShelf(
-            sampleRate, 120.0f, 0.5f, lowGain);  // Wide Q for smooth bass
+        lowShelf.setGainDecibels(colorAmount * 3.0f);
 
         // High shelf: very subtle rolloff (up to -1.5dB) - just a touch of silk
-        float highGainDb = -colorAmount * 1.5f;
-        float highGain = juce::Decibels::decibelsToGain(highGainDb);
-        *highShelf.state = *juce::dsp::IIR::Coefficients<float>::makeHighShelf(
-            sampleRate, 8000.0f, 0.5f, highGain);  // Higher freq, less darkening
+        highShelf.setGainDecibels(-colorAmount * 1.5f);
     }
 
     /**
@@ -104,40 +181,219 @@ public:
     }
 
     /**
-     * @brief Process a stereo buffer with transformer coloration
+     * @brief Process a stereo block with transformer coloration
+     * @param block Audio to process in place (at most samplesPerBlock long)
+     */
+    void processBlock(const juce::dsp::AudioBlock<float>& block)
+    {
+        processIron(block);
+        processShelves(block);
+    }
+
+    /**
+     * @brief Iron saturation only (memoryless curve or hysteresis core)
      */
-    void processBlock(juce::AudioBuffer<float>& buffer)
+    void processIron(const juce::dsp::AudioBlock<float>& block)
     {
         if (colorAmount < 0.001f)
-            return;  // Bypass
+        {
+            processIronBypassed(block);
+            return;
+        }
 
-        // Apply subtle saturation
-        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        const auto numChannels = juce::jmin(block.getNumChannels(), static_cast<size_t>(TransformerHysteresis::maxChannels));
+        const auto numSamples = block.getNumSamples();
+        const auto core = block.getSubsetChannelBlock(0, numChannels);
+
+        const bool useHysteresis = hysteresisEnabled && colorAmount >= hysteresisMinAmount;
+
+        if (useHysteresis != hysteresisActive && numSamples <= static_cast<size_t>(transitionSize))
         {
-            auto* data = buffer.getWritePointer(channel);
-            for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+            // Path change: run both and crossfade across this block
+            if (useHysteresis)
             {
-                data[sample] = processSample(channel, data[sample]);
+                primeOversampler(numChannels);
+                hysteresis.reset();
+            }
+
+            auto transition = juce::dsp::AudioBlock<float>(transitionBuffer.data(), numChannels, numSamples);
+            transition.copyFrom(core);
+
+            processMemoryless(core);
+            processHysteresis(transition);
+
+            const float step = 1.0f / static_cast<float>(juce::jmax(static_cast<size_t>(1), numSamples));
+
+            for (size_t channel = 0; channel < numChannels; ++channel)
+            {
+                auto* data = core.getChannelPointer(channel);
+                const auto* coreData = transition.getChannelPointer(channel);
+
+                for (size_t sample = 0; sample < numSamples; ++sample)
+                {
+                    const float fade = static_cast<float>(sample + 1) * step;
+                    const float towardCore = useHysteresis ? fade : 1.0f - fade;
+                    data[sample] += towardCore * (coreData[sample] - data[sample]);
+                }
             }
         }
+        else if (useHysteresis)
+        {
+            // Keep the delay line fed so a switch back lines up at once
+            for (size_t channel = 0; channel < numChannels; ++channel)
+                ironDelay.process(channel, core.getChannelPointer(channel), transitionBuffer[channel],
+                                  juce::jmin(numSamples, static_cast<size_t>(transitionSize)));
 
-        // Apply EQ shaping (low thump, high silk)
-        auto block = juce::dsp::AudioBlock<float>(buffer);
-        auto context = juce::dsp::ProcessContextReplacing<float>(block);
-        lowShelf.process(context);
-        highShelf.process(context);
+            processHysteresis(core);
+        }
+        else
+        {
+            processMemoryless(core);
+        }
+
+        hysteresisActive = useHysteresis;
+    }
+
+    /**
+     * @brief Iron off (bypassed or switched off): only the stage's latency, if any
+     */
+    void processIronBypassed(const juce::dsp::AudioBlock<float>& block)
+    {
+        ironDelay.process(block);
+        hysteresisActive = false;
+    }
+
+    /**
+     * @brief The block's input as the iron's aligned dry path will output it
+     *
+     * Call before processIron() or processIronBypassed() on the same block;
+     * leaves the stage alone. Lets the iron be faded in or out against the
+     * signal it replaces without a jump of getLatencySamples().
+     * @param destination One buffer of block.getNumSamples() per channel
+     */
+    void copyIronDry(const juce::dsp::AudioBlock<float>& block, float* const* destination) const
+    {
+        const auto numChannels = juce::jmin(block.getNumChannels(), static_cast<size_t>(LatencyDelay::maxChannels));
+        const int numSamples = static_cast<int>(block.getNumSamples());
+        const int delay = ironDelay.getLatency();
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            if (delay > 0)
+                ironDelay.copyPending(channel, destination[channel], numSamples);
+
+            if (numSamples > delay)
+                std::copy_n(block.getChannelPointer(channel), numSamples - delay, destination[channel] + delay);
+        }
+    }
+
+    /**
+     * @brief EQ shaping only (low thump, high silk), gains glide per sample
+     */
+    void processShelves(const juce::dsp::AudioBlock<float>& block)
+    {
+        if (colorAmount < 0.001f)
+            return;  // Bypass
+
+        const auto numSamples = block.getNumSamples();
+        const auto shelfChannels = juce::jmin(block.getNumChannels(), static_cast<size_t>(TptShelf::maxChannels));
+        float* channels[TptShelf::maxChannels] {};
+        for (size_t channel = 0; channel < shelfChannels; ++channel)
+            channels[channel] = block.getChannelPointer(channel);
+
+        lowShelf.process(channels, static_cast<int>(shelfChannels), static_cast<int>(numSamples));
+        highShelf.process(channels, static_cast<int>(shelfChannels), static_cast<int>(numSamples));
     }
 
 private:
+    static int getTransitionSize(int samplesPerBlock)
+    {
+        // Also holds the delay history when priming the oversampler
+        return juce::jmax(samplesPerBlock, LatencyDelay::maxDelay, 1);
+    }
+
+    /**
+     * @brief Memoryless iron curve (the original path), delayed to line up with the core if enabled
+     */
+    void processMemoryless(const juce::dsp::AudioBlock<float>& block)
+    {
+        for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+        {
+            auto* data = block.getChannelPointer(channel);
+            for (size_t sample = 0; sample < block.getNumSamples(); ++sample)
+            {
+                data[sample] = processSample(static_cast<int>(channel), ironDelay.processSample(channel, data[sample]));
+            }
+        }
+    }
+
+    /**
+     * @brief Warm the FIR oversampler up on the input it missed while idle
+     *
+     * The delay line holds exactly the last getCoreLatencySamples() inputs; run
+     * through the filters (without the core) they leave the oversampler in
+     * nearly the state it would have had, so its first outputs are not the
+     * ramp-up of an empty FIR.
+     */
+    void primeOversampler(size_t numChannels)
+    {
+        oversampler.reset();
+
+        const int historySize = ironDelay.getDelay();
+        for (size_t channel = 0; channel < numChannels; ++channel)
+            ironDelay.copyHistory(channel, transitionBuffer[channel]);
+
+        const auto history = juce::dsp::AudioBlock<float>(transitionBuffer.data(), numChannels, static_cast<size_t>(historySize));
+        for (int start = 0; start < historySize; start += preparedBlockSize)
+        {
+            const auto length = static_cast<size_t>(juce::jmin(preparedBlockSize, historySize - start));
+            auto chunk = history.getSubBlock(static_cast<size_t>(start), length);
+            oversampler.processSamplesUp(chunk);
+            oversampler.processSamplesDown(chunk);
+        }
+    }
+
+    /**
+     * @brief Hysteresis core at 2x, blended like the memoryless curve
+     */
+    void processHysteresis(juce::dsp::AudioBlock<float> block)
+    {
+        auto upsampled = oversampler.processSamplesUp(block);
+
+        const float wetAmount = colorAmount * 0.5f;  // Max 50% wet, as the memoryless path
+        for (size_t channel = 0; channel < upsampled.getNumChannels(); ++channel)
+        {
+            auto* data = upsampled.getChannelPointer(channel);
+            for (size_t sample = 0; sample < upsampled.getNumSamples(); ++sample)
+            {
+                const float input = data[sample];
+                const float coreOut = hysteresis.processSample(static_cast<int>(channel), input);
+                data[sample] = input + wetAmount * (coreOut - input);
+            }
+        }
+
+        oversampler.processSamplesDown(block);
+    }
+
     double sampleRate = 44100.0;
     float colorAmount = 0.0f;
 
-    // EQ for transformer character
-    juce::dsp::ProcessorDuplicator<
-        juce::dsp::IIR::Filter<float>,
-        juce::dsp::IIR::Coefficients<float>> lowShelf;
+    // Hysteresis model (optional)
+    static constexpr float hysteresisMinAmount = 0.25f;  // below this the memoryless curve is used
+    bool hysteresisEnabled = false;
+    bool hysteresisActive = false;
+    TransformerHysteresis hysteresis;
+    juce::dsp::Oversampling<float> oversampler {
+        static_cast<size_t>(TransformerHysteresis::maxChannels), 1,
+        juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple, false, true };
+    LatencyDelay ironDelay;   // memoryless/bypass paths, same latency as the oversampler
+    static constexpr double latencyFadeSeconds = 0.005;
+    int latencyFadeSamples = 0;
+    std::array<float*, TransformerHysteresis::maxChannels> transitionBuffer {};  // arena regions
+    int transitionSize = 0;
+    int preparedBlockSize = 1;
 
-    juce::dsp::ProcessorDuplicator<
-        juce::dsp::IIR::Filter<float>,
-        juce::dsp::IIR::Coefficients<float>> highShelf;
+    // EQ for transformer character (modulation-safe SVF shelves)
+    TptShelf lowShelf;
+    TptShelf highShelf;
 };
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <cmath>
+
+/**
+ * @brief Jiles-Atherton Transformer Core Model
+ *
+ * Magnetic hysteresis for the optional "iron" model of TransformerColoration:
+ *
+ *   voltage → flux (leaky integrator) → H → JA magnetisation M → d/dt → voltage
+ *
+ * Integrating the input before the core means low frequencies drive the
+ * core harder than highs, which is where real output transformers
+ * saturate. The differentiator is the exact inverse of the integrator, so
+ * in the linear region the stage is transparent (after calibration).
+ *
+ * M is advanced with a fixed two-stage Runge-Kutta (midpoint) step per
+ * sample on dM/dH, so the cost per sample is constant: two model
+ * evaluations, one tanh each.
+ *
+ * Runs at the (oversampled) rate it is prepared with; TransformerColoration
+ * owns the oversampling.
+ */
+class TransformerHysteresis
+{
+public:
+    static constexpr int maxChannels = 2;
+
+    TransformerHysteresis() = default;
+
+    void prepare(double processingSampleRate)
+    {
+        // Flux integrator: unity magnitude at the reference frequency,
+        // leaking below ~10 Hz so DC never builds up in the core
+        const double omega = juce::MathConstants<double>::twoPi / processingSampleRate;
+        integratorGain = static_cast<float>(omega * referenceHz);
+        integratorLeak = static_cast<float>(std::exp(-omega * leakHz));
+
+        calibrate(processingSampleRate);
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto* state : { &fieldState, &magnetisationState, &previousMagnetisation })
+            state->fill(0.0f);
+    }
+
+    /**
+     * @brief Set core drive (0.0 to 1.0), from the coloration amount
+     */
+    void setDrive(float driveAmount)
+    {
+        fieldScale = 0.15f + juce::jlimit(0.0f, 1.0f, driveAmount) * 0.6f;
+        outputScale = calibratedGain / fieldScale;  // linear region stays at unity
+    }
+
+    /**
+     * @brief Process one sample of one channel through the core
+     */
+    inline float processSample(int channel, float input)
+    {
+        const auto ch = static_cast<size_t>(channel);
+
+        // Voltage → flux → field strength
+        const float previousField = fieldState[ch];
+        const float field = integratorLeak * previousField + integratorGain * fieldScale * input;
+        const float deltaField = field - previousField;
+        fieldState[ch] = field;
+
+        // Fixed-cost RK2 (midpoint) step on dM/dH
+        float m = magnetisationState[ch];
+        const float k1 = magnetisationSlope(m, previousField, deltaField) * deltaField;
+        const float k2 = magnetisationSlope(m + 0.5f * k1, previousField + 0.5f * deltaField, deltaField) * deltaField;
+        m += k2;
+
+        if (!std::isfinite(m))
+            m = 0.0f;  // never let a bad step poison the core state
+
+        magnetisationState[ch] = m;
+
+        // Flux → voltage (exact inverse of the integrator)
+        const float output = (m - integratorLeak * previousMagnetisation[ch]) * outputScale;
+        previousMagnetisation[ch] = m;
+        return output;
+    }
+
+private:
+    /**
+     * @brief Jiles-Atherton dM/dH for the direction of travel of H
+     */
+    static inline float magnetisationSlope(float m, float h, float deltaField)
+    {
+        const float q = (h + alpha * m) / shapeA;
+
+        // Langevin function L(q) = coth(q) - 1/q and its derivative
+        float langevin, langevinSlope;
+        if (std::abs(q) < 1.0e-3f)
+        {
+            langevin = q / 3.0f;
+            langevinSlope = 1.0f / 3.0f;
+        }
+        else
+        {
+            const float coth = 1.0f / std::tanh(q);
+            langevin = coth - 1.0f / q;
+            langevinSlope = 1.0f / (q * q) - coth * coth + 1.0f;
+        }
+
+        const float anhystereticDiff = saturation * langevin - m;
+        const float direction = deltaField >= 0.0f ? 1.0f : -1.0f;
+        const float pinning = (direction > 0.0f) == (anhystereticDiff > 0.0f) ? 1.0f : 0.0f;
+
+        float irreversibleDen = (1.0f - reversibility) * direction * pinningK - alpha * anhystereticDiff;
+        if (std::abs(irreversibleDen) < 1.0e-6f)
+            irreversibleDen = irreversibleDen < 0.0f ? -1.0e-6f : 1.0e-6f;
+
+        const float irreversible = (1.0f - reversibility) * pinning * anhystereticDiff / irreversibleDen;
+        const float reversible = reversibility * saturation / shapeA * langevinSlope;
+        const float coupling = 1.0f - reversibility * alpha * saturation / shapeA * langevinSlope;
+
+        return (irreversible + reversible) / coupling;
+    }
+
+    /**
+     * @brief Measure small-signal gain so quiet material passes at unity
+     */
+    void calibrate(double processingSampleRate)
+    {
+        calibratedGain = 1.0f;
+        setDrive(0.0f);
+        reset();
+
+        const int numSamples = static_cast<int>(processingSampleRate * 0.05);
+        const double omega = juce::MathConstants<double>::twoPi * 1000.0 / processingSampleRate;
+        double inputEnergy = 0.0, outputEnergy = 0.0;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto input = static_cast<float>(0.03 * std::sin(omega * i));
+            const float output = processSample(0, input);
+
+            if (i >= numSamples / 2)
+            {
+                inputEnergy += static_cast<double>(input * input);
+                outputEnergy += static_cast<double>(output * output);
+            }
+        }
+
+        calibratedGain = outputEnergy > 0.0 ? static_cast<float>(std::sqrt(inputEnergy / outputEnergy)) : 1.0f;
+        setDrive(0.0f);
+    }
+
+    // Jiles-Atherton core (normalised units)
+    static constexpr float saturation = 1.0f;       // Ms
+    static constexpr float shapeA = 0.25f;          // a: anhysteretic shape
+    static constexpr float alpha = 1.0e-3f;         // inter-domain coupling
+    static constexpr float pinningK = 0.3f;         // k: loop width
+    static constexpr float reversibility = 0.7f;    // c: reversible fraction
+
+    static constexpr double referenceHz = 100.0;    // integrator unity-gain frequency
+    static constexpr double leakHz = 10.0;
+
+    float integratorGain = 0.01f;
+    float integratorLeak = 0.999f;
+    float fieldScale = 0.4f;
+    float calibratedGain = 1.0f;
+    float outputScale = 1.0f;
+
+    std::array<float, maxChannels> fieldState {};
+    std::array<float, maxChannels> magnetisationState {};
+    std::array<float, maxChannels> previousMagnetisation {};
+};
@@ -0,0 +1,309 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <cmath>
+
+/**
+ * @brief Wave-Digital Triode Stage (12AX7 common-cathode)
+ *
+ * A physically modelled tube stage for the premium "Triode" tube mode:
+ *
+ *     Vb ── Rp ──┬── plate (output)
+ *                │
+ *              triode ◄── Rg ── grid (input)
+ *                │
+ *                ├── cathode
+ *              Rk ║ Ck (bypass)
+ *                │
+ *               GND
+ *
+ * The linear part is a wave-digital tree: the plate load is a resistive
+ * voltage source and the cathode is a parallel adaptor of Rk and a
+ * trapezoidal (WDF) capacitor. Seen from the triode both sub-trees are
+ * Thevenin equivalents, which reduces the nonlinear root to one unknown,
+ * the plate current Ip:
+ *
+ *   Ip = Koren(Vpk = a - (Rp + Rcat) * Ip,  Vgk = Vg - bcat - Rcat * Ip)
+ *
+ * The root is found with a fixed number of Newton iterations (analytic
+ * Jacobian, warm-started from the previous sample), so the cost per sample
+ * is constant.
+ *
+ * Grid current: at high FAT the grid swings several volts, well past the
+ * bias point, and a real grid conducts once it goes positive of the
+ * cathode. The grid is fed through Rg (driver output plus grid stopper) and
+ * draws current per Dempwolf's 12AX7 grid law, so positive peaks flatten
+ * against Vgk ≈ 0 (grid clipping). The grid node is solved first, against
+ * the cathode voltage of the previous sample, and its current then flows
+ * through the cathode with the plate current. It costs nothing while the
+ * grid stays below gridOnsetV.
+ *
+ * All channels are stepped together in lane arrays. The lanes are not SIMD:
+ * each Newton step needs exp/log1p/pow per lane, which SIMDRegister has no
+ * vector form of, and there are at most two lanes. Their dependency chains
+ * are independent, so the compiler interleaves them instead.
+ *
+ * Output is the AC plate voltage, inverted and normalised by the
+ * small-signal gain so quiet material passes at unity.
+ */
+class TriodeStage
+{
+public:
+    static constexpr int maxChannels = 2;
+
+    TriodeStage() = default;
+
+    void prepare(double newSampleRate, int /*samplesPerBlock*/)
+    {
+        sampleRate = newSampleRate;
+
+        // Cathode parallel adaptor: Rk || Ck (trapezoidal capacitor port)
+        const double capacitorR = 1.0 / (2.0 * sampleRate * cathodeC);
+        const double gk = 1.0 / cathodeR;
+        const double gc = 1.0 / capacitorR;
+        cathodePortR = 1.0 / (gk + gc);
+        capacitorWeight = gc / (gk + gc);
+        loopR = plateR + cathodePortR;
+
+        computeOperatingPoint();
+        reset();
+    }
+
+    void reset()
+    {
+        for (int lane = 0; lane < maxChannels; ++lane)
+        {
+            plateCurrent[static_cast<size_t>(lane)] = quiescentCurrent;
+            gridCurrent[static_cast<size_t>(lane)] = 0.0;
+            capacitorState[static_cast<size_t>(lane)] = quiescentCathodeV;  // settled bypass cap
+        }
+    }
+
+    /**
+     * @brief Set drive amount (0.0 to 1.0)
+     * Maps from FAT parameter percentage
+     */
+    void setDrive(float driveAmount)
+    {
+        drive = juce::jlimit(0.0f, 1.0f, driveAmount);
+        gridGain = 0.5 + static_cast<double>(drive) * 3.5;  // volts at the grid per full-scale
+        outputScale = -1.0 / (gridGain * smallSignalGain);
+    }
+
+    /**
+     * @brief Process up to maxChannels channels in lockstep
+     */
+    void process(float* const* channels, int numChannels, int numSamples)
+    {
+        const int lanes = juce::jmin(numChannels, maxChannels);
+        const float wet = drive;
+        const float dry = 1.0f - drive;
+
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            for (int lane = 0; lane < lanes; ++lane)
+            {
+                const auto l = static_cast<size_t>(lane);
+                const float input = channels[lane][sample];
+
+                // Waves reflected by the linear sub-trees toward the triode
+                const double cathodeB = capacitorWeight * capacitorState[l];
+                const double incident = supplyV - cathodeB;
+                const double drivenV = static_cast<double>(input) * gridGain;
+
+                // Grid node first, against last sample's cathode voltage
+                double ip = plateCurrent[l];
+                const double ig = solveGridCurrent(drivenV - cathodeB - cathodePortR * (ip + gridCurrent[l]));
+                gridCurrent[l] = ig;
+                const double gridV = drivenV - gridR * ig;
+
+                // Fixed-iteration Newton on the plate current
+                for (int iteration = 0; iteration < newtonIterations; ++iteration)
+                {
+                    const double vpk = incident - loopR * ip;
+                    const double vgk = gridV - cathodeB - cathodePortR * (ip + ig);
+
+                    double dIdVpk = 0.0, dIdVgk = 0.0;
+                    const double model = koren(vpk, vgk, dIdVpk, dIdVgk);
+
+                    const double residual = ip - model;
+                    const double slope = 1.0 + dIdVpk * loopR + dIdVgk * cathodePortR;
+                    ip = juce::jlimit(0.0, maxCurrent, ip - residual / slope);
+                }
+                plateCurrent[l] = ip;
+
+                // Scatter back: cathode node voltage updates the capacitor
+                const double cathodeV = cathodeB + cathodePortR * (ip + ig);
+                capacitorState[l] = 2.0 * cathodeV - capacitorState[l];
+
+                const double plateV = supplyV - plateR * ip;
+                const auto triode = static_cast<float>((plateV - quiescentPlateV) * outputScale);
+
+                channels[lane][sample] = input * dry + triode * wet;
+            }
+        }
+    }
+
+private:
+    /**
+     * @brief Koren 12AX7 plate current with partial derivatives
+     */
+    static double koren(double vpk, double vgk, double& dIdVpk, double& dIdVgk)
+    {
+        dIdVpk = 0.0;
+        dIdVgk = 0.0;
+
+        if (vpk <= 0.0)
+            return 0.0;
+
+        const double root = std::sqrt(korenKvb + vpk * vpk);
+        const double z = korenKp * (1.0 / korenMu + vgk / root);
+
+        // Numerically safe softplus and its derivative (logistic)
+        const double ez = std::exp(-std::abs(z));
+        const double softplus = juce::jmax(z, 0.0) + std::log1p(ez);
+        const double logistic = z >= 0.0 ? 1.0 / (1.0 + ez) : ez / (1.0 + ez);
+
+        const double e1 = vpk / korenKp * softplus;
+        if (e1 <= 1.0e-12)
+            return 0.0;
+
+        const double current = std::pow(e1, korenEx) / korenKg1;
+        const double dIdE1 = korenEx * current / e1;
+
+        dIdVgk = dIdE1 * vpk * logistic / root;
+        dIdVpk = dIdE1 * (softplus / korenKp - vpk * vpk * vgk * logistic / (root * root * root));
+        return current;
+    }
+
+    /**
+     * @brief Grid current for an open-circuit grid-cathode voltage (no current flowing)
+     *
+     * Solves vgk + Rg * Ig(vgk) = openVgk with a few Newton steps; Ig is
+     * monotonic and convex, so starting from openVgk converges from above.
+     */
+    static double solveGridCurrent(double openVgk)
+    {
+        if (openVgk < gridOnsetV)
+            return 0.0;
+
+        double vgk = openVgk;
+        double current = 0.0, slope = 0.0;
+        for (int iteration = 0; iteration < gridIterations; ++iteration)
+        {
+            current = dempwolfGrid(vgk, slope);
+            vgk -= (vgk + gridR * current - openVgk) / (1.0 + gridR * slope);
+        }
+
+        return dempwolfGrid(vgk, slope);
+    }
+
+    /**
+     * @brief Dempwolf 12AX7 grid current with its derivative
+     * Ig = Gg * (ln(1 + e^(Cg * Vgk)) / Cg)^xi
+     */
+    static double dempwolfGrid(double vgk, double& dIdVgk)
+    {
+        const double z = gridCg * vgk;
+        const double ez = std::exp(-std::abs(z));
+        const double softplus = (juce::jmax(z, 0.0) + std::log1p(ez)) / gridCg;
+        const double logistic = z >= 0.0 ? 1.0 / (1.0 + ez) : ez / (1.0 + ez);
+
+        if (softplus <= 1.0e-12)
+        {
+            dIdVgk = 0.0;
+            return 0.0;
+        }
+
+        const double current = gridGg * std::pow(softplus, gridXi);
+        dIdVgk = gridXi * current / softplus * logistic;
+        return current;
+    }
+
+    /**
+     * @brief DC bias point and small-signal gain (bypass cap treated as short)
+     */
+    void computeOperatingPoint()
+    {
+        // DC: capacitor open, full Rk in the loop
+        const double ip = solveStatic(0.0, cathodeR, 0.0, 1.0e-3);
+
+        quiescentCurrent = ip;
+        quiescentCathodeV = cathodeR * ip;
+        quiescentPlateV = supplyV - plateR * ip;
+
+        // AC: cathode held at its bias voltage
+        const double delta = 1.0e-3;
+        const double ipUp = solveStatic(delta, 0.0, quiescentCathodeV, ip);
+        const double ipDown = solveStatic(-delta, 0.0, quiescentCathodeV, ip);
+        smallSignalGain = plateR * (ipUp - ipDown) / (2.0 * delta);
+
+        setDrive(drive);
+    }
+
+    /**
+     * @brief Newton solve of Ip for a static circuit (prepare only, not real-time)
+     */
+    static double solveStatic(double gridV, double seriesCathodeR, double fixedCathodeV, double ip)
+    {
+        for (int iteration = 0; iteration < 50; ++iteration)
+        {
+            const double cathodeV = fixedCathodeV + seriesCathodeR * ip;
+            const double vpk = supplyV - plateR * ip - cathodeV;
+            const double vgk = gridV - cathodeV;
+
+            double dIdVpk = 0.0, dIdVgk = 0.0;
+            const double model = koren(vpk, vgk, dIdVpk, dIdVgk);
+            const double slope = 1.0 + dIdVpk * (plateR + seriesCathodeR) + dIdVgk * seriesCathodeR;
+            ip = juce::jlimit(0.0, maxCurrent, ip - (ip - model) / slope);
+        }
+        return ip;
+    }
+
+    double sampleRate = 44100.0;
+    float drive = 0.0f;
+
+    // Circuit (classic 12AX7 gain stage)
+    static constexpr double supplyV = 250.0;
+    static constexpr double plateR = 100.0e3;
+    static constexpr double cathodeR = 1.5e3;
+    static constexpr double cathodeC = 22.0e-6;
+    static constexpr double maxCurrent = supplyV / plateR;
+
+    // Koren 12AX7 constants
+    static constexpr double korenMu = 100.0;
+    static constexpr double korenEx = 1.4;
+    static constexpr double korenKg1 = 1060.0;
+    static constexpr double korenKp = 600.0;
+    static constexpr double korenKvb = 300.0;
+
+    static constexpr int newtonIterations = 3;
+
+    // Grid: source resistance and Dempwolf grid-current constants
+    static constexpr double gridR = 68.0e3;
+    static constexpr double gridGg = 6.06e-4;
+    static constexpr double gridXi = 1.354;
+    static constexpr double gridCg = 13.9;
+    static constexpr double gridOnsetV = -0.6;   // Ig < 1 nA below this, skipped
+    static constexpr int gridIterations = 6;
+
+    // Wave-digital port resistances
+    double cathodePortR = 1.0;
+    double capacitorWeight = 1.0;
+    double loopR = plateR;
+
+    // Operating point
+    double quiescentCurrent = 0.0;
+    double quiescentCathodeV = 0.0;
+    double quiescentPlateV = supplyV;
+    double smallSignalGain = 1.0;
+
+    double gridGain = 0.5;
+    double outputScale = -1.0;
+
+    // Per-channel lanes
+    std::array<double, maxChannels> plateCurrent {};
+    std::array<double, maxChannels> capacitorState {};
+    std::array<double, maxChannels> gridCurrent {};
+};
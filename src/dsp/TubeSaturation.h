@@ -2,6 +2,12 @@
 
 #include <juce_dsp/juce_dsp.h>
 #include <cmath>
+#include "Biquad.h"
+#include "DspArena.h"
+#include "LinearCrossfade.h"
+#include "WaveshaperTable.h"
+#include "ChebyshevHarmonics.h"
+#include "TriodeStage.h"
 
 /**
  * @brief Tube Saturation with Even-Order Harmonics
@@ -16,29 +22,75 @@
  * (which sound more "edgy" or "harsh").
  *
  * Controlled by the FAT parameter (0-100%).
+ *
+ * The per-sample curve is baked into a lookup table for the current drive;
+ * tables are rebuilt on a background thread when FAT moves and crossfaded.
+ *
+ * Modes:
+ * - Classic:  asymmetric tanh curve (baked table)
+ * - Harmonic: Chebyshev synthesis with calibrated 2nd/3rd/4th/6th levels
+ * - Triode:   wave-digital 12AX7 gain stage (premium, highest CPU)
+ *
+ * Mode changes run the old and the new waveshaper side by side for a few
+ * milliseconds and crossfade between them, like the table hand-off.
  */
 class TubeSaturation
 {
 public:
+    enum class Mode
+    {
+        classic = 0,
+        harmonic,
+        triode
+    };
+
     TubeSaturation() = default;
 
-    void prepare(double newSampleRate, int samplesPerBlock)
+    /**
+     * @brief Arena space prepare() takes for the band scratch buffers
+     */
+    static size_t getArenaFloats(int samplesPerBlock)
+    {
+        return numBands * Biquad::maxChannels * DspArena::regionFloats(static_cast<size_t>(juce::jmax(1, samplesPerBlock)));
+    }
+
+    void prepare(double newSampleRate, int samplesPerBlock, DspArena& arena)
     {
         sampleRate = newSampleRate;
 
-        juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(samplesPerBlock), 2 };
+        using Coefficients = juce::dsp::IIR::ArrayCoefficients<float>;
 
         // DC blocker to remove offset from asymmetric waveshaping
-        dcBlocker.prepare(spec);
-        *dcBlocker.state = *juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 5.0f);
+        dcBlocker.setCoefficients(Coefficients::makeHighPass(sampleRate, 5.0f));
 
         // Low-pass filter for saturation sidechain - focus warmth on lows
-        lowpassForSat.prepare(spec);
-        *lowpassForSat.state = *juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, 800.0f);
+        lowpassForSat.setCoefficients(Coefficients::makeLowPass(sampleRate, 800.0f));
 
         // Highpass to extract highs that bypass saturation
-        highpassForClean.prepare(spec);
-        *highpassForClean.state = *juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 600.0f);
+        highpassForClean.setCoefficients(Coefficients::makeHighPass(sampleRate, 600.0f));
+
+        dcBlocker.reset();
+        lowpassForSat.reset();
+        highpassForClean.reset();
+
+        // Band filter responses at the calibration frequency (see updateHarmonics)
+        lowpassResponse = lowpassForSat.getResponse(calibrationFrequency, sampleRate);
+        highpassResponse = highpassForClean.getResponse(calibrationFrequency, sampleRate);
+        dcBlockerResponse = dcBlocker.getResponse(calibrationFrequency, sampleRate);
+        updateHarmonics();
+
+        // Bake the transfer curve for the current drive before audio starts
+        curveTables.prepare(sampleRate, &TubeSaturation::transferCurve, SharedTableCache::Type::tubeCurve, drive);
+
+        triode.prepare(sampleRate, samplesPerBlock);
+
+        // Band scratch buffers, carved from the arena so processing never allocates
+        bandSize = juce::jmax(1, samplesPerBlock);
+        for (auto* band : { &lowBand, &highBand, &fadeBand })
+            for (auto& channel : *band)
+                channel = arena.allocate(static_cast<size_t>(bandSize));
+
+        modeFade.prepare(sampleRate);
     }
 
     void reset()
@@ -46,6 +98,8 @@ public:
         dcBlocker.reset();
         lowpassForSat.reset();
         highpassForClean.reset();
+        triode.reset();
+        modeFade.stop();
     }
 
     /**
@@ -57,12 +111,47 @@ public:
         drive = juce::jlimit(0.0f, 1.0f, driveAmount);
         // Gentle drive - 100% FAT = subtle warmth, not aggressive
         driveScaled = 1.0f + drive * 3.0f;  // Up to 4x max
+
+        // Rebuilt in the background, picked up at the next block
+        curveTables.requestDrive(drive);
+        updateHarmonics();
+        triode.setDrive(drive);
     }
 
+    /**
+     * @brief Select the waveshaper used on the low band
+     * Once prepared, the change is crossfaded; a change mid-fade restarts the
+     * fade from the mode that was selected last.
+     */
+    void setMode(Mode newMode)
+    {
+        if (newMode == mode)
+            return;
+
+        if (bandSize > 0)
+        {
+            fadeFromMode = mode;
+            modeFade.start();
+
+            // Entering triode: start from a settled circuit, not from wherever it was left
+            if (newMode == Mode::triode)
+                triode.reset();
+        }
+
+        mode = newMode;
+    }
+
+    Mode getMode() const { return mode; }
+
+    /**
+     * @brief Baked classic-mode curves (session capture/replay hooks)
+     */
+    WaveshaperTableSet& getCurveTables() { return curveTables; }
+
     /**
      * @brief Soft saturation curve - continuous and smooth
      */
-    inline float softSaturate(float x, float amount) const
+    static inline float softSaturate(float x, float amount)
     {
         // Soft polynomial saturation - no discontinuities
         // At low levels: nearly linear. At high levels: gentle compression
@@ -73,18 +162,16 @@ public:
     }
 
     /**
-     * @brief Process a single sample with tube saturation
+     * @brief Static tube transfer curve for a given drive
      * @param input Input sample
-     * @return Saturated output sample
+     * @param curveDrive Saturation amount (0.0 to 1.0)
+     * @return Saturated output sample (including wet/dry blend)
      */
-    float processSample(float input)
+    static float transferCurve(float input, float curveDrive)
     {
-        if (drive < 0.001f)
-            return input;
-
         // === WARM TUBE SATURATION ===
         // Gentle drive - avoid harsh overdriving
-        float x = input * (1.0f + drive * 1.5f);  // Max 2.5x gain
+        float x = input * (1.0f + curveDrive * 1.5f);  // Max 2.5x gain
 
         // Asymmetric waveshaping - key to even harmonics (warm, not harsh)
         // Use smooth tanh with controlled input levels
@@ -94,73 +181,96 @@ public:
         float asymmetry = 0.0f;
         if (x < 0.0f)
         {
-            asymmetry = x * std::abs(x) * 0.08f * drive;  // Subtle 2nd harmonic
+            asymmetry = x * std::abs(x) * 0.08f * curveDrive;  // Subtle 2nd harmonic
         }
 
         float output = tanhInput + asymmetry;
 
         // Add gentle even harmonics (2nd) - the "butter"
         // Apply BEFORE saturation, then saturate the result
-        float harmonic = input * std::abs(input) * 0.15f * drive;
+        float harmonic = input * std::abs(input) * 0.15f * curveDrive;
         output += harmonic;
 
         // Final soft saturation to keep everything smooth
-        output = softSaturate(output, 0.3f + drive * 0.5f);
+        output = softSaturate(output, 0.3f + curveDrive * 0.5f);
 
         // Gain compensation - keep levels consistent
-        output *= 0.85f / (1.0f + drive * 0.3f);
+        output *= 0.85f / (1.0f + curveDrive * 0.3f);
 
         // Wet/dry blend
-        return input * (1.0f - drive) + output * drive;
+        return input * (1.0f - curveDrive) + output * curveDrive;
     }
 
     /**
-     * @brief Process a stereo buffer with tube saturation
+     * @brief Process a single sample with tube saturation
+     * Evaluates the curve directly (reference path, the block path uses the table)
+     * @param input Input sample
+     * @return Saturated output sample
+     */
+    float processSample(float input) const
+    {
+        if (drive < 0.001f)
+            return input;
+
+        return transferCurve(input, drive);
+    }
+
+    /**
+     * @brief Process a stereo block with tube saturation
      * Uses multiband approach: saturate lows, keep highs clean
+     * @param block Audio to process in place (at most samplesPerBlock long)
      */
-    void processBlock(juce::AudioBuffer<float>& buffer)
+    void processBlock(const juce::dsp::AudioBlock<float>& block)
     {
         if (drive < 0.001f)
             return;  // Bypass
 
-        const int numSamples = buffer.getNumSamples();
-        const int numChannels = buffer.getNumChannels();
-
-        // Create temp buffers for multiband processing
-        juce::AudioBuffer<float> lowBand(numChannels, numSamples);
-        juce::AudioBuffer<float> highBand(numChannels, numSamples);
+        const auto numChannels = juce::jmin(block.getNumChannels(), static_cast<size_t>(Biquad::maxChannels));
+        const auto numSamples = block.getNumSamples();
+        jassert(numSamples <= static_cast<size_t>(bandSize));
 
-        // Copy to both bands
-        for (int ch = 0; ch < numChannels; ++ch)
-        {
-            lowBand.copyFrom(ch, 0, buffer, ch, 0, numSamples);
-            highBand.copyFrom(ch, 0, buffer, ch, 0, numSamples);
-        }
+        // Copy to both bands (scratch buffers allocated in prepare)
+        auto input = block.getSubsetChannelBlock(0, numChannels);
+        auto lowBlock = juce::dsp::AudioBlock<float>(lowBand.data(), numChannels, numSamples);
+        auto highBlock = juce::dsp::AudioBlock<float>(highBand.data(), numChannels, numSamples);
+        lowBlock.copyFrom(input);
+        highBlock.copyFrom(input);
 
         // Filter: extract lows (<800Hz) and highs (>600Hz)
-        auto lowBlock = juce::dsp::AudioBlock<float>(lowBand);
-        auto highBlock = juce::dsp::AudioBlock<float>(highBand);
-        lowpassForSat.process(juce::dsp::ProcessContextReplacing<float>(lowBlock));
-        highpassForClean.process(juce::dsp::ProcessContextReplacing<float>(highBlock));
+        lowpassForSat.process(lowBlock);
+        highpassForClean.process(highBlock);
 
         // Saturate ONLY the low band - this is where the "belly" lives
-        for (int channel = 0; channel < numChannels; ++channel)
+        // (tables keep tracking FAT in every mode so switching back is seamless)
+        curveTables.beginBlock();
+        if (modeFade.isActive())
         {
-            auto* lowData = lowBand.getWritePointer(channel);
-            for (int sample = 0; sample < numSamples; ++sample)
-            {
-                lowData[sample] = processSample(lowData[sample]);
-            }
+            // Old mode on a copy, new mode in place, then glide between them
+            const int fadeSamples = modeFade.getFadeSamples(static_cast<int>(numSamples));
+            juce::dsp::AudioBlock<float>(fadeBand.data(), numChannels, numSamples).copyFrom(lowBlock);
+
+            shapeLowBand(fadeFromMode, fadeBand, numChannels, numSamples);
+            shapeLowBand(mode, lowBand, numChannels, numSamples);
+
+            for (size_t channel = 0; channel < numChannels; ++channel)
+                modeFade.blend(fadeBand[channel], lowBand[channel], fadeSamples);
+
+            modeFade.advance(static_cast<int>(numSamples));
         }
+        else
+        {
+            shapeLowBand(mode, lowBand, numChannels, numSamples);
+        }
+        curveTables.endBlock(static_cast<int>(numSamples));
 
         // Recombine: saturated lows + clean highs (with crossfade zone)
-        for (int ch = 0; ch < numChannels; ++ch)
+        for (size_t ch = 0; ch < numChannels; ++ch)
         {
-            auto* outData = buffer.getWritePointer(ch);
-            const auto* lowData = lowBand.getReadPointer(ch);
-            const auto* highData = highBand.getReadPointer(ch);
+            auto* outData = input.getChannelPointer(ch);
+            const auto* lowData = lowBlock.getChannelPointer(ch);
+            const auto* highData = highBlock.getChannelPointer(ch);
 
-            for (int sample = 0; sample < numSamples; ++sample)
+            for (size_t sample = 0; sample < numSamples; ++sample)
             {
                 // Blend: full saturated lows + reduced highs (to avoid phasing)
                 outData[sample] = lowData[sample] + highData[sample] * (1.0f - drive * 0.3f);
@@ -168,27 +278,81 @@ public:
         }
 
         // Remove DC offset
-        auto block = juce::dsp::AudioBlock<float>(buffer);
-        dcBlocker.process(juce::dsp::ProcessContextReplacing<float>(block));
+        dcBlocker.process(input);
     }
 
 private:
+    using Band = std::array<float*, Biquad::maxChannels>;
+
+    static constexpr int numBands = 3;                    // low, high, outgoing mode during a fade
+    static constexpr double calibrationFrequency = 100.0; // harmonic levels hold exactly here
+
+    /**
+     * @brief Run one waveshaper over a band in place
+     */
+    void shapeLowBand(Mode shaperMode, Band& band, size_t numChannels, size_t numSamples)
+    {
+        if (shaperMode == Mode::triode)
+        {
+            // Channels stepped together through the triode solver
+            triode.process(band.data(), static_cast<int>(numChannels), static_cast<int>(numSamples));
+            return;
+        }
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            if (shaperMode == Mode::harmonic)
+                harmonics.processBlock(band[channel], static_cast<int>(numSamples));
+            else
+                curveTables.process(band[channel], static_cast<int>(numSamples));
+        }
+    }
+
+    /**
+     * @brief Calibrate Harmonic mode against the whole stage, not just the shaper
+     *
+     * The shaper sees the fundamental through the low-pass (inputGain), and
+     * the output fundamental is the low and high bands recombined through the
+     * DC blocker (fundamentalGain, which depends on drive through the high-band
+     * trim). Both are taken at calibrationFrequency; the generated harmonics
+     * only pass the DC blocker, which is flat above it.
+     */
+    void updateHarmonics()
+    {
+        const auto highTrim = static_cast<double>(1.0f - drive * 0.3f);
+        const auto fundamentalGain = std::abs((lowpassResponse + highTrim * highpassResponse) * dcBlockerResponse);
+
+        harmonics.setDrive(drive, static_cast<float>(fundamentalGain), static_cast<float>(std::abs(lowpassResponse)));
+    }
+
     double sampleRate = 44100.0;
 
     float drive = 0.0f;         // 0.0 to 1.0
+    Mode mode = Mode::classic;
+    Mode fadeFromMode = Mode::classic;
+    LinearCrossfade modeFade;
     float driveScaled = 1.0f;   // 1.0 to 16.0
 
     // DC blocker (highpass at 5Hz)
-    juce::dsp::ProcessorDuplicator<
-        juce::dsp::IIR::Filter<float>,
-        juce::dsp::IIR::Coefficients<float>> dcBlocker;
+    Biquad dcBlocker;
 
     // Multiband filters for "belly" focused saturation
-    juce::dsp::ProcessorDuplicator<
-        juce::dsp::IIR::Filter<float>,
-        juce::dsp::IIR::Coefficients<float>> lowpassForSat;   // Extract lows for saturation
+    Biquad lowpassForSat;     // Extract lows for saturation
+    Biquad highpassForClean;  // Extract highs to keep clean
+    std::complex<double> lowpassResponse { 1.0 }, highpassResponse { 0.0 }, dcBlockerResponse { 1.0 };
+
+    // Multiband scratch (regions of the processor's arena)
+    Band lowBand {};
+    Band highBand {};
+    Band fadeBand {};
+    int bandSize = 0;
+
+    // Baked transfer curves (background rebuild + crossfade)
+    WaveshaperTableSet curveTables;
+
+    // Calibrated harmonic synthesis (Harmonic mode)
+    ChebyshevHarmonics harmonics;
 
-    juce::dsp::ProcessorDuplicator<
-        juce::dsp::IIR::Filter<float>,
-        juce::dsp::IIR::Coefficients<float>> highpassForClean; // Extract highs to keep clean
+    // Wave-digital triode (Triode mode)
+    TriodeStage triode;
 };
@@ -0,0 +1,448 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "LinearCrossfade.h"
+#include "SharedTableCache.h"
+
+/**
+ * @brief Baked Static Transfer Curve
+ *
+ * Samples a memoryless waveshaper once into a high-resolution table so the
+ * audio thread only pays for a cubic (Catmull-Rom) interpolation per sample
+ * instead of tanh, divisions and blends.
+ *
+ * Inputs outside [-inputRange, inputRange] are extrapolated linearly using
+ * the slope of the curve at the table edge. NaN input gives 0.
+ */
+class WaveshaperTable
+{
+public:
+    using CurveFunction = float (*)(float input, float drive);
+
+    static constexpr int tableSize = 4096;
+    static constexpr float inputRange = 4.0f;   // ±4.0 (~ +12 dBFS) covers any sane input
+
+    /**
+     * @brief Bake the curve for a given drive (not real-time safe, runs off the audio thread)
+     */
+    void build(CurveFunction curve, float forDrive)
+    {
+        drive = forDrive;
+
+        // points[0] and points[tableSize + 1] are guard points for the cubic
+        for (int i = 0; i < tableSize + 2; ++i)
+            points[static_cast<size_t>(i)] = curve(indexToInput(i - 1), forDrive);
+
+        const float edgeDelta = 1.0e-3f;
+        slopeLow = (curve(-inputRange + edgeDelta, forDrive) - curve(-inputRange, forDrive)) / edgeDelta;
+        slopeHigh = (curve(inputRange, forDrive) - curve(inputRange - edgeDelta, forDrive)) / edgeDelta;
+    }
+
+    /**
+     * @brief Evaluate the baked curve
+     */
+    inline float lookup(float x) const
+    {
+        const float position = (x + inputRange) * indexScale;
+
+        // NaN fails every comparison: caught here, it never reaches the index cast
+        if (! (position > 0.0f))
+            return position <= 0.0f ? points[1] + (x + inputRange) * slopeLow : 0.0f;
+
+        if (position >= static_cast<float>(tableSize - 1))
+            return points[tableSize] + (x - inputRange) * slopeHigh;
+
+        const int index = static_cast<int>(position);
+        const float t = position - static_cast<float>(index);
+        const float* p = points.data() + index;  // p[1] is the sample at 'index'
+
+        // Catmull-Rom cubic through p[0..3]
+        const float c1 = 0.5f * (p[2] - p[0]);
+        const float c2 = p[0] - 2.5f * p[1] + 2.0f * p[2] - 0.5f * p[3];
+        const float c3 = 0.5f * (p[3] - p[0]) + 1.5f * (p[1] - p[2]);
+        return ((c3 * t + c2) * t + c1) * t + p[1];
+    }
+
+    float getDrive() const { return drive; }
+
+private:
+    static float indexToInput(int index)
+    {
+        return -inputRange + static_cast<float>(index) / indexScale;
+    }
+
+    static constexpr float indexScale = static_cast<float>(tableSize - 1) / (2.0f * inputRange);
+
+    std::array<float, tableSize + 2> points {};
+    float slopeLow = 1.0f;
+    float slopeHigh = 1.0f;
+    float drive = -1.0f;
+};
+
+class WaveshaperTableSet;
+
+/**
+ * @brief Process-wide builder thread for all WaveshaperTableSets
+ *
+ * One thread serves every instance instead of one thread each. It sleeps
+ * until a set queues a rebuild: the set raises its atomic flag and calls
+ * wake(). Wakes are coalesced through workPending, so the audio thread
+ * signals the event (a short, never-contended-for-long mutex inside
+ * WaitableEvent) at most once per batch of rebuilds, not once per block,
+ * and an idle process has no wake-ups at all.
+ *
+ * The set list is guarded by a mutex that only the builder and
+ * prepare()/destruction take; remove() returns once the builder is no
+ * longer touching the set.
+ */
+class WaveshaperTableBuilder : private juce::Thread
+{
+public:
+    /**
+     * @brief The shared builder, started on first use, stopped with its last user
+     */
+    static std::shared_ptr<WaveshaperTableBuilder> getInstance()
+    {
+        static std::mutex instanceLock;
+        static std::weak_ptr<WaveshaperTableBuilder> shared;
+
+        const std::lock_guard<std::mutex> lock(instanceLock);
+        auto builder = shared.lock();
+        if (builder == nullptr)
+        {
+            builder = std::shared_ptr<WaveshaperTableBuilder>(new WaveshaperTableBuilder());
+            shared = builder;
+        }
+        return builder;
+    }
+
+    ~WaveshaperTableBuilder() override
+    {
+        stopThread(1000);
+    }
+
+    void add(WaveshaperTableSet* set)
+    {
+        const std::lock_guard<std::mutex> lock(setsLock);
+        if (std::find(sets.begin(), sets.end(), set) == sets.end())
+            sets.push_back(set);
+    }
+
+    void remove(WaveshaperTableSet* set)
+    {
+        const std::lock_guard<std::mutex> lock(setsLock);
+        sets.erase(std::remove(sets.begin(), sets.end(), set), sets.end());
+    }
+
+    /**
+     * @brief A set has raised its build flag (audio thread: no allocation, no waiting)
+     */
+    void wake()
+    {
+        if (! workPending.exchange(true, std::memory_order_acq_rel))
+            notify();
+    }
+
+private:
+    WaveshaperTableBuilder() : juce::Thread("FatPressor Waveshaper")
+    {
+        startThread();
+    }
+
+    inline void run() override;
+
+    std::mutex setsLock;
+    std::vector<WaveshaperTableSet*> sets;
+    std::atomic<bool> workPending { false };
+};
+
+/**
+ * @brief Background-Rebuilt Waveshaper Tables with Crossfade
+ *
+ * Keeps three table slots: the one in use, the one being faded out and a
+ * spare that the shared builder thread bakes whenever the requested drive
+ * moves.
+ * Finished tables are handed to the audio thread through an atomic slot
+ * index, so the audio thread never waits, locks or allocates.
+ *
+ * When a new table arrives the output is crossfaded from the old table to
+ * the new one over a few milliseconds, keeping FAT automation click-free.
+ *
+ * Tables are baked at drive steps of driveTolerance and come from the
+ * SharedTableCache, so instances at the same FAT share one copy. Slots are
+ * only (re)assigned by the builder while the audio thread is not using
+ * them, and a table is never released on the audio thread.
+ *
+ * Audio thread usage per block:
+ *   beginBlock() → process() per channel → endBlock(numSamples)
+ */
+class WaveshaperTableSet
+{
+public:
+    WaveshaperTableSet() = default;
+
+    ~WaveshaperTableSet()
+    {
+        if (builder != nullptr)
+            builder->remove(this);
+    }
+
+    /**
+     * @brief Bake the initial table synchronously and register with the builder
+     * (deterministic sets never use the builder, so they do not start it)
+     */
+    void prepare(double sampleRate, WaveshaperTable::CurveFunction newCurve, SharedTableCache::Type newCurveType,
+                 float initialDrive)
+    {
+        if (builder == nullptr && ! deterministic)
+            builder = WaveshaperTableBuilder::getInstance();
+
+        if (builder != nullptr)
+            builder->remove(this);
+        buildRequested.store(false);
+
+        curve = newCurve;
+        curveType = newCurveType;
+        tables[0] = acquireTable(initialDrive);
+
+        currentSlot = 0;
+        previousSlot = -1;
+        pendingSlot.store(-1);
+        inUseMask.store(1u << 0);
+        targetDrive.store(initialDrive);
+        builtDrive = initialDrive;
+        requestedDrive = initialDrive;
+
+        crossfade.prepare(sampleRate);
+
+        if (! deterministic)
+            builder->add(this);
+    }
+
+    /**
+     * @brief Ask for a table baked at a new drive (audio thread, non-blocking)
+     */
+    void requestDrive(float newDrive)
+    {
+        if (std::abs(newDrive - requestedDrive) < driveTolerance)
+            return;
+
+        requestedDrive = newDrive;
+        targetDrive.store(newDrive);
+
+        if (! deterministic)
+            queueBuild();
+    }
+
+    /**
+     * @brief Deterministic mode (session replay): tables only change via buildNow()
+     * Set before prepare().
+     */
+    void setDeterministic(bool shouldBeDeterministic)
+    {
+        deterministic = shouldBeDeterministic;
+    }
+
+    /**
+     * @brief Deterministic mode: bake the last requested drive now, between blocks
+     * Hand-offs then depend only on the block sequence, not on builder timing
+     * (not real-time safe).
+     */
+    void buildRequestedNow()
+    {
+        if (pendingSlot.load(std::memory_order_acquire) < 0 && std::abs(requestedDrive - builtDrive) >= driveTolerance)
+            buildNow(requestedDrive);
+    }
+
+    /**
+     * @brief Bake a table synchronously and hand it to the next block (not real-time safe)
+     */
+    void buildNow(float drive)
+    {
+        const auto busy = inUseMask.load(std::memory_order_acquire);
+        int freeSlot = 0;
+        while ((busy & (1u << freeSlot)) != 0)
+            ++freeSlot;
+
+        tables[static_cast<size_t>(freeSlot)] = acquireTable(drive);
+        builtDrive = drive;
+        pendingSlot.store(freeSlot, std::memory_order_release);
+    }
+
+    /**
+     * @brief Number of tables picked up so far, and the drive of the current one
+     * (lets a session capture record hand-offs so a replay can repeat them)
+     */
+    int getHandOffCount() const { return handOffCount; }
+    float getCurrentDrive() const { return tables[static_cast<size_t>(currentSlot)]->getDrive(); }
+
+    /**
+     * @brief Pick up a freshly baked table, if any, and start crossfading to it
+     */
+    void beginBlock()
+    {
+        const int pending = pendingSlot.load(std::memory_order_acquire);
+        if (pending < 0)
+            return;
+
+        // A table arriving mid-fade replaces the outgoing one; the jump is
+        // masked by the new fade because both tables are close in drive.
+        previousSlot = currentSlot;
+        currentSlot = pending;
+        crossfade.start();
+
+        inUseMask.store((1u << currentSlot) | (1u << previousSlot), std::memory_order_release);
+        pendingSlot.store(-1, std::memory_order_release);
+        ++handOffCount;
+
+        // The target may have moved while this table was waiting to be picked up
+        if (! deterministic)
+            queueBuild();
+    }
+
+    /**
+     * @brief Shape one channel of the current block in place
+     */
+    void process(float* data, int numSamples) const
+    {
+        const auto& current = *tables[static_cast<size_t>(currentSlot)];
+
+        int sample = 0;
+        if (crossfade.isActive())
+        {
+            const auto& previous = *tables[static_cast<size_t>(previousSlot)];
+            const float step = crossfade.getStep();
+            float fade = crossfade.getNextFade();
+
+            for (const int fadeSamples = crossfade.getFadeSamples(numSamples); sample < fadeSamples; ++sample, fade += step)
+            {
+                const float x = data[sample];
+                const float from = previous.lookup(x);
+                data[sample] = from + fade * (current.lookup(x) - from);
+            }
+        }
+
+        for (; sample < numSamples; ++sample)
+            data[sample] = current.lookup(data[sample]);
+    }
+
+    /**
+     * @brief Advance the crossfade once all channels of the block are processed
+     */
+    void endBlock(int numSamples)
+    {
+        if (crossfade.advance(numSamples))
+        {
+            previousSlot = -1;
+            inUseMask.store(1u << currentSlot, std::memory_order_release);
+        }
+    }
+
+private:
+    friend class WaveshaperTableBuilder;
+
+    void queueBuild()
+    {
+        buildRequested.store(true, std::memory_order_release);
+        if (builder != nullptr)
+            builder->wake();
+    }
+
+    /**
+     * @brief Bake the requested table if the audio thread asked (builder thread)
+     */
+    void buildIfRequested()
+    {
+        if (! buildRequested.exchange(false, std::memory_order_acquire))
+            return;
+
+        // Only bake when the audio thread has consumed the last hand-off;
+        // picking it up raises the flag again for the latest target.
+        if (pendingSlot.load(std::memory_order_acquire) >= 0)
+            return;
+
+        const float drive = targetDrive.load();
+        if (std::abs(drive - builtDrive) < driveTolerance)
+            return;
+
+        const auto busy = inUseMask.load(std::memory_order_acquire);
+        int freeSlot = 0;
+        while ((busy & (1u << freeSlot)) != 0)
+            ++freeSlot;
+
+        tables[static_cast<size_t>(freeSlot)] = acquireTable(drive);
+        builtDrive = drive;
+        pendingSlot.store(freeSlot, std::memory_order_release);
+    }
+
+    /**
+     * @brief Shared table for the drive step nearest to drive (not real-time safe)
+     */
+    std::shared_ptr<const WaveshaperTable> acquireTable(float drive) const
+    {
+        const int step = juce::roundToInt(drive / driveTolerance);
+        const SharedTableCache::Key key { 0.0, curveType, WaveshaperTable::tableSize, step };
+
+        return SharedTableCache::acquire<WaveshaperTable>(key, [this, step](WaveshaperTable& table)
+        {
+            table.build(curve, static_cast<float>(step) * driveTolerance);
+        });
+    }
+
+    static constexpr int numSlots = 3;
+    static constexpr float driveTolerance = 0.001f;     // FAT parameter step (0.1%)
+
+    std::array<std::shared_ptr<const WaveshaperTable>, numSlots> tables;
+    WaveshaperTable::CurveFunction curve = nullptr;
+    SharedTableCache::Type curveType = SharedTableCache::Type::tubeCurve;
+
+    // Hand-off between builder and audio thread
+    std::atomic<int> pendingSlot { -1 };
+    std::atomic<juce::uint32> inUseMask { 1u };
+    std::atomic<float> targetDrive { 0.0f };
+    std::atomic<bool> buildRequested { false };
+    std::shared_ptr<WaveshaperTableBuilder> builder;
+
+    // Builder thread only (or buildNow() in deterministic mode)
+    float builtDrive = 0.0f;
+    bool deterministic = false;
+
+    // Audio thread only
+    float requestedDrive = 0.0f;
+    int currentSlot = 0;
+    int previousSlot = -1;
+    LinearCrossfade crossfade;
+    int handOffCount = 0;
+};
+
+void WaveshaperTableBuilder::run()
+{
+    while (! threadShouldExit())
+    {
+        // Sleeps until wake() (or stopThread()); cleared before the scan, so a
+        // request arriving during it wakes the thread again
+        wait(-1);
+        workPending.store(false, std::memory_order_release);
+
+        const std::lock_guard<std::mutex> lock(setsLock);
+        for (auto* set : sets)
+        {
+            // A failed bake (out of memory) keeps the current table; the
+            // next request tries again
+            try
+            {
+                set->buildIfRequested();
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+}
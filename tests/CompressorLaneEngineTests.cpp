@@ -0,0 +1,153 @@
+#include "../src/dsp/CompressorLaneEngine.h"
+#include "../src/dsp/EnvelopeFollower.h"
+#include "../src/dsp/GainComputer.h"
+#include "../src/dsp/SidechainDetector.h"
+#include "TestHelpers.h"
+
+/**
+ * @brief Lane engine against the scalar detector → envelope → gain computer chain
+ */
+class CompressorLaneEngineTests : public juce::UnitTest
+{
+public:
+    CompressorLaneEngineTests() : juce::UnitTest("Compressor Lane Engine", "dsp") {}
+
+    void runTest() override
+    {
+        beginTest("Every lane tracks the scalar chain");
+        {
+            // Odd lane count, so the last SIMD group has padding lanes
+            constexpr int numLanes = 19;
+            CompressorLaneEngine engine;
+            engine.prepare(sampleRate, blockSize, numLanes);
+
+            std::vector<Track> tracks;
+            for (int lane = 0; lane < numLanes; ++lane)
+                tracks.emplace_back(lane);
+
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                const auto& settings = tracks[static_cast<size_t>(lane)].settings;
+                engine.setThreshold(lane, settings.threshold);
+                engine.setRatio(lane, settings.ratio);
+                engine.setKneeWidth(lane, settings.knee);
+                engine.setAttackMs(lane, settings.attackMs);
+                engine.setReleaseMs(lane, settings.releaseMs);
+            }
+
+            std::vector<float*> left, right;
+            for (auto& track : tracks)
+            {
+                left.push_back(track.left.data());
+                right.push_back(track.mono ? track.left.data() : track.right.data());
+            }
+
+            for (int start = 0; start < numSamples; start += blockSize)
+            {
+                std::vector<float*> blockLeft, blockRight;
+                for (int lane = 0; lane < numLanes; ++lane)
+                {
+                    blockLeft.push_back(left[static_cast<size_t>(lane)] + start);
+                    blockRight.push_back(right[static_cast<size_t>(lane)] + start);
+                }
+
+                engine.process(blockLeft.data(), blockRight.data(), blockSize);
+            }
+
+            double worstDb = 0.0, deepestDb = 0.0;
+            for (auto& track : tracks)
+            {
+                const auto reference = track.renderScalarGains();
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const auto index = static_cast<size_t>(i);
+                    if (std::abs(track.input[index]) < 1.0e-3f)
+                        continue;
+
+                    const double engineGain = track.left[index] / track.input[index];
+                    worstDb = juce::jmax(worstDb, std::abs(juce::Decibels::gainToDecibels(engineGain, -200.0)
+                                                           - juce::Decibels::gainToDecibels(static_cast<double>(reference[index]), -200.0)));
+                    deepestDb = juce::jmin(deepestDb, juce::Decibels::gainToDecibels(static_cast<double>(reference[index]), -200.0));
+                }
+            }
+
+            // The settings compress by several dB, so a dead engine would fail too
+            expectLessThan(deepestDb, -6.0, "deepest scalar gain reduction");
+            expectLessThan(worstDb, 0.05, "largest gain difference (dB)");
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 256;
+    static constexpr int numSamples = blockSize * 96;   // about half a second
+
+    struct Settings
+    {
+        float threshold, ratio, knee, attackMs, releaseMs;
+    };
+
+    /**
+     * @brief One lane: its own settings and signal (bursts of a sine over noise)
+     */
+    struct Track
+    {
+        explicit Track(int lane)
+            : settings { -30.0f + 1.5f * static_cast<float>(lane % 7), 2.0f + static_cast<float>(lane % 5) * 2.0f,
+                         static_cast<float>(lane % 3) * 6.0f, 1.0f + static_cast<float>(lane % 4) * 10.0f,
+                         50.0f + static_cast<float>(lane % 6) * 150.0f }
+            , mono(lane % 4 == 3)
+        {
+            juce::Random random(lane + 1);
+            const auto sine = TestHelpers::makeSine(110.0 * (1 + lane % 5), sampleRate, numSamples);
+            const int burstLength = 2400 + 600 * (lane % 5);
+
+            input.resize(static_cast<size_t>(numSamples));
+            right.resize(input.size());
+            for (size_t i = 0; i < input.size(); ++i)
+            {
+                const bool loud = (static_cast<int>(i) / burstLength) % 2 == 0;
+                input[i] = (loud ? 0.7f : 0.05f) * sine[i] + 0.01f * (random.nextFloat() - 0.5f);
+                right[i] = mono ? input[i] : 0.8f * input[i];
+            }
+            left = input;
+        }
+
+        // Linear gain per sample from the scalar classes, as the engine computes it
+        std::vector<float> renderScalarGains() const
+        {
+            DspArena arena;
+            arena.reserve(SidechainDetector::getArenaFloats(sampleRate));
+
+            SidechainDetector detector;
+            EnvelopeFollower envelope;
+            GainComputer gainComputer;
+            detector.prepare(sampleRate, blockSize, arena);
+            envelope.prepare(sampleRate, blockSize);
+            gainComputer.prepare(sampleRate, blockSize);
+
+            envelope.setAttackMs(settings.attackMs);
+            envelope.setReleaseMs(settings.releaseMs);
+            gainComputer.setThreshold(settings.threshold);
+            gainComputer.setRatio(settings.ratio);
+            gainComputer.setKneeWidth(settings.knee);
+
+            std::vector<float> gains(input.size());
+            for (size_t i = 0; i < input.size(); ++i)
+            {
+                const float r = mono ? input[i] : 0.8f * input[i];
+                const float grDb = gainComputer.processSample(envelope.processSample(detector.processSample(input[i], r)));
+                gains[i] = juce::Decibels::decibelsToGain(grDb);
+            }
+
+            return gains;
+        }
+
+        Settings settings;
+        bool mono;
+        std::vector<float> input, left, right;
+    };
+};
+
+static CompressorLaneEngineTests compressorLaneEngineTests;
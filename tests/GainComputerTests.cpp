@@ -0,0 +1,162 @@
+#include "../src/dsp/GainComputer.h"
+#include "TestHelpers.h"
+
+/**
+ * @brief Gain computer static curves, alone and two in series (Opto + VCA), and the expander
+ */
+class GainComputerTests : public juce::UnitTest
+{
+public:
+    GainComputerTests() : juce::UnitTest("Gain Computer", "dsp") {}
+
+    void runTest() override
+    {
+        beginTest("Opto into VCA: the combined static curve never falls as the input rises");
+        {
+            // The processor's pairing: opto knee 6 dB, VCA knee 2 dB and
+            // vcaOffsetDb above the opto threshold, both at the same ratio.
+            // The VCA's detector reads the peak, crestDb above the opto's.
+            for (const float ratio : { 1.0f, 2.0f, 4.0f, 8.0f, 20.0f })
+            {
+                for (const float threshold : { -60.0f, -30.0f, -10.0f, 0.0f })
+                {
+                    for (const float crestDb : { 0.0f, 3.0f, 12.0f })
+                    {
+                        GainComputer opto, vca;
+                        opto.setKneeWidth(6.0f);
+                        opto.setThreshold(threshold);
+                        opto.setRatio(ratio);
+                        vca.setKneeWidth(2.0f);
+                        vca.setThreshold(threshold + vcaOffsetDb);
+                        vca.setRatio(ratio);
+
+                        float previousOutput = -1.0e9f;
+                        float largestFall = 0.0f;
+
+                        for (float inputDb = -80.0f; inputDb <= 20.0f; inputDb += 0.05f)
+                        {
+                            const float peakDb = inputDb + crestDb;
+                            const float grDb = vca.computeSeriesGainReduction(opto.computeGainReduction(inputDb), peakDb);
+                            const float outputDb = peakDb + grDb;
+
+                            largestFall = juce::jmax(largestFall, previousOutput - outputDb);
+                            previousOutput = outputDb;
+                        }
+
+                        expectLessOrEqual(largestFall, 1.0e-4f, "ratio " + juce::String(ratio) + ", threshold "
+                                                                    + juce::String(threshold) + ", crest " + juce::String(crestDb));
+                    }
+                }
+            }
+        }
+
+        beginTest("In series the VCA hears the opto's output, not its input");
+        {
+            GainComputer opto, vca;
+            opto.setKneeWidth(0.0f);
+            opto.setThreshold(-20.0f);
+            opto.setRatio(4.0f);
+            vca.setKneeWidth(0.0f);
+            vca.setThreshold(-14.0f);
+            vca.setRatio(4.0f);
+
+            // -8 dB in: the opto takes 9 dB off, so the VCA sees -17 dB, below its threshold
+            const float optoDb = opto.computeGainReduction(-8.0f);
+            expectWithinAbsoluteError(optoDb, -9.0f, 1.0e-4f);
+            expectWithinAbsoluteError(vca.computeSeriesGainReduction(optoDb, -8.0f), optoDb, 1.0e-4f);
+
+            // +10 dB in: opto output -12.5 dB, 1.5 dB over the VCA, which takes off 1.125 dB more
+            const float loudOptoDb = opto.computeGainReduction(10.0f);
+            expectWithinAbsoluteError(vca.computeSeriesGainReduction(loudOptoDb, 10.0f), loudOptoDb - 1.125f, 1.0e-4f);
+        }
+
+        beginTest("Expander: clamps at its range, opens at the threshold");
+        {
+            auto expander = makeExpander();
+
+            // Far below: 40 dB under the threshold at 4:1 wants -120 dB, the range stops it at -40
+            const float closedDb = feed(expander, -80.0f, settleSamples);
+            expect(! expander.isExpanderOpen(), "closed far below the threshold");
+            expectWithinAbsoluteError(closedDb, -GainComputer::expanderRangeDb, 1.0e-3f);
+
+            // Exactly at the threshold it opens and glides back to no expansion
+            feed(expander, expanderThresholdDb, 1);
+            expect(expander.isExpanderOpen(), "open at the threshold");
+            expectEquals(feed(expander, expanderThresholdDb, settleSamples), 0.0f, "no expansion once open");
+        }
+
+        beginTest("Expander: stays open through the hold time and inside the hysteresis band");
+        {
+            auto expander = makeExpander();
+            feed(expander, -20.0f, settleSamples);
+
+            // Inside the band (above threshold - hysteresis) it never closes, hold or not
+            expectEquals(feed(expander, expanderThresholdDb - hysteresisDb + 1.0f, settleSamples), 0.0f, "open inside the band");
+            expect(expander.isExpanderOpen());
+
+            // Well below the band: open for the whole hold time, closed right after
+            feed(expander, -20.0f, 1);
+            expectEquals(feed(expander, -60.0f, holdSamples), 0.0f, "open during the hold");
+            expect(expander.isExpanderOpen(), "open on the last hold sample");
+            feed(expander, -60.0f, 1);
+            expect(! expander.isExpanderOpen(), "closed once the hold ran out");
+        }
+
+        beginTest("Expander: closes below threshold minus hysteresis, at the ratio's depth");
+        {
+            auto expander = makeExpander();
+            feed(expander, -20.0f, settleSamples);
+
+            // 1 dB below the band, past the hold: (-47 - -40) * (4 - 1) = -21 dB
+            const float levelDb = expanderThresholdDb - hysteresisDb - 1.0f;
+            const float expansionDb = feed(expander, levelDb, holdSamples + settleSamples);
+            expect(! expander.isExpanderOpen());
+            expectWithinAbsoluteError(expansionDb, (levelDb - expanderThresholdDb) * (expanderRatio - 1.0f), 1.0e-3f);
+        }
+
+        beginTest("Expander: switched off while closed, it returns to exactly 0");
+        {
+            auto expander = makeExpander();
+            expectLessThan(feed(expander, -80.0f, settleSamples), -30.0f, "closed first");
+
+            expander.setExpanderRatio(1.0f);
+            expectEquals(feed(expander, -80.0f, settleSamples), 0.0f, "settled at 0 after switching off");
+            expectEquals(expander.computeExpansion(-80.0f), 0.0f, "and stays there");
+        }
+    }
+
+private:
+    static constexpr float vcaOffsetDb = 6.0f;
+
+    static constexpr double sampleRate = 48000.0;
+    static constexpr float expanderThresholdDb = -40.0f;
+    static constexpr float expanderRatio = 4.0f;
+    static constexpr float hysteresisDb = 6.0f;
+    static constexpr float holdMs = 10.0f;
+    static constexpr int holdSamples = 480;      // holdMs at sampleRate
+    static constexpr int settleSamples = 4800;   // 100 ms, many times the 2 ms smoothing
+
+    static GainComputer makeExpander()
+    {
+        GainComputer expander;
+        expander.prepare(sampleRate, 512);
+        expander.setExpanderThreshold(expanderThresholdDb);
+        expander.setExpanderRatio(expanderRatio);
+        expander.setExpanderHysteresis(hysteresisDb);
+        expander.setExpanderHoldMs(holdMs);
+        return expander;
+    }
+
+    /**
+     * @brief Run numSamples of a constant envelope level, return the last expansion
+     */
+    static float feed(GainComputer& expander, float levelDb, int numSamples)
+    {
+        float expansionDb = 0.0f;
+        for (int sample = 0; sample < numSamples; ++sample)
+            expansionDb = expander.computeExpansion(levelDb);
+        return expansionDb;
+    }
+};
+
+static GainComputerTests gainComputerTests;
@@ -0,0 +1,76 @@
+#include "../src/LinkGroup.h"
+#include "TestHelpers.h"
+#include <memory>
+
+/**
+ * @brief Link groups: joining, leaving, sharing levels, and a full member table
+ */
+class LinkGroupTests : public juce::UnitTest
+{
+public:
+    LinkGroupTests() : juce::UnitTest("Link Group", "dsp") {}
+
+    void runTest() override
+    {
+        beginTest("Members of a group read each other's level, other groups and non-members do not");
+        {
+            LinkGroup first, second, elsewhere, unlinked;
+            expect(first.join(1) && second.join(1) && elsewhere.join(2), "joined");
+            expect(first.isLinked() && first.getGroup() == 1);
+
+            first.publish(-12.0f);
+            second.publish(-30.0f);
+            elsewhere.publish(-3.0f);
+
+            expectEquals(first.readOthers(), -30.0f, "first hears second");
+            expectEquals(second.readOthers(), -12.0f, "second hears first");
+            expectEquals(elsewhere.readOthers(), LinkGroup::floorDb, "group 2 is on its own");
+            expectEquals(unlinked.readOthers(), LinkGroup::floorDb, "not a member");
+        }
+
+        beginTest("A member that leaves or moves is no longer heard");
+        {
+            LinkGroup first, second;
+            first.join(3);
+            second.join(3);
+            second.publish(-6.0f);
+            expectEquals(first.readOthers(), -6.0f);
+
+            second.join(4);
+            expectEquals(first.readOthers(), LinkGroup::floorDb, "moved to another group");
+
+            second.join(3);
+            second.publish(-9.0f);
+            expectEquals(first.readOthers(), -9.0f, "back in the group");
+
+            second.leave();
+            expect(! second.isLinked() && second.getGroup() == 0);
+            expectEquals(first.readOthers(), LinkGroup::floorDb, "left");
+        }
+
+        beginTest("With the table full a join fails once and is only retried for another group");
+        {
+            std::array<std::unique_ptr<LinkGroup>, LinkGroup::maxMembers> members;
+            for (auto& member : members)
+            {
+                member = std::make_unique<LinkGroup>();
+                expect(member->join(5));
+            }
+
+            LinkGroup late;
+            expect(! late.join(5), "table full");
+            expect(! late.isLinked() && late.getRequestedGroup() == 5);
+
+            // A slot frees up, but asking for the same group again does not rescan
+            members.back().reset();
+            expect(! late.join(5), "no retry for the same group");
+            expect(! late.isLinked());
+
+            // A new group is a new attempt
+            expect(late.join(6), "joined once the group changed");
+            expect(late.isLinked() && late.getGroup() == 6);
+        }
+    }
+};
+
+static LinkGroupTests linkGroupTests;
@@ -0,0 +1,78 @@
+#include "../src/dsp/LinkwitzRileyCrossover.h"
+#include "TestHelpers.h"
+
+/**
+ * @brief De-ess crossover: flat while the high band is untouched, a clean dip when it is not
+ */
+class LinkwitzRileyCrossoverTests : public juce::UnitTest
+{
+public:
+    LinkwitzRileyCrossoverTests() : juce::UnitTest("Linkwitz-Riley Crossover", "dsp") {}
+
+    void runTest() override
+    {
+        beginTest("With the high band at unity the bands sum to a flat allpass");
+        {
+            for (const double sampleRate : { 44100.0, 48000.0, 96000.0 })
+            {
+                LinkwitzRileyCrossover crossover;
+                crossover.prepare(sampleRate, crossoverFrequency);
+
+                double largestDeviationDb = 0.0;
+                for (double frequency = 20.0; frequency < sampleRate * 0.45; frequency *= 1.05)
+                {
+                    const auto magnitudeDb = juce::Decibels::gainToDecibels(std::abs(crossover.getResponse(frequency, sampleRate, 1.0)));
+                    largestDeviationDb = juce::jmax(largestDeviationDb, std::abs(magnitudeDb));
+                }
+
+                expectLessThan(largestDeviationDb, 0.01, "sum at " + juce::String(sampleRate) + " Hz");
+            }
+        }
+
+        beginTest("Turning the high band down dips the highs without touching the lows or bumping the crossover");
+        {
+            LinkwitzRileyCrossover crossover;
+            crossover.prepare(sampleRate, crossoverFrequency);
+
+            const auto levelDb = [&crossover](double frequency, double highGain)
+            {
+                return juce::Decibels::gainToDecibels(std::abs(crossover.getResponse(frequency, sampleRate, highGain)));
+            };
+
+            // 12 dB of reduction on the high band
+            const double highGain = juce::Decibels::decibelsToGain(-12.0);
+            expectGreaterThan(levelDb(300.0, highGain), -0.1, "lows untouched");
+            expectLessThan(levelDb(12000.0, highGain), -9.0, "highs turned down");
+
+            // Never louder than the input anywhere (input - highpass peaks below the split)
+            double loudestDb = -100.0;
+            for (double frequency = 20.0; frequency < sampleRate * 0.45; frequency *= 1.05)
+                loudestDb = juce::jmax(loudestDb, levelDb(frequency, highGain));
+            expectLessOrEqual(loudestDb, 0.001, "no bump");
+        }
+
+        beginTest("The per-sample path matches the response");
+        {
+            LinkwitzRileyCrossover crossover;
+            crossover.prepare(sampleRate, crossoverFrequency);
+
+            constexpr double frequency = 8000.0;
+            constexpr float highGain = 0.25f;
+            auto signal = TestHelpers::makeSine(frequency, sampleRate, numSamples, 0.5f);
+            for (auto& sample : signal)
+                sample = crossover.processSample(0, sample, highGain);
+
+            const double measured = TestHelpers::measureAmplitude(signal, frequency, sampleRate, static_cast<size_t>(numSamples / 2),
+                                                                 static_cast<size_t>(numSamples));
+            const double expected = 0.5 * std::abs(crossover.getResponse(frequency, sampleRate, highGain));
+            expectWithinAbsoluteError(juce::Decibels::gainToDecibels(measured), juce::Decibels::gainToDecibels(expected), 0.05);
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr float crossoverFrequency = 4000.0f;
+    static constexpr int numSamples = 48000;
+};
+
+static LinkwitzRileyCrossoverTests linkwitzRileyCrossoverTests;
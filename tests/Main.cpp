@@ -0,0 +1,38 @@
+#include <juce_core/juce_core.h>
+#include <iostream>
+
+/**
+ * fatpressor-tests - runs the juce::UnitTest suites
+ *
+ *   fatpressor-tests [category]
+ *
+ * Without a category every registered test runs. The exit code is the
+ * number of failed expectations (0 = all passed), which is what ctest checks.
+ */
+int main(int argc, char* argv[])
+{
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+
+    if (argc > 1)
+        runner.runTestsInCategory(argv[1]);
+    else
+        runner.runAllTests();
+
+    int failures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        failures += runner.getResult(i)->failures;
+
+    if (runner.getNumResults() == 0)
+    {
+        std::cerr << "no tests in category " << (argc > 1 ? argv[1] : "(all)") << std::endl;
+        return 1;
+    }
+
+    if (failures == 0)
+        std::cout << "all tests passed" << std::endl;
+    else
+        std::cout << failures << " expectation(s) failed" << std::endl;
+
+    return juce::jmin(failures, 125);
+}
@@ -0,0 +1,98 @@
+#include "../src/dsp/SharedTableCache.h"
+#include "TestHelpers.h"
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+/**
+ * @brief Shared table cache: a build that throws reaches every waiter and is retried later
+ */
+class SharedTableCacheTests : public juce::UnitTest
+{
+public:
+    SharedTableCacheTests() : juce::UnitTest("Shared Table Cache", "dsp") {}
+
+    void runTest() override
+    {
+        beginTest("A throwing build rethrows, caches nothing and is built again on the next acquire");
+        {
+            const auto key = makeKey(1);
+
+            bool threw = false;
+            try
+            {
+                SharedTableCache::acquire<TestTable>(key, [](TestTable&) { throw std::runtime_error("no memory"); });
+            }
+            catch (const std::runtime_error&)
+            {
+                threw = true;
+            }
+            expect(threw, "the builder's exception reaches the caller");
+
+            const auto table = SharedTableCache::acquire<TestTable>(key, [](TestTable& t) { t.value = 42; });
+            expect(table != nullptr && table->value == 42, "the next acquire builds it");
+        }
+
+        beginTest("A thread waiting on a build that throws gets the exception instead of hanging");
+        {
+            const auto key = makeKey(2);
+            std::promise<void> buildStarted;
+            std::promise<void> releaseBuild;
+            auto release = releaseBuild.get_future().share();
+
+            auto builder = std::async(std::launch::async, [&]
+            {
+                try
+                {
+                    SharedTableCache::acquire<TestTable>(key, [&](TestTable&)
+                    {
+                        buildStarted.set_value();
+                        release.wait();
+                        throw std::runtime_error("build failed");
+                    });
+                }
+                catch (const std::runtime_error&)
+                {
+                }
+            });
+
+            buildStarted.get_future().wait();
+
+            // Waits on the pending build (or, if it already failed, builds itself)
+            auto waiter = std::async(std::launch::async, [&key]
+            {
+                try
+                {
+                    return SharedTableCache::acquire<TestTable>(key, [](TestTable& t) { t.value = 7; }) != nullptr ? 1 : 0;
+                }
+                catch (const std::runtime_error&)
+                {
+                    return -1;
+                }
+            });
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            releaseBuild.set_value();
+
+            expect(waiter.wait_for(std::chrono::seconds(5)) == std::future_status::ready, "the waiter returned");
+            builder.wait();
+            if (waiter.valid())
+                expect(waiter.get() != 0, "an exception or a table of its own");
+        }
+    }
+
+private:
+    struct TestTable
+    {
+        int value = 0;
+    };
+
+    // Quality -1 keeps these keys away from real tables
+    static SharedTableCache::Key makeKey(int index)
+    {
+        return { 0.0, SharedTableCache::Type::tubeCurve, -1, index };
+    }
+};
+
+static SharedTableCacheTests sharedTableCacheTests;
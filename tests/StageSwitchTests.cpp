@@ -0,0 +1,168 @@
+#include "../src/PluginProcessor.h"
+#include "TestHelpers.h"
+
+/**
+ * @brief Stage switches and chain order changes through the whole processor:
+ * the kernel that runs while they glide, and no click across them
+ */
+class StageSwitchTests : public juce::UnitTest
+{
+public:
+    StageSwitchTests() : juce::UnitTest("Stage Switches", "processor") {}
+
+    void runTest() override
+    {
+        juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+        using Processor = FatPressorAudioProcessor;
+        constexpr int allStages = Processor::allStageSwitches;
+
+        beginTest("A stage switched out runs until its fade is over, one switched in from the start");
+        {
+            const std::pair<const char*, int> switches[] = { { "tubeEnabled", Processor::tubeSwitch },
+                                                             { "compressionEnabled", Processor::compressionSwitch },
+                                                             { "ironEnabled", Processor::ironSwitch },
+                                                             { "eqEnabled", Processor::shelvesSwitch } };
+
+            for (const auto& [parameterId, stage] : switches)
+            {
+                const auto render = renderWithChanges({ { switchBlock, parameterId, 0.0f },
+                                                        { switchBackBlock, parameterId, 1.0f } });
+                const juce::String name(parameterId);
+
+                expectEquals(render.kernelStages[switchBlock - 1], allStages, name + ": every stage in before the switch");
+
+                // enabledStages | fadingStages: switched off, but still in the kernel while it fades out
+                expectEquals(render.kernelStages[switchBlock], allStages, name + ": still in while fading out");
+                expectEquals(render.kernelStages[switchBlock + fadeBlocks + 1], allStages & ~stage, name + ": out after the fade");
+
+                // Switched back in, it is in the kernel from the first block and stays there
+                expectEquals(render.kernelStages[switchBackBlock], allStages, name + ": in while fading in");
+                expectEquals(render.kernelStages[switchBackBlock + fadeBlocks + 1], allStages, name + ": in after the fade");
+
+                expectClickFree(render, switchBlock, name + " off");
+                expectClickFree(render, switchBackBlock, name + " on");
+            }
+        }
+
+        beginTest("A chain order change swaps the kernel halfway through its fade");
+        {
+            const auto render = renderWithChanges({ { switchBlock, "chainOrder", 1.0f },
+                                                    { switchBackBlock, "chainOrder", 2.0f } });
+
+            expectEquals(render.kernelChainOrders[switchBlock - 1], 0);
+
+            // The old order runs while the chain fades to the dry signal
+            expectEquals(render.kernelChainOrders[switchBlock], 0, "old order while fading out");
+            expectEquals(render.kernelChainOrders[switchBlock + fadeBlocks + 1], 1, "new order after the fade");
+            expectEquals(render.kernelChainOrders[switchBackBlock], 1, "old order while fading out");
+            expectEquals(render.kernelChainOrders[switchBackBlock + fadeBlocks + 1], 2, "new order after the fade");
+            expectEquals(render.kernelStages[switchBackBlock + fadeBlocks + 1], allStages, "stages untouched");
+
+            expectClickFree(render, switchBlock, "classic to tube after compression");
+            expectClickFree(render, switchBackBlock, "tube after compression to compression last");
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 64;
+
+    // A 100 Hz period is 480 samples, so block 2 + 15 n starts 128 samples
+    // into one: close to the peak, where a hard switch would jump the most
+    static constexpr int switchBlock = 2 + 15 * 10;
+    static constexpr int switchBackBlock = switchBlock + 15 * 5;
+    static constexpr int numBlocks = switchBackBlock + 15 * 5;
+    static constexpr int fadeBlocks = 4;   // stageFadeSeconds at sampleRate, in whole blocks
+
+    struct Change
+    {
+        int block;
+        const char* parameterId;
+        float value;
+    };
+
+    struct Render
+    {
+        std::vector<float> output;           // left channel
+        std::vector<int> kernelStages;       // after each block
+        std::vector<int> kernelChainOrders;  // ... and its chain order
+    };
+
+    /**
+     * @brief Render a 100 Hz sine at -6 dBFS through a default instance,
+     * with each change sent as an event at the start of its block
+     */
+    static Render renderWithChanges(std::initializer_list<Change> changes)
+    {
+        FatPressorAudioProcessor processor { FatPressorAudioProcessor::Options::embedded() };
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        const auto input = TestHelpers::makeSine(100.0, sampleRate, numBlocks * blockSize, 0.5f);
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+
+        Render render;
+        render.output.reserve(input.size());
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            for (const auto& change : changes)
+                if (change.block == block)
+                    processor.getParameterEventQueue().add(0, findParameter(processor, change.parameterId), change.value);
+
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                buffer.copyFrom(channel, 0, input.data() + block * blockSize, blockSize);
+
+            processor.processBlock(buffer, midi);
+
+            render.output.insert(render.output.end(), buffer.getReadPointer(0), buffer.getReadPointer(0) + blockSize);
+            render.kernelStages.push_back(processor.getKernelStages());
+            render.kernelChainOrders.push_back(processor.getKernelChainOrder());
+        }
+
+        processor.releaseResources();
+        return render;
+    }
+
+    static int findParameter(juce::AudioProcessor& processor, const juce::String& parameterId)
+    {
+        const auto& parameters = processor.getParameters();
+        for (int index = 0; index < parameters.size(); ++index)
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameters[index]))
+                if (ranged->getParameterID() == parameterId)
+                    return index;
+
+        jassertfalse;
+        return -1;
+    }
+
+    /**
+     * @brief The largest step across a change against the settled signal on either side
+     * The sine moves at most ~0.013 per sample (times the chain's gain); a
+     * change without the fade jumps by the whole difference between the two
+     * paths at the peak, several times that
+     */
+    void expectClickFree(const Render& render, int block, const juce::String& name)
+    {
+        const auto largestStep = [&render](int startSample, int endSample)
+        {
+            return TestHelpers::maxStep(std::vector<float>(render.output.begin() + startSample,
+                                                           render.output.begin() + endSample));
+        };
+
+        const int changeAt = block * blockSize;
+        const int fadeEnd = changeAt + (fadeBlocks + 1) * blockSize;
+        const int settled = 15 * blockSize;   // two periods either side, clear of the fade
+
+        const float before = largestStep(changeAt - settled, changeAt);
+        const float atChange = largestStep(changeAt - 1, fadeEnd);
+        const float after = largestStep(fadeEnd + settled, fadeEnd + 2 * settled);
+
+        expectGreaterThan(juce::jmin(before, after), 0.001f, name + ": signal on both sides");
+        expectLessThan(atChange, juce::jmax(before, after) * 1.5f, name + ": step across the change");
+    }
+};
+
+static StageSwitchTests stageSwitchTests;
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+/**
+ * @brief Shared helpers for the unit tests
+ */
+namespace TestHelpers
+{
+/**
+ * @brief Sine of the given amplitude, starting at phase 0
+ */
+inline std::vector<float> makeSine(double frequency, double sampleRate, int numSamples, float amplitude = 1.0f)
+{
+    std::vector<float> signal(static_cast<size_t>(numSamples));
+    const double omega = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+
+    for (size_t i = 0; i < signal.size(); ++i)
+        signal[i] = amplitude * static_cast<float>(std::sin(omega * static_cast<double>(i)));
+
+    return signal;
+}
+
+/**
+ * @brief Phasor of one frequency over samples [start, end) by single-bin DFT, phase relative to start
+ * Exact when the range holds a whole number of periods.
+ */
+inline std::complex<double> measurePhasor(const std::vector<float>& signal, double frequency, double sampleRate,
+                                          size_t start, size_t end)
+{
+    std::complex<double> sum;
+    const double omega = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+
+    for (size_t i = start; i < end; ++i)
+        sum += static_cast<double>(signal[i]) * std::polar(1.0, -omega * static_cast<double>(i - start));
+
+    return 2.0 * sum / static_cast<double>(end - start);
+}
+
+inline double measureAmplitude(const std::vector<float>& signal, double frequency, double sampleRate,
+                               size_t start, size_t end)
+{
+    return std::abs(measurePhasor(signal, frequency, sampleRate, start, end));
+}
+
+/**
+ * @brief RMS level of samples [start, end) in dB
+ */
+inline double rmsDecibels(const std::vector<float>& signal, size_t start, size_t end)
+{
+    double sum = 0.0;
+    for (size_t i = start; i < end; ++i)
+        sum += static_cast<double>(signal[i]) * signal[i];
+
+    return juce::Decibels::gainToDecibels(std::sqrt(sum / static_cast<double>(end - start)), -200.0);
+}
+
+/**
+ * @brief Largest sample-to-sample step, a cheap click detector
+ */
+inline float maxStep(const std::vector<float>& signal, size_t start = 1)
+{
+    float largest = 0.0f;
+    for (size_t i = juce::jmax<size_t>(1, start); i < signal.size(); ++i)
+        largest = juce::jmax(largest, std::abs(signal[i] - signal[i - 1]));
+    return largest;
+}
+} // namespace TestHelpers
@@ -0,0 +1,160 @@
+#include "../src/dsp/TransformerColoration.h"
+#include "TestHelpers.h"
+
+/**
+ * @brief Transformer stage: one latency on every iron path, aligned path changes, latency only with the core
+ */
+class TransformerColorationTests : public juce::UnitTest
+{
+public:
+    TransformerColorationTests() : juce::UnitTest("Transformer Coloration", "dsp") {}
+
+    void runTest() override
+    {
+        beginTest("Every iron path lines up with the input delayed by the reported latency");
+        {
+            struct Path
+            {
+                const char* name;
+                float amount;
+                bool hysteresis;
+                bool switchedOff;
+            };
+
+            for (const auto& path : { Path { "memoryless", 0.5f, false, false }, Path { "hysteresis core", 0.5f, true, false },
+                                      Path { "bypassed", 0.0f, false, false }, Path { "switched off", 0.5f, true, true } })
+            {
+                Stage stage(path.amount, path.hysteresis);
+                auto signal = TestHelpers::makeSine(frequency, sampleRate, numSamples, 0.25f);
+                const auto input = signal;
+                stage.process(signal, 0, signal.size(), path.switchedOff);
+
+                // The wet output's fundamental against the input's, shifted by the latency
+                const auto latency = stage.transformer.getLatencySamples();
+                const auto output = TestHelpers::measurePhasor(signal, frequency, sampleRate, numSamples / 2, numSamples);
+                const auto expected = TestHelpers::measurePhasor(input, frequency, sampleRate, numSamples / 2 - static_cast<size_t>(latency),
+                                                                 numSamples - static_cast<size_t>(latency));
+
+                const double phaseDegrees = std::abs(std::arg(output / expected)) * 180.0 / juce::MathConstants<double>::pi;
+                expectLessThan(phaseDegrees, 3.0, juce::String(path.name) + " phase against the delayed input");
+            }
+        }
+
+        beginTest("Memoryless/core changes crossfade between aligned signals");
+        {
+            // The core stays enabled; FAT crossing the fallback amount changes the path
+            for (const bool toCore : { true, false })
+            {
+                Stage stage(toCore ? 0.1f : 0.8f, true);
+                auto signal = TestHelpers::makeSine(frequency, sampleRate, numSamples, 0.5f);
+
+                const size_t switchAt = 40 * blockSize;
+                stage.process(signal, 0, switchAt, false);
+                stage.transformer.setAmount(toCore ? 0.8f : 0.1f);
+                stage.process(signal, switchAt, static_cast<size_t>(numSamples), false);
+
+                // Misaligned paths would cancel partly mid-fade; aligned ones keep the level
+                // (less the curve's own level change). A 1 kHz sine at 0.5 moves by at most ~0.065 per sample.
+                const double levelBefore = TestHelpers::rmsDecibels(signal, switchAt - blockSize, switchAt);
+                const double levelDuring = TestHelpers::rmsDecibels(signal, switchAt, switchAt + blockSize);
+                const double levelAfter = TestHelpers::rmsDecibels(signal, switchAt + blockSize, switchAt + 2 * blockSize);
+                expectGreaterThan(levelDuring, juce::jmin(levelBefore, levelAfter) - 0.5, toCore ? "level into the core" : "level out of the core");
+
+                const std::vector<float> around(signal.begin() + static_cast<std::ptrdiff_t>(switchAt - blockSize),
+                                                signal.begin() + static_cast<std::ptrdiff_t>(switchAt + 2 * blockSize));
+                expectLessThan(TestHelpers::maxStep(around), 0.08f, toCore ? "step into the core" : "step out of the core");
+            }
+        }
+
+        beginTest("The latency is only there while the core is enabled, and switches without a click");
+        {
+            for (const bool toCore : { true, false })
+            {
+                Stage stage(0.8f, ! toCore);
+                expectEquals(stage.transformer.getLatencySamples(), toCore ? 0 : stage.transformer.getCoreLatencySamples());
+
+                auto signal = TestHelpers::makeSine(frequency, sampleRate, numSamples, 0.5f);
+                const size_t switchAt = 40 * blockSize;
+                stage.process(signal, 0, switchAt, false);
+                stage.transformer.setHysteresisEnabled(toCore);
+                stage.process(signal, switchAt, static_cast<size_t>(numSamples), false);
+
+                expectEquals(stage.transformer.getLatencySamples(), toCore ? stage.transformer.getCoreLatencySamples() : 0);
+                expectGreaterThan(stage.transformer.getCoreLatencySamples(), 0);
+
+                const std::vector<float> around(signal.begin() + static_cast<std::ptrdiff_t>(switchAt - blockSize),
+                                                signal.begin() + static_cast<std::ptrdiff_t>(switchAt + 2 * blockSize));
+                expectLessThan(TestHelpers::maxStep(around), 0.08f, toCore ? "step into the core" : "step out of the core");
+            }
+        }
+
+        beginTest("The aligned dry copy is the input delayed by the latency, for blocks shorter and longer than it");
+        {
+            for (const size_t subBlockSize : { static_cast<size_t>(16), static_cast<size_t>(blockSize) })
+            {
+                Stage stage(0.5f, true);
+                auto signal = TestHelpers::makeSine(frequency, sampleRate, numSamples / 8, 0.25f);
+                const auto input = signal;
+                const auto latency = static_cast<size_t>(stage.transformer.getLatencySamples());
+                std::vector<float> dry(blockSize);
+                float largestError = 0.0f;
+
+                for (size_t block = 0; block < signal.size(); block += subBlockSize)
+                {
+                    const auto length = juce::jmin(subBlockSize, signal.size() - block);
+                    float* channels[] = { signal.data() + block };
+                    float* dryChannels[] = { dry.data() };
+                    const juce::dsp::AudioBlock<float> audio(channels, 1, length);
+
+                    stage.transformer.copyIronDry(audio, dryChannels);
+                    stage.transformer.processIron(audio);
+
+                    for (size_t sample = 0; sample < length; ++sample)
+                    {
+                        const auto position = block + sample;
+                        const float expected = position >= latency ? input[position - latency] : 0.0f;
+                        largestError = juce::jmax(largestError, std::abs(dry[sample] - expected));
+                    }
+                }
+
+                expectEquals(largestError, 0.0f, "dry copy in " + juce::String(static_cast<int>(subBlockSize)) + "-sample blocks");
+            }
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr double frequency = 1000.0;
+    static constexpr int blockSize = 256;
+    static constexpr size_t numSamples = 48000;
+
+    struct Stage
+    {
+        Stage(float amount, bool hysteresis)
+        {
+            arena.reserve(TransformerColoration::getArenaFloats(blockSize));
+            transformer.setAmount(amount);
+            transformer.setHysteresisEnabled(hysteresis);
+            transformer.prepare(sampleRate, blockSize, arena);
+        }
+
+        void process(std::vector<float>& signal, size_t start, size_t end, bool ironSwitchedOff)
+        {
+            for (size_t block = start; block < end; block += blockSize)
+            {
+                float* channels[] = { signal.data() + block };
+                const juce::dsp::AudioBlock<float> audio(channels, 1, juce::jmin<size_t>(blockSize, end - block));
+
+                if (ironSwitchedOff)
+                    transformer.processIronBypassed(audio);
+                else
+                    transformer.processIron(audio);
+            }
+        }
+
+        DspArena arena;
+        TransformerColoration transformer;
+    };
+};
+
+static TransformerColorationTests transformerColorationTests;
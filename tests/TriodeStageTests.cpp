@@ -0,0 +1,78 @@
+#include "../src/dsp/TriodeStage.h"
+#include "TestHelpers.h"
+
+/**
+ * @brief Triode stage: small-signal unity gain, grid-current clipping, lane independence
+ */
+class TriodeStageTests : public juce::UnitTest
+{
+public:
+    TriodeStageTests() : juce::UnitTest("Triode Stage", "dsp") {}
+
+    void runTest() override
+    {
+        beginTest("Quiet material passes at unity");
+        {
+            for (const float drive : { 0.3f, 1.0f })
+            {
+                auto signal = TestHelpers::makeSine(1000.0, sampleRate, numSamples, 0.01f);
+                process(signal, drive);
+
+                const double gain = TestHelpers::measureAmplitude(signal, 1000.0, sampleRate, numSamples / 2, numSamples) / 0.01;
+                expectWithinAbsoluteError(juce::Decibels::gainToDecibels(gain), 0.0, 0.5, "small-signal gain");
+            }
+        }
+
+        beginTest("Grid current clips positive grid swings");
+        {
+            // Output is non-inverting: a positive grid swing is a positive output peak
+            const float peakAtHalf = positivePeak(0.5f);
+            const float peakAtFull = positivePeak(1.0f);
+
+            expectLessThan(peakAtFull, 0.5f, "positive peak held near Vgk = 0");
+            expectLessThan(peakAtFull, peakAtHalf * 1.15f, "positive peak barely grows with 6 dB more drive");
+        }
+
+        beginTest("Channels are independent lanes");
+        {
+            auto left = TestHelpers::makeSine(100.0, sampleRate, numSamples, 0.9f);
+            auto right = TestHelpers::makeSine(330.0, sampleRate, numSamples, 0.4f);
+            auto leftAlone = left;
+            auto rightAlone = right;
+
+            TriodeStage stereo;
+            stereo.prepare(sampleRate, numSamples);
+            stereo.setDrive(1.0f);
+            float* channels[] = { left.data(), right.data() };
+            stereo.process(channels, 2, numSamples);
+
+            process(leftAlone, 1.0f);
+            process(rightAlone, 1.0f);
+
+            expect(left == leftAlone && right == rightAlone, "stereo lanes match mono runs bit for bit");
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int numSamples = 48000;
+
+    static void process(std::vector<float>& signal, float drive)
+    {
+        TriodeStage triode;
+        triode.prepare(sampleRate, numSamples);
+        triode.setDrive(drive);
+
+        float* channels[] = { signal.data() };
+        triode.process(channels, 1, static_cast<int>(signal.size()));
+    }
+
+    static float positivePeak(float amplitude)
+    {
+        auto signal = TestHelpers::makeSine(100.0, sampleRate, numSamples, amplitude);
+        process(signal, 1.0f);
+        return *std::max_element(signal.begin() + numSamples / 2, signal.end());
+    }
+};
+
+static TriodeStageTests triodeStageTests;
@@ -0,0 +1,134 @@
+#include "../src/dsp/TubeSaturation.h"
+#include "TestHelpers.h"
+
+/**
+ * @brief Tube stage: Harmonic-mode calibration measured at the stage output,
+ * and click-free mode changes
+ */
+class TubeSaturationTests : public juce::UnitTest
+{
+public:
+    TubeSaturationTests() : juce::UnitTest("Tube Saturation", "dsp") {}
+
+    void runTest() override
+    {
+        beginTest("Harmonic mode levels hold at the stage output");
+        {
+            // At the calibration frequency the spec levels are exact
+            for (const float drive : { 0.5f, 1.0f })
+            {
+                const auto levels = measureHarmonics(100.0, drive);
+                const double secondDb = drive < 0.75f ? -40.0 : -18.0;
+
+                expectWithinAbsoluteError(levels[0], secondDb, 0.25, "2nd harmonic");
+                expectWithinAbsoluteError(levels[1], secondDb - 14.0, 0.25, "3rd harmonic");
+                expectWithinAbsoluteError(levels[2], secondDb - 9.1, 0.25, "4th harmonic");
+                expectWithinAbsoluteError(levels[3], secondDb - 20.0, 0.25, "6th harmonic");
+            }
+
+            // Across the band the saturation is aimed at, within a dB
+            for (const double frequency : { 50.0, 200.0 })
+                for (const float drive : { 0.5f, 1.0f })
+                    expectWithinAbsoluteError(measureHarmonics(frequency, drive)[0], drive < 0.75f ? -40.0 : -18.0, 1.0,
+                                              "2nd harmonic off the calibration frequency");
+        }
+
+        beginTest("Mode changes are crossfaded");
+        {
+            using Mode = TubeSaturation::Mode;
+
+            for (const auto [from, to] : { std::pair { Mode::classic, Mode::triode },
+                                           std::pair { Mode::triode, Mode::harmonic },
+                                           std::pair { Mode::harmonic, Mode::classic } })
+            {
+                // A 100 Hz sine moves at most ~0.013 per sample at 0.5 amplitude;
+                // a hard switch between shapers jumps by far more than that
+                const auto steps = switchModes(from, to);
+                expectLessThan(steps.atSwitch, juce::jmax(steps.before, steps.after) * 1.5f, "step across the mode change");
+            }
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512;
+
+    struct Stage
+    {
+        explicit Stage(float drive, TubeSaturation::Mode mode)
+        {
+            arena.reserve(TubeSaturation::getArenaFloats(blockSize));
+            tube.setDrive(drive);
+            tube.setMode(mode);
+            tube.prepare(sampleRate, blockSize, arena);
+        }
+
+        void process(std::vector<float>& signal, size_t start, size_t end)
+        {
+            for (size_t block = start; block < end; block += blockSize)
+            {
+                float* channels[] = { signal.data() + block };
+                tube.processBlock(juce::dsp::AudioBlock<float>(channels, 1, juce::jmin<size_t>(blockSize, end - block)));
+            }
+        }
+
+        DspArena arena;
+        TubeSaturation tube;
+    };
+
+    /**
+     * @brief 2nd/3rd/4th/6th harmonic relative to the output fundamental, in dB
+     */
+    static std::array<double, 4> measureHarmonics(double frequency, float drive)
+    {
+        const int numSamples = static_cast<int>(sampleRate);
+        auto signal = TestHelpers::makeSine(frequency, sampleRate, numSamples);
+
+        Stage stage(drive, TubeSaturation::Mode::harmonic);
+        stage.process(signal, 0, signal.size());
+
+        // Last half second: settled filters, whole periods of every frequency tested
+        const auto start = signal.size() / 2;
+        const double fundamental = TestHelpers::measureAmplitude(signal, frequency, sampleRate, start, signal.size());
+
+        std::array<double, 4> levels {};
+        const int orders[] = { 2, 3, 4, 6 };
+        for (size_t i = 0; i < levels.size(); ++i)
+            levels[i] = juce::Decibels::gainToDecibels(
+                TestHelpers::measureAmplitude(signal, frequency * orders[i], sampleRate, start, signal.size()) / fundamental,
+                -200.0);
+
+        return levels;
+    }
+
+    struct Steps
+    {
+        float before, atSwitch, after;
+    };
+
+    /**
+     * @brief Largest sample step before, around and after a mode change
+     */
+    static Steps switchModes(TubeSaturation::Mode from, TubeSaturation::Mode to)
+    {
+        const size_t switchAt = 24 * blockSize;
+        const size_t fadeEnd = switchAt + 4 * blockSize;
+        auto signal = TestHelpers::makeSine(100.0, sampleRate, static_cast<int>(switchAt * 2), 0.5f);
+
+        Stage stage(1.0f, from);
+        stage.process(signal, 0, switchAt);
+        stage.tube.setMode(to);
+        stage.process(signal, switchAt, signal.size());
+
+        const auto largestStep = [&signal](size_t start, size_t end)
+        {
+            return TestHelpers::maxStep(std::vector<float>(signal.begin() + static_cast<std::ptrdiff_t>(start),
+                                                           signal.begin() + static_cast<std::ptrdiff_t>(end)));
+        };
+
+        return { largestStep(switchAt / 2, switchAt), largestStep(switchAt - 1, fadeEnd),
+                 largestStep(fadeEnd, signal.size()) };
+    }
+};
+
+static TubeSaturationTests tubeSaturationTests;
@@ -0,0 +1,53 @@
+#include "../src/dsp/TubeSaturation.h"
+#include "../src/dsp/WaveshaperTable.h"
+#include "TestHelpers.h"
+#include <thread>
+
+/**
+ * @brief Background table rebuilds: the shared builder sleeps until a set queues one
+ */
+class WaveshaperTableTests : public juce::UnitTest
+{
+public:
+    WaveshaperTableTests() : juce::UnitTest("Waveshaper Table", "dsp") {}
+
+    void runTest() override
+    {
+        beginTest("A queued rebuild wakes the builder and is handed off");
+        {
+            WaveshaperTableSet tables;
+            tables.prepare(sampleRate, &TubeSaturation::transferCurve, SharedTableCache::Type::tubeCurve, 0.2f);
+
+            // Each drive change is one wake-up; the builder sleeps in between
+            for (const float drive : { 0.6f, 0.35f, 0.9f })
+            {
+                const int handOffsBefore = tables.getHandOffCount();
+                tables.requestDrive(drive);
+
+                const auto deadline = juce::Time::getMillisecondCounter() + 2000;
+                while (tables.getHandOffCount() == handOffsBefore && juce::Time::getMillisecondCounter() < deadline)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    tables.beginBlock();
+                    tables.endBlock(blockSize);
+                }
+
+                expectEquals(tables.getHandOffCount(), handOffsBefore + 1, "hand-off for drive " + juce::String(drive));
+                expectWithinAbsoluteError(tables.getCurrentDrive(), drive, 0.001f);
+
+                // Let the crossfade finish before the next request
+                for (int block = 0; block < 64; ++block)
+                {
+                    tables.beginBlock();
+                    tables.endBlock(blockSize);
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 64;
+};
+
+static WaveshaperTableTests waveshaperTableTests;
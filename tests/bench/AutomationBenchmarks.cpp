@@ -0,0 +1,94 @@
+#include "../../src/PluginProcessor.h"
+#include "Benchmark.h"
+
+/**
+ * @brief Whole processor under dense sample-accurate automation
+ *
+ * Events go through the parameter event queue, as the CLAP glue delivers
+ * them: each event splits the block and starts a smoothing ramp. The cases
+ * go from none to five controls changing every 16 samples, which keeps the
+ * compressor and FAT ramps running through the whole block.
+ */
+class AutomationBenchmarks : public Benchmark
+{
+public:
+    AutomationBenchmarks() : Benchmark("automation") {}
+
+    void run() override
+    {
+        struct Case
+        {
+            const char* name;
+            int eventSpacing;      // samples between event rows, 0 = no automation
+            int numParameters;     // parameters changed per row
+        };
+
+        const Case cases[] = {
+            { "no automation", 0, 0 },
+            { "1 event per block", blockSize, 1 },
+            { "5 controls every 128 samples", 128, 5 },
+            { "5 controls every 64 samples", 64, 5 },
+            { "5 controls every 16 samples", 16, 5 },
+        };
+
+        for (const auto& automation : cases)
+        {
+            FatPressorAudioProcessor processor;
+            processor.setSessionCaptureEnabled(false);
+            processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+            processor.prepareToPlay(sampleRate, blockSize);
+
+            const auto targets = findTargets(processor);
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::MidiBuffer midi;
+            int row = 0;
+
+            report(automation.name, timePerSample([&](float* data, int numSamples)
+            {
+                buffer.copyFrom(0, 0, data, numSamples);
+                buffer.copyFrom(1, 0, data, numSamples);
+
+                auto& queue = processor.getParameterEventQueue();
+                for (int offset = 0; automation.eventSpacing > 0 && offset < numSamples; offset += automation.eventSpacing, ++row)
+                    for (int parameter = 0; parameter < automation.numParameters; ++parameter)
+                    {
+                        const auto& target = targets[static_cast<size_t>(parameter)];
+                        queue.add(offset, target.index, (row & 1) != 0 ? target.high : target.low);
+                    }
+
+                processor.processBlock(buffer, midi);
+            }, 5, 400) / 2.0);
+        }
+    }
+
+private:
+    struct Target
+    {
+        int index;
+        float low, high;
+    };
+
+    /**
+     * @brief Parameters automated, in getParameters() order, with the two values they alternate between
+     */
+    static std::array<Target, 5> findTargets(juce::AudioProcessor& processor)
+    {
+        const std::tuple<const char*, float, float> ranges[] = {
+            { "threshold", -30.0f, -18.0f }, { "ratio", 3.0f, 6.0f }, { "attack", 5.0f, 20.0f },
+            { "release", 80.0f, 200.0f }, { "fat", 30.0f, 70.0f },
+        };
+
+        std::array<Target, 5> targets {};
+        const auto& parameters = processor.getParameters();
+
+        for (size_t target = 0; target < targets.size(); ++target)
+            for (int index = 0; index < parameters.size(); ++index)
+                if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameters[index]))
+                    if (ranged->getParameterID() == std::get<0>(ranges[target]))
+                        targets[target] = { index, std::get<1>(ranges[target]), std::get<2>(ranges[target]) };
+
+        return targets;
+    }
+};
+
+static AutomationBenchmarks automationBenchmarks;
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Minimal micro-benchmark registry for fatpressor-bench
+ *
+ * Each Benchmark registers itself statically (like juce::UnitTest) and
+ * reports one line per case through report(). Timing runs a block-processing
+ * function over a fixed-length signal until enough wall time has passed and
+ * keeps the fastest of several rounds, which is the least noisy figure on a
+ * busy machine.
+ */
+class Benchmark
+{
+public:
+    using BlockFunction = std::function<void(float* data, int numSamples)>;
+
+    explicit Benchmark(const char* benchmarkName) : name(benchmarkName) { getAll().push_back(this); }
+    virtual ~Benchmark() = default;
+
+    virtual void run() = 0;
+
+    const char* getName() const { return name; }
+
+    static std::vector<Benchmark*>& getAll()
+    {
+        static std::vector<Benchmark*> benchmarks;
+        return benchmarks;
+    }
+
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512;
+
+protected:
+    /**
+     * @brief Fastest time per sample of process over a noisy test signal, in ns
+     */
+    static double timePerSample(const BlockFunction& process, int rounds = 5, int blocksPerRound = 2000)
+    {
+        std::vector<float> source(static_cast<size_t>(blockSize));
+        juce::Random random(1);
+        for (auto& sample : source)
+            sample = random.nextFloat() * 1.6f - 0.8f;
+
+        std::vector<float> data(source.size());
+        double best = 1.0e30;
+
+        for (int round = 0; round < rounds; ++round)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            for (int block = 0; block < blocksPerRound; ++block)
+            {
+                std::copy(source.begin(), source.end(), data.begin());
+                process(data.data(), blockSize);
+            }
+            const auto ticks = juce::Time::getHighResolutionTicks() - start;
+
+            const double seconds = static_cast<double>(ticks) / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+            best = juce::jmin(best, seconds * 1.0e9 / (static_cast<double>(blocksPerRound) * blockSize));
+        }
+
+        return best;
+    }
+
+    /**
+     * @brief One result line: case, ns per sample and share of one core per channel at 48 kHz
+     */
+    void report(const char* caseName, double nsPerSample) const
+    {
+        std::printf("%-12s %-32s %9.2f ns/sample  %7.3f%% of a core per channel\n", name, caseName, nsPerSample,
+                    nsPerSample * sampleRate * 1.0e-7);
+    }
+
+private:
+    const char* name;
+};
@@ -0,0 +1,65 @@
+#include "../../src/dsp/CompressorLaneEngine.h"
+#include "../../src/dsp/EnvelopeFollower.h"
+#include "../../src/dsp/GainComputer.h"
+#include "../../src/dsp/SidechainDetector.h"
+#include "Benchmark.h"
+
+/**
+ * @brief Lane engine vs the scalar detector → envelope → gain computer chain, per track
+ */
+class LaneBenchmarks : public Benchmark
+{
+public:
+    LaneBenchmarks() : Benchmark("lanes") {}
+
+    void run() override
+    {
+        {
+            DspArena arena;
+            arena.reserve(SidechainDetector::getArenaFloats(sampleRate));
+
+            SidechainDetector detector;
+            EnvelopeFollower envelope;
+            GainComputer gainComputer;
+            detector.prepare(sampleRate, blockSize, arena);
+            envelope.prepare(sampleRate, blockSize);
+            gainComputer.prepare(sampleRate, blockSize);
+            gainComputer.setThreshold(-20.0f);
+            gainComputer.setRatio(4.0f);
+            gainComputer.setKneeWidth(6.0f);
+
+            report("scalar chain, 1 track", timePerSample([&](float* data, int numSamples)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const float grDb = gainComputer.processSample(envelope.processSample(detector.processSample(data[i], data[i])));
+                    data[i] *= juce::Decibels::decibelsToGain(grDb);
+                }
+            }));
+        }
+
+        // Per track; each track gets a copy of the block (mono, left == right),
+        // so the figures include that copy
+        for (const int numLanes : { 1, 4, 8, 16, 32, 64 })
+        {
+            CompressorLaneEngine engine;
+            engine.prepare(sampleRate, blockSize, numLanes);
+
+            std::vector<std::vector<float>> tracks(static_cast<size_t>(numLanes), std::vector<float>(static_cast<size_t>(blockSize)));
+            std::vector<float*> channels;
+            for (auto& track : tracks)
+                channels.push_back(track.data());
+
+            const auto name = "engine, " + juce::String(numLanes) + (numLanes == 1 ? " lane" : " lanes") + " (per track)";
+            report(name.toRawUTF8(), timePerSample([&](float* data, int numSamples)
+            {
+                for (auto& track : tracks)
+                    std::copy(data, data + numSamples, track.begin());
+
+                engine.process(channels.data(), channels.data(), numSamples);
+            }, 5, 2000 / numLanes + 10) / numLanes);
+        }
+    }
+};
+
+static LaneBenchmarks laneBenchmarks;
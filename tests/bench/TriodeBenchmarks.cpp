@@ -0,0 +1,39 @@
+#include "../../src/dsp/TriodeStage.h"
+#include "Benchmark.h"
+
+/**
+ * @brief Wave-digital triode: mono vs stereo lanes, with and without grid current
+ */
+class TriodeBenchmarks : public Benchmark
+{
+public:
+    TriodeBenchmarks() : Benchmark("triode") {}
+
+    void run() override
+    {
+        // FAT 10%: the grid never conducts; FAT 100%: it does on most peaks
+        for (const auto& [drive, label] : { std::pair { 0.1f, "FAT 10%" }, std::pair { 1.0f, "FAT 100%" } })
+        {
+            TriodeStage triode;
+            triode.prepare(sampleRate, blockSize);
+            triode.setDrive(drive);
+
+            report((juce::String("mono, ") + label).toRawUTF8(), timePerSample([&triode](float* data, int numSamples)
+            {
+                float* channels[] = { data };
+                triode.process(channels, 1, numSamples);
+            }));
+
+            std::vector<float> second(static_cast<size_t>(blockSize));
+            report((juce::String("stereo (per channel), ") + label).toRawUTF8(),
+                   timePerSample([&triode, &second](float* data, int numSamples)
+            {
+                std::copy(data, data + numSamples, second.begin());
+                float* channels[] = { data, second.data() };
+                triode.process(channels, 2, numSamples);
+            }) / 2.0);
+        }
+    }
+};
+
+static TriodeBenchmarks triodeBenchmarks;
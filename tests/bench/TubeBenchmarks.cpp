@@ -0,0 +1,58 @@
+#include "../../src/dsp/TubeSaturation.h"
+#include "Benchmark.h"
+
+/**
+ * @brief Tube waveshapers: direct tanh curve vs baked table vs Chebyshev synthesis,
+ * and the whole stage per mode
+ */
+class TubeBenchmarks : public Benchmark
+{
+public:
+    TubeBenchmarks() : Benchmark("tube") {}
+
+    void run() override
+    {
+        constexpr float drive = 0.7f;
+
+        report("tanh curve (direct)", timePerSample([](float* data, int numSamples)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                data[i] = TubeSaturation::transferCurve(data[i], drive);
+        }));
+
+        WaveshaperTable table;
+        table.build(&TubeSaturation::transferCurve, drive);
+        report("tanh curve (baked table)", timePerSample([&table](float* data, int numSamples)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                data[i] = table.lookup(data[i]);
+        }));
+
+        ChebyshevHarmonics harmonics;
+        harmonics.setDrive(drive);
+        report("chebyshev (SIMD block)", timePerSample([&harmonics](float* data, int numSamples)
+        {
+            harmonics.processBlock(data, numSamples);
+        }));
+
+        for (const auto& [mode, caseName] : { std::pair { TubeSaturation::Mode::classic, "stage, classic" },
+                                              std::pair { TubeSaturation::Mode::harmonic, "stage, harmonic" },
+                                              std::pair { TubeSaturation::Mode::triode, "stage, triode" } })
+        {
+            DspArena arena;
+            arena.reserve(TubeSaturation::getArenaFloats(blockSize));
+            TubeSaturation tube;
+            tube.setDrive(drive);
+            tube.setMode(mode);
+            tube.prepare(sampleRate, blockSize, arena);
+
+            report(caseName, timePerSample([&tube](float* data, int numSamples)
+            {
+                float* channels[] = { data };
+                tube.processBlock(juce::dsp::AudioBlock<float>(channels, 1, static_cast<size_t>(numSamples)));
+            }));
+        }
+    }
+};
+
+static TubeBenchmarks tubeBenchmarks;
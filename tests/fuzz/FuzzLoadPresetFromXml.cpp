@@ -0,0 +1,20 @@
+#include "FuzzProcessor.h"
+
+/**
+ * fuzz_loadPresetFromXml - preset files (XML text) into PresetManager::loadPresetFromXml()
+ */
+extern "C" int LLVMFuzzerTestOneInput(const juce::uint8* data, size_t size)
+{
+    if (size > 1 << 20)
+        return 0;
+
+    auto& fuzz = FuzzProcessor::get();
+    auto& processor = fuzz.begin();
+
+    const auto text = juce::String::fromUTF8(reinterpret_cast<const char*>(data), static_cast<int>(size));
+    if (const auto xml = juce::XmlDocument::parse(text))
+        processor.presetManager.loadPresetFromXml(*xml);
+
+    fuzz.renderAndCheck();
+    return 0;
+}
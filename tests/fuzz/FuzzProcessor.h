@@ -0,0 +1,63 @@
+#pragma once
+
+#include "../../src/PluginProcessor.h"
+#include <cmath>
+#include <cstdlib>
+
+/**
+ * @brief The processor every fuzz input runs through
+ *
+ * Created once (JUCE initialised, embedded options so nothing is written
+ * outside the instance, prepared for stereo at 48 kHz). Each
+ * input starts from the default state, is loaded by the entry point under
+ * test, then one block of noise is rendered: a loader that lets a bad value
+ * through shows up as non-finite output, which aborts like a sanitizer
+ * report so libFuzzer keeps the input.
+ */
+class FuzzProcessor
+{
+public:
+    static FuzzProcessor& get()
+    {
+        static FuzzProcessor instance;
+        return instance;
+    }
+
+    FatPressorAudioProcessor& begin()
+    {
+        processor.setStateInformation(defaultState.getData(), static_cast<int>(defaultState.getSize()));
+        return processor;
+    }
+
+    void renderAndCheck()
+    {
+        juce::Random random(1);
+        for (int channel = 0; channel < block.getNumChannels(); ++channel)
+            for (int sample = 0; sample < block.getNumSamples(); ++sample)
+                block.setSample(channel, sample, random.nextFloat() - 0.5f);
+
+        processor.processBlock(block, midi);
+
+        for (int channel = 0; channel < block.getNumChannels(); ++channel)
+            for (int sample = 0; sample < block.getNumSamples(); ++sample)
+                if (! std::isfinite(block.getSample(channel, sample)))
+                    std::abort();
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 256;
+
+    FuzzProcessor()
+    {
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+        processor.getStateInformation(defaultState);
+    }
+
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    FatPressorAudioProcessor processor { FatPressorAudioProcessor::Options::embedded() };
+    juce::MemoryBlock defaultState;
+    juce::AudioBuffer<float> block { 2, blockSize };
+    juce::MidiBuffer midi;
+};
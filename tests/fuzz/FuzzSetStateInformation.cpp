@@ -0,0 +1,15 @@
+#include "FuzzProcessor.h"
+
+/**
+ * fuzz_setStateInformation - host state chunks (binary XML) into setStateInformation()
+ */
+extern "C" int LLVMFuzzerTestOneInput(const juce::uint8* data, size_t size)
+{
+    if (size > 1 << 20)
+        return 0;
+
+    auto& fuzz = FuzzProcessor::get();
+    fuzz.begin().setStateInformation(data, static_cast<int>(size));
+    fuzz.renderAndCheck();
+    return 0;
+}
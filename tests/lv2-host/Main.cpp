@@ -0,0 +1,161 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_events/juce_events.h>
+#include <iostream>
+
+/**
+ * fatpressor-lv2-host-test - loads the headless LV2 build like a render node would
+ *
+ *   fatpressor-lv2-host-test <directory containing FatPressor Headless.lv2>
+ *
+ * Stand-in for an LV2 host (JUCE's lilv-based LV2 hosting): finds the
+ * plugin by its URI, checks that it has no editor, renders a stereo sine
+ * and checks the output, then restores the state of one instance into a
+ * second one and checks that both render the same. Prints one line per
+ * check; exit code 0 when all passed, 1 when any failed, 2 when the plugin
+ * could not be loaded.
+ */
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 512;
+constexpr int numBlocks = 94;   // about a second
+const char* const pluginUri = "urn:sylfo:fatpressor-headless";
+
+struct Checks
+{
+    int failures = 0;
+
+    void check(bool passed, const juce::String& name, const juce::String& detail = {})
+    {
+        std::cout << (passed ? "PASS " : "FAIL ") << name;
+        if (detail.isNotEmpty())
+            std::cout << " (" << detail << ")";
+        std::cout << std::endl;
+
+        if (! passed)
+            ++failures;
+    }
+};
+
+juce::AudioBuffer<float> render(juce::AudioPluginInstance& plugin)
+{
+    plugin.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+    plugin.prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> output(2, blockSize * numBlocks), block(2, blockSize);
+    juce::MidiBuffer midi;
+
+    for (int start = 0; start < output.getNumSamples(); start += blockSize)
+    {
+        for (int sample = 0; sample < blockSize; ++sample)
+        {
+            const auto phase = juce::MathConstants<double>::twoPi * 220.0 * (start + sample) / sampleRate;
+            block.setSample(0, sample, static_cast<float>(0.5 * std::sin(phase)));
+            block.setSample(1, sample, static_cast<float>(0.3 * std::sin(phase * 1.5)));
+        }
+
+        plugin.processBlock(block, midi);
+
+        for (int channel = 0; channel < 2; ++channel)
+            output.copyFrom(channel, start, block, channel, 0, blockSize);
+    }
+
+    plugin.releaseResources();
+    return output;
+}
+
+bool isFiniteAndAudible(const juce::AudioBuffer<float>& buffer)
+{
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+            if (! std::isfinite(buffer.getSample(channel, sample)))
+                return false;
+
+    return buffer.getMagnitude(0, buffer.getNumSamples()) > 0.01f;
+}
+
+/**
+ * @brief Largest difference between two renders, in dB relative to full scale
+ */
+float differenceDecibels(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+{
+    float largest = 0.0f;
+    for (int channel = 0; channel < a.getNumChannels(); ++channel)
+        for (int sample = 0; sample < a.getNumSamples(); ++sample)
+            largest = juce::jmax(largest, std::abs(a.getSample(channel, sample) - b.getSample(channel, sample)));
+
+    return juce::Decibels::gainToDecibels(largest, -200.0f);
+}
+
+juce::RangedAudioParameter* findParameter(juce::AudioPluginInstance& plugin, const juce::String& name)
+{
+    for (auto* parameter : plugin.getParameters())
+        if (parameter->getName(64) == name)
+            return dynamic_cast<juce::RangedAudioParameter*>(parameter);
+
+    return nullptr;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::cerr << "usage: fatpressor-lv2-host-test <directory containing the .lv2 bundle>" << std::endl;
+        return 2;
+    }
+
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const auto searchDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(argv[1]);
+    juce::LV2PluginFormat format;
+    juce::OwnedArray<juce::PluginDescription> descriptions;
+
+    for (const auto& identifier : format.searchPathsForPlugins(juce::FileSearchPath(searchDirectory.getFullPathName()), true, false))
+        if (identifier == pluginUri)
+            format.findAllTypesForFile(descriptions, identifier);
+
+    if (descriptions.isEmpty())
+    {
+        std::cerr << "no " << pluginUri << " under " << searchDirectory.getFullPathName() << std::endl;
+        return 2;
+    }
+
+    juce::String error;
+    auto first = format.createInstanceFromDescription(*descriptions[0], sampleRate, blockSize, error);
+    auto second = format.createInstanceFromDescription(*descriptions[0], sampleRate, blockSize, error);
+    if (first == nullptr || second == nullptr)
+    {
+        std::cerr << "cannot instantiate " << pluginUri << ": " << error << std::endl;
+        return 2;
+    }
+
+    Checks checks;
+    checks.check(! first->hasEditor(), "no editor");
+
+    // Non-default settings, so the state round trip has something to carry
+    auto* threshold = findParameter(*first, "Threshold");
+    auto* fat = findParameter(*first, "FAT");
+    checks.check(threshold != nullptr && fat != nullptr, "parameters exposed", juce::String(first->getParameters().size()) + " parameters");
+
+    if (threshold != nullptr && fat != nullptr)
+    {
+        threshold->setValueNotifyingHost(threshold->convertTo0to1(-35.0f));
+        fat->setValueNotifyingHost(fat->convertTo0to1(80.0f));
+    }
+
+    juce::MemoryBlock state;
+    first->getStateInformation(state);
+    second->setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+
+    const auto firstOutput = render(*first);
+    const auto secondOutput = render(*second);
+
+    checks.check(isFiniteAndAudible(firstOutput), "renders finite, audible output");
+    checks.check(first->getLatencySamples() >= 0, "reports latency", juce::String(first->getLatencySamples()) + " samples");
+
+    const auto difference = differenceDecibels(firstOutput, secondOutput);
+    checks.check(difference < -100.0f, "restored state renders the same", juce::String(difference, 1) + " dB");
+
+    return checks.failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,366 @@
+#include <juce_core/juce_core.h>
+#include <clap/clap.h>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+/**
+ * fatpressor-clap-host - headless CLAP host that checks the CLAP build
+ *
+ *   fatpressor-clap-host <FatPressor.clap>
+ *
+ * Loads the plugin through its clap_entry like a DAW would, renders a
+ * stereo sine with scripted parameter events and checks:
+ *   - a value event takes effect on its sample, not at the block start
+ *   - the plugin does not echo host-sent values back as output events
+ *   - event values are written back (params.get_value reports them)
+ *   - modulation changes the sound but never the parameter value
+ *
+ * Prints one line per check. Exit code 0 when all passed, 1 when any
+ * failed, 2 when the plugin could not be loaded.
+ */
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 512;
+constexpr int numBlocks = 16;
+constexpr int eventTime = 300;
+
+/**
+ * @brief CLAP ids of the JUCE parameters (clap-juce-extensions hashes the parameter ID)
+ */
+clap_id clapIdFor(const char* parameterId)
+{
+    return static_cast<clap_id>(juce::String(parameterId).hashCode());
+}
+
+union AnyEvent
+{
+    clap_event_header_t header;
+    clap_event_param_value_t value;
+    clap_event_param_mod_t mod;
+};
+
+/**
+ * @brief One block's input events, in time order
+ */
+struct InputEvents
+{
+    std::vector<AnyEvent> events;
+    clap_input_events_t list { this, &size, &get };
+
+    void addValue(uint32_t time, clap_id parameter, double value)
+    {
+        AnyEvent event {};
+        event.value.header = { sizeof(clap_event_param_value_t), time, CLAP_CORE_EVENT_SPACE_ID, CLAP_EVENT_PARAM_VALUE, 0 };
+        event.value.param_id = parameter;
+        event.value.note_id = event.value.port_index = event.value.channel = event.value.key = -1;
+        event.value.value = value;
+        events.push_back(event);
+    }
+
+    void addModulation(uint32_t time, clap_id parameter, double amount)
+    {
+        AnyEvent event {};
+        event.mod.header = { sizeof(clap_event_param_mod_t), time, CLAP_CORE_EVENT_SPACE_ID, CLAP_EVENT_PARAM_MOD, 0 };
+        event.mod.param_id = parameter;
+        event.mod.note_id = event.mod.port_index = event.mod.channel = event.mod.key = -1;
+        event.mod.amount = amount;
+        events.push_back(event);
+    }
+
+    static uint32_t CLAP_ABI size(const clap_input_events_t* list)
+    {
+        return static_cast<uint32_t>(static_cast<const InputEvents*>(list->ctx)->events.size());
+    }
+
+    static const clap_event_header_t* CLAP_ABI get(const clap_input_events_t* list, uint32_t index)
+    {
+        return &static_cast<const InputEvents*>(list->ctx)->events[index].header;
+    }
+};
+
+/**
+ * @brief Counts what the plugin sends back to the host
+ */
+struct OutputEvents
+{
+    int parameterValues = 0;
+    int gestures = 0;
+    clap_output_events_t list { this, &tryPush };
+
+    static bool CLAP_ABI tryPush(const clap_output_events_t* list, const clap_event_header_t* event)
+    {
+        auto* self = static_cast<OutputEvents*>(list->ctx);
+        if (event->space_id == CLAP_CORE_EVENT_SPACE_ID)
+        {
+            if (event->type == CLAP_EVENT_PARAM_VALUE)
+                ++self->parameterValues;
+            else if (event->type == CLAP_EVENT_PARAM_GESTURE_BEGIN || event->type == CLAP_EVENT_PARAM_GESTURE_END)
+                ++self->gestures;
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief Events for one block of a scenario
+ */
+using Script = std::function<void(int block, InputEvents& events)>;
+
+struct Render
+{
+    std::vector<float> left, right;
+    OutputEvents output;
+    double thresholdAfter = 0.0;
+};
+
+/**
+ * @brief The host: one plugin instance at a time, called from this thread only
+ */
+class Host
+{
+public:
+    explicit Host(const clap_plugin_factory_t& pluginFactory) : factory(pluginFactory)
+    {
+        host.host_data = this;
+        host.get_extension = &getExtension;
+        host.request_restart = [](const clap_host_t*) {};
+        host.request_process = [](const clap_host_t*) {};
+        host.request_callback = [](const clap_host_t* h) { fromHost(h).callbackRequested = true; };
+    }
+
+    /**
+     * @brief Render a stereo sine through a fresh instance, feeding the script's events
+     */
+    bool render(const Script& script, Render& result)
+    {
+        const auto* descriptor = factory.get_plugin_descriptor(&factory, 0);
+        plugin = descriptor != nullptr ? factory.create_plugin(&factory, &host, descriptor->id) : nullptr;
+        if (plugin == nullptr || ! plugin->init(plugin))
+            return false;
+
+        const auto* params = static_cast<const clap_plugin_params_t*>(plugin->get_extension(plugin, CLAP_EXT_PARAMS));
+
+        if (params == nullptr || ! plugin->activate(plugin, sampleRate, 1, blockSize))
+        {
+            plugin->destroy(plugin);
+            return false;
+        }
+
+        std::vector<float> inputLeft(blockSize), inputRight(blockSize), outputLeft(blockSize), outputRight(blockSize);
+        float* inputs[] = { inputLeft.data(), inputRight.data() };
+        float* outputs[] = { outputLeft.data(), outputRight.data() };
+
+        clap_audio_buffer_t inputBuffer { inputs, nullptr, 2, 0, 0 };
+        clap_audio_buffer_t outputBuffer { outputs, nullptr, 2, 0, 0 };
+
+        audioThread = true;
+        plugin->start_processing(plugin);
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            for (int sample = 0; sample < blockSize; ++sample)
+            {
+                const auto phase = juce::MathConstants<double>::twoPi * 220.0 * (block * blockSize + sample) / sampleRate;
+                inputLeft[static_cast<size_t>(sample)] = static_cast<float>(0.5 * std::sin(phase));
+                inputRight[static_cast<size_t>(sample)] = static_cast<float>(0.3 * std::sin(phase * 1.5));
+            }
+
+            InputEvents events;
+            script(block, events);
+
+            clap_process_t process {};
+            process.steps_count = static_cast<int64_t>(block) * blockSize;
+            process.frames_count = blockSize;
+            process.audio_inputs = &inputBuffer;
+            process.audio_outputs = &outputBuffer;
+            process.audio_inputs_count = 1;
+            process.audio_outputs_count = 1;
+            process.in_events = &events.list;
+            process.out_events = &result.output.list;
+
+            plugin->process(plugin, &process);
+
+            result.left.insert(result.left.end(), outputLeft.begin(), outputLeft.end());
+            result.right.insert(result.right.end(), outputRight.begin(), outputRight.end());
+        }
+
+        plugin->stop_processing(plugin);
+        audioThread = false;
+
+        if (callbackRequested)
+        {
+            callbackRequested = false;
+            plugin->on_main_thread(plugin);
+        }
+
+        params->get_value(plugin, clapIdFor("threshold"), &result.thresholdAfter);
+
+        plugin->deactivate(plugin);
+        plugin->destroy(plugin);
+        plugin = nullptr;
+        return true;
+    }
+
+    /**
+     * @brief Range of a parameter as the plugin reports it
+     */
+    bool getRange(clap_id parameter, double& minimum, double& maximum)
+    {
+        const auto* descriptor = factory.get_plugin_descriptor(&factory, 0);
+        const auto* instance = descriptor != nullptr ? factory.create_plugin(&factory, &host, descriptor->id) : nullptr;
+        if (instance == nullptr || ! instance->init(instance))
+            return false;
+
+        bool found = false;
+        if (const auto* params = static_cast<const clap_plugin_params_t*>(instance->get_extension(instance, CLAP_EXT_PARAMS)))
+        {
+            for (uint32_t index = 0; index < params->count(instance) && ! found; ++index)
+            {
+                clap_param_info_t info {};
+                if (params->get_info(instance, index, &info) && info.id == parameter)
+                {
+                    minimum = info.min_value;
+                    maximum = info.max_value;
+                    found = true;
+                }
+            }
+        }
+
+        instance->destroy(instance);
+        return found;
+    }
+
+private:
+    static Host& fromHost(const clap_host_t* h) { return *static_cast<Host*>(h->host_data); }
+
+    static const void* CLAP_ABI getExtension(const clap_host_t* h, const char* id)
+    {
+        auto& self = fromHost(h);
+
+        if (std::strcmp(id, CLAP_EXT_THREAD_CHECK) == 0)
+            return &self.threadCheck;
+
+        return nullptr;
+    }
+
+    const clap_plugin_factory_t& factory;
+    clap_host_t host { CLAP_VERSION_INIT, nullptr, "fatpressor-clap-host", "Sylfo", "", "1.0.0",
+                       nullptr, nullptr, nullptr, nullptr };
+
+    clap_host_thread_check_t threadCheck {
+        [](const clap_host_t* h) { return ! fromHost(h).audioThread.load(); },
+        [](const clap_host_t* h) { return fromHost(h).audioThread.load(); }
+    };
+
+    const clap_plugin_t* plugin = nullptr;
+    std::atomic<bool> audioThread { false };
+    bool callbackRequested = false;
+};
+
+int firstDifference(const Render& a, const Render& b)
+{
+    for (size_t sample = 0; sample < a.left.size() && sample < b.left.size(); ++sample)
+        if (a.left[sample] != b.left[sample] || a.right[sample] != b.right[sample])
+            return static_cast<int>(sample);
+
+    return -1;
+}
+
+struct Checks
+{
+    int failures = 0;
+
+    void check(bool passed, const juce::String& name, const juce::String& detail = {})
+    {
+        std::cout << (passed ? "PASS " : "FAIL ") << name;
+        if (detail.isNotEmpty())
+            std::cout << " (" << detail << ")";
+        std::cout << std::endl;
+
+        if (! passed)
+            ++failures;
+    }
+};
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::cerr << "usage: fatpressor-clap-host <FatPressor.clap>" << std::endl;
+        return 2;
+    }
+
+    const auto pluginFile = juce::File::getCurrentWorkingDirectory().getChildFile(argv[1]);
+    juce::DynamicLibrary library;
+    if (! library.open(pluginFile.getFullPathName()))
+    {
+        std::cerr << "cannot load " << pluginFile.getFullPathName() << std::endl;
+        return 2;
+    }
+
+    const auto* entry = static_cast<const clap_plugin_entry_t*>(library.getFunction("clap_entry"));
+    if (entry == nullptr || ! entry->init(pluginFile.getFullPathName().toRawUTF8()))
+    {
+        std::cerr << "no clap_entry in " << pluginFile.getFullPathName() << std::endl;
+        return 2;
+    }
+
+    int exitCode = 2;
+
+    if (const auto* factory = static_cast<const clap_plugin_factory_t*>(entry->get_factory(CLAP_PLUGIN_FACTORY_ID)))
+    {
+        Host host(*factory);
+        Checks checks;
+
+        const auto threshold = clapIdFor("threshold");
+        double thresholdMin = 0.0, thresholdMax = 1.0;
+
+        Render plain, automated, modulated;
+        const bool loaded = host.getRange(threshold, thresholdMin, thresholdMax)
+                         && host.render([](int, InputEvents&) {}, plain)
+                         && host.render([&](int block, InputEvents& events)
+                                        {
+                                            if (block == 0)
+                                                events.addValue(eventTime, threshold, thresholdMin);
+                                        }, automated)
+                         && host.render([&](int block, InputEvents& events)
+                                        {
+                                            if (block == 0)
+                                                events.addModulation(0, threshold, -0.5);
+                                        }, modulated);
+
+        if (loaded)
+        {
+            const int automatedFrom = firstDifference(plain, automated);
+            checks.check(automatedFrom >= eventTime && automatedFrom < eventTime + blockSize,
+                         "value event lands on its sample", "first change at " + juce::String(automatedFrom));
+
+            checks.check(automated.output.parameterValues == 0 && automated.output.gestures == 0,
+                         "host values are not echoed back",
+                         juce::String(automated.output.parameterValues) + " value events, "
+                             + juce::String(automated.output.gestures) + " gestures");
+
+            checks.check(std::abs(automated.thresholdAfter - thresholdMin) < 1.0e-6 * (thresholdMax - thresholdMin) + 1.0e-9,
+                         "event value is written back", "get_value " + juce::String(automated.thresholdAfter));
+
+            checks.check(firstDifference(plain, modulated) >= 0, "modulation changes the output");
+            checks.check(modulated.thresholdAfter == plain.thresholdAfter && modulated.output.parameterValues == 0,
+                         "modulation leaves the parameter value alone");
+
+            exitCode = checks.failures == 0 ? 0 : 1;
+        }
+        else
+        {
+            std::cerr << "cannot instantiate the plugin or find its parameters" << std::endl;
+        }
+    }
+
+    entry->deinit();
+    return exitCode;
+}
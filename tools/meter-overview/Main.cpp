@@ -0,0 +1,175 @@
+#include "../../src/MeterHub.h"
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <thread>
+
+/**
+ * fatpressor-meters - console-wide meter overview
+ *
+ *   fatpressor-meters [--once] [--json] [--interval <ms>]
+ *
+ * Reads every FatPressor instance's meter snapshot from the shared-memory
+ * meter hub (one scan, no contact with any audio thread) and prints a table
+ * sorted by gain reduction, refreshed every interval (default 250 ms) until
+ * SIGINT. --once prints a single table, --json a single JSON array.
+ */
+namespace
+{
+constexpr juce::uint32 idleAfterMs = 1000;
+
+std::atomic<bool> stopRequested { false };
+
+void requestStop(int)
+{
+    stopRequested.store(true);
+}
+
+void printUsage()
+{
+    std::cerr << "usage: fatpressor-meters [--once] [--json] [--interval <ms>]" << std::endl;
+}
+
+/**
+ * @brief Preset names by name hash, from the preset folders (same location as PresetManager)
+ */
+std::map<juce::uint32, juce::String> findPresetNames()
+{
+    const auto appData = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory);
+#if JUCE_MAC
+    const auto presetsDirectory = appData.getChildFile("Application Support/Sylfo/FatPressor");
+#elif JUCE_WINDOWS
+    const auto presetsDirectory = appData.getChildFile("Sylfo/FatPressor");
+#else
+    const auto presetsDirectory = appData.getChildFile(".sylfo/FatPressor");
+#endif
+
+    std::map<juce::uint32, juce::String> names;
+    names[static_cast<juce::uint32>(juce::String("Default").hashCode())] = "Default";
+
+    for (const auto& file : presetsDirectory.findChildFiles(juce::File::findFiles, true, "*.fppreset"))
+    {
+        const auto name = file.getFileNameWithoutExtension();
+        names[static_cast<juce::uint32>(name.hashCode())] = name;
+    }
+
+    return names;
+}
+
+juce::String presetName(const std::map<juce::uint32, juce::String>& names, juce::uint32 hash)
+{
+    const auto found = names.find(hash);
+    return found != names.end() ? found->second : juce::String::toHexString(static_cast<int>(hash));
+}
+
+juce::String formatDb(float db)
+{
+    return db <= -60.0f ? juce::String("  -inf") : juce::String(db, 1).paddedLeft(' ', 6);
+}
+
+void printTable(const std::vector<MeterHub::Snapshot>& snapshots, const std::map<juce::uint32, juce::String>& names)
+{
+    std::printf("%-14s %-13s %-13s %7s %6s  %s\n", "instance", "in L/R dB", "out L/R dB", "GR dB", "CPU", "preset");
+
+    for (const auto& snapshot : snapshots)
+    {
+        const auto instance = juce::String(snapshot.processId) + "/" + juce::String(snapshot.instanceId);
+        const auto idle = snapshot.ageMs > idleAfterMs;
+
+        std::printf("%-14s %s %s %s %s %7.1f %5.1f%%  %s%s\n",
+                    instance.toRawUTF8(),
+                    formatDb(snapshot.inputDb[0]).toRawUTF8(), formatDb(snapshot.inputDb[1]).toRawUTF8(),
+                    formatDb(snapshot.outputDb[0]).toRawUTF8(), formatDb(snapshot.outputDb[1]).toRawUTF8(),
+                    static_cast<double>(snapshot.gainReductionDb), static_cast<double>(snapshot.cpuLoad * 100.0f),
+                    presetName(names, snapshot.presetNameHash).toRawUTF8(), idle ? "  (idle)" : "");
+    }
+
+    std::printf("%d instance(s)\n", static_cast<int>(snapshots.size()));
+    std::fflush(stdout);
+}
+
+juce::var toJson(const std::vector<MeterHub::Snapshot>& snapshots, const std::map<juce::uint32, juce::String>& names)
+{
+    juce::Array<juce::var> list;
+
+    for (const auto& snapshot : snapshots)
+    {
+        auto* object = new juce::DynamicObject();
+        object->setProperty("pid", snapshot.processId);
+        object->setProperty("instance", static_cast<int>(snapshot.instanceId));
+        object->setProperty("inputDb", juce::Array<juce::var> { snapshot.inputDb[0], snapshot.inputDb[1] });
+        object->setProperty("outputDb", juce::Array<juce::var> { snapshot.outputDb[0], snapshot.outputDb[1] });
+        object->setProperty("gainReductionDb", snapshot.gainReductionDb);
+        object->setProperty("cpuLoad", snapshot.cpuLoad);
+        object->setProperty("preset", presetName(names, snapshot.presetNameHash));
+        object->setProperty("idle", snapshot.ageMs > idleAfterMs);
+        list.add(juce::var(object));
+    }
+
+    return list;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    bool once = false;
+    bool json = false;
+    int intervalMs = 250;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String argument(argv[i]);
+
+        if (argument == "--once")
+            once = true;
+        else if (argument == "--json")
+            json = true;
+        else if (argument == "--interval" && i + 1 < argc)
+            intervalMs = juce::String(argv[++i]).getIntValue();
+        else
+        {
+            printUsage();
+            return 2;
+        }
+    }
+
+    if (intervalMs < 10)
+    {
+        printUsage();
+        return 2;
+    }
+
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+
+    const auto names = findPresetNames();
+
+    do
+    {
+        auto snapshots = MeterHub::readAll();
+        std::sort(snapshots.begin(), snapshots.end(), [](const auto& a, const auto& b)
+        {
+            return a.gainReductionDb > b.gainReductionDb;
+        });
+
+        if (json)
+        {
+            std::cout << juce::JSON::toString(toJson(snapshots, names)) << std::endl;
+            break;
+        }
+
+        if (! once)
+            std::printf("\033[H\033[2J");  // clear the terminal between refreshes
+
+        printTable(snapshots, names);
+
+        if (! once)
+            std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+    }
+    while (! once && ! stopRequested.load());
+
+    return 0;
+}
@@ -0,0 +1,210 @@
+#include "CaptureReplay.h"
+#include "../../src/PluginProcessor.h"
+#include "../../src/SessionRecorder.h"
+#include <cstring>
+
+namespace
+{
+template <typename Value>
+bool readValue(juce::InputStream& stream, Value& value)
+{
+    return stream.read(&value, static_cast<int>(sizeof(Value))) == static_cast<int>(sizeof(Value));
+}
+}
+
+SessionResult CaptureReplay::replay(const juce::File& captureFile)
+{
+    SessionResult result;
+    result.name = captureFile.getFileNameWithoutExtension();
+
+    juce::FileInputStream stream(captureFile);
+    if (! stream.openedOk())
+    {
+        result.failures.add("cannot open " + captureFile.getFullPathName());
+        return result;
+    }
+
+    char magic[4] {};
+    stream.read(magic, sizeof(magic));
+    const auto version = static_cast<juce::uint32>(stream.readInt());
+    if (std::memcmp(magic, SessionCaptureFormat::magic, sizeof(magic)) != 0
+        || version < 1 || version > SessionCaptureFormat::version)
+    {
+        result.failures.add("not a FatPressor session capture (or unsupported version)");
+        return result;
+    }
+
+    const double sampleRate = stream.readDouble();
+    const int numChannels = stream.readInt();
+    const int maxBlockSize = stream.readInt();
+    const int numParameters = stream.readInt();
+
+    if (sampleRate <= 0.0 || numChannels < 1 || numChannels > 2 || maxBlockSize < 1 || numParameters < 0)
+    {
+        result.failures.add("corrupt capture header");
+        return result;
+    }
+
+    FatPressorAudioProcessor processor;
+
+    const auto channelSet = numChannels == 1 ? juce::AudioChannelSet::mono() : juce::AudioChannelSet::stereo();
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(channelSet);
+    layout.outputBuses.add(channelSet);
+    processor.setBusesLayout(layout);
+
+    // Map captured parameter indices onto this build's parameters by id
+    const auto& parameters = processor.getParameters();
+    std::vector<juce::RangedAudioParameter*> capturedParameters(static_cast<size_t>(numParameters), nullptr);
+
+    for (int i = 0; i < numParameters; ++i)
+    {
+        const auto length = static_cast<int>(static_cast<juce::uint16>(stream.readShort()));
+        juce::MemoryBlock utf8;
+        stream.readIntoMemoryBlock(utf8, length);
+        const auto id = juce::String::fromUTF8(static_cast<const char*>(utf8.getData()), static_cast<int>(utf8.getSize()));
+
+        for (auto* parameter : parameters)
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+                if (ranged->getParameterID() == id)
+                    capturedParameters[static_cast<size_t>(i)] = ranged;
+
+        if (capturedParameters[static_cast<size_t>(i)] == nullptr)
+            result.warnings.add("parameter not in this build: " + id);
+    }
+
+    processor.setDeterministicReplay(true);
+    processor.setRateAndBufferSizeDetails(sampleRate, maxBlockSize);
+    processor.prepareToPlay(sampleRate, maxBlockSize);
+    processor.setStageTimingEnabled(true);
+    result.latencySamples = processor.getLatencySamples();
+    SessionRunner::recordFootprint(result, processor);
+
+    juce::AudioBuffer<float> block(numChannels, maxBlockSize);
+    std::vector<float> values(static_cast<size_t>(numParameters));
+    juce::MidiBuffer midi;
+    AudioHasher hasher;
+    auto& parameterEvents = processor.getParameterEventQueue();
+
+    int currentProgram = processor.getCurrentProgram();
+    juce::int64 totalSamples = 0;
+    juce::int64 totalTicks = 0;
+    juce::int64 maxTicks = 0;
+    int droppedBlocks = 0;
+
+    for (char tag; readValue(stream, tag);)
+    {
+        if (tag == SessionCaptureFormat::gapTag)
+        {
+            juce::uint32 dropped = 0;
+            readValue(stream, dropped);
+            droppedBlocks += static_cast<int>(dropped);
+            continue;
+        }
+
+        if (tag != SessionCaptureFormat::blockTag)
+        {
+            result.failures.add("corrupt record at byte " + juce::String(stream.getPosition() - 1));
+            break;
+        }
+
+        juce::uint32 numSamples = 0, numHandOffs = 0, numEvents = 0;
+        juce::int32 program = 0;
+
+        readValue(stream, numSamples);
+        readValue(stream, program);
+        readValue(stream, numHandOffs);
+
+        // Hand the tables over at the sub-blocks the live instance picked them up
+        // in (version 1 only recorded the last drive, applied at the block start)
+        if (version == 1)
+        {
+            float drive = 0.0f;
+            readValue(stream, drive);
+            if (numHandOffs > 0)
+                processor.scheduleCurveTable(0, drive);
+        }
+        else
+        {
+            for (juce::uint32 i = 0; i < numHandOffs; ++i)
+            {
+                juce::uint32 offset = 0;
+                float drive = 0.0f;
+                readValue(stream, offset);
+                readValue(stream, drive);
+                processor.scheduleCurveTable(static_cast<int>(offset), drive);
+            }
+        }
+
+        stream.read(values.data(), 4 * numParameters);
+
+        if (program != currentProgram && juce::isPositiveAndBelow(program, processor.getNumPrograms()))
+        {
+            processor.setCurrentProgram(program);
+            currentProgram = program;
+        }
+
+        for (size_t i = 0; i < values.size(); ++i)
+            if (auto* parameter = capturedParameters[i])
+                if (parameter->getValue() != values[i])
+                    parameter->setValueNotifyingHost(values[i]);
+
+        readValue(stream, numEvents);
+        for (juce::uint32 i = 0; i < numEvents; ++i)
+        {
+            juce::int32 offset = 0, index = 0;
+            float value = 0.0f;
+            juce::uint8 type = 0;
+            readValue(stream, offset);
+            readValue(stream, index);
+            readValue(stream, value);
+            readValue(stream, type);
+
+            if (juce::isPositiveAndBelow(index, numParameters))
+                if (auto* parameter = capturedParameters[static_cast<size_t>(index)])
+                    parameterEvents.add(offset, parameter->getParameterIndex(), value,
+                                        static_cast<ParameterEvent::Type>(type));
+        }
+
+        if (static_cast<int>(numSamples) > block.getNumSamples())
+            block.setSize(numChannels, static_cast<int>(numSamples), false, false, true);
+
+        const int channelBytes = 4 * static_cast<int>(numSamples);
+        bool complete = true;
+        for (int channel = 0; channel < numChannels; ++channel)
+            complete = stream.read(block.getWritePointer(channel), channelBytes) == channelBytes && complete;
+
+        if (! complete)
+        {
+            parameterEvents.clear();
+            result.warnings.add("capture truncated after block " + juce::String(result.numBlocks));
+            break;
+        }
+
+        juce::AudioBuffer<float> view(block.getArrayOfWritePointers(), numChannels, 0, static_cast<int>(numSamples));
+
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+        processor.processBlock(view, midi);
+        const auto ticks = juce::Time::getHighResolutionTicks() - startTicks;
+
+        hasher.update(view, 0, view.getNumSamples());
+        totalTicks += ticks;
+        if (ticks > maxTicks)
+        {
+            maxTicks = ticks;
+            result.slowestBlock = result.numBlocks;
+        }
+        ++result.numBlocks;
+        totalSamples += numSamples;
+    }
+
+    processor.releaseResources();
+
+    if (droppedBlocks > 0)
+        result.warnings.add(juce::String(droppedBlocks) + " blocks were dropped while capturing; replay is not bit-exact");
+
+    result.hash = hasher.toString();
+    SessionRunner::finishTiming(result, totalTicks, maxTicks, static_cast<double>(totalSamples) / sampleRate,
+                                processor.getStageTicks());
+    return result;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "SessionRunner.h"
+
+/**
+ * @brief Replays a session capture (.fpcap) recorded by the plugin
+ *
+ * The processor is prepared with the captured sample rate and block size,
+ * switched to deterministic table builds, and fed the captured blocks with
+ * the same parameter values, events, program changes and waveshaper table
+ * hand-offs. With no gap records the output is bit-identical to what the
+ * plugin produced; per-block and per-stage timing show where a CPU spike
+ * came from.
+ */
+namespace CaptureReplay
+{
+SessionResult replay(const juce::File& captureFile);
+}
@@ -0,0 +1,321 @@
+#include "Corpus.h"
+#include "SessionRunner.h"
+#include "TestSignals.h"
+#include "../../src/PluginProcessor.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_dsp/juce_dsp.h>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+struct Setting
+{
+    const char* parameterId;
+    float value;
+};
+
+/**
+ * @brief One corpus mode: settings applied on top of each preset
+ * Every mode sets the tube mode and the iron switch; the others change one
+ * more thing from there (compressor mode, chain order, a stage switched
+ * off) and leave the rest as the preset has it.
+ */
+struct Mode
+{
+    const char* name;
+    std::vector<Setting> settings;
+    Corpus::Tolerance tolerance;
+};
+
+const Corpus::Tolerance tableTolerance { 1.0e-4, -80.0, 0.1 };
+const Corpus::Tolerance modelTolerance { 1.0e-3, -60.0, 0.5 };   // iterating / integrating models
+
+const Mode modes[] = {
+    { "classic", { { "tubeMode", 0 }, { "hysteresis", 0 } }, tableTolerance },
+    { "harmonic", { { "tubeMode", 1 }, { "hysteresis", 0 } }, tableTolerance },
+    { "triode", { { "tubeMode", 2 }, { "hysteresis", 0 } }, modelTolerance },
+    { "iron", { { "tubeMode", 0 }, { "hysteresis", 1 } }, modelTolerance },
+
+    { "opto-vca", { { "tubeMode", 0 }, { "hysteresis", 0 }, { "compMode", 1 } }, tableTolerance },
+    { "de-ess", { { "tubeMode", 0 }, { "hysteresis", 0 }, { "compMode", 2 } }, tableTolerance },
+
+    { "comp-tube-iron", { { "tubeMode", 0 }, { "hysteresis", 0 }, { "chainOrder", 1 } }, tableTolerance },
+    { "tube-iron-comp", { { "tubeMode", 0 }, { "hysteresis", 0 }, { "chainOrder", 2 } }, tableTolerance },
+
+    { "no-tube", { { "tubeMode", 0 }, { "hysteresis", 0 }, { "tubeEnabled", 0 } }, tableTolerance },
+    { "no-compression", { { "tubeMode", 0 }, { "hysteresis", 0 }, { "compressionEnabled", 0 } }, tableTolerance },
+    { "no-iron", { { "tubeMode", 0 }, { "hysteresis", 0 }, { "ironEnabled", 0 } }, tableTolerance },
+    { "no-eq", { { "tubeMode", 0 }, { "hysteresis", 0 }, { "eqEnabled", 0 } }, tableTolerance },
+};
+
+// Fixed test signals, one second each
+const char* const signals[] = {
+    R"({ "name": "sine-100", "type": "sine", "frequency": 100, "amplitude": 0.5, "seconds": 1 })",
+    R"({ "name": "sine-1k-quiet", "type": "sine", "frequency": 1000, "amplitude": 0.125, "seconds": 1 })",
+    R"({ "name": "sweep", "type": "sweep", "frequency": 20, "endFrequency": 20000, "amplitude": 0.5, "seconds": 1 })",
+    R"({ "name": "noise", "type": "noise", "amplitude": 0.5, "seed": 7, "seconds": 1 })",
+    R"({ "name": "impulse", "type": "impulse", "amplitude": 1.0, "seconds": 1 })",
+};
+
+juce::String safeName(const juce::String& name)
+{
+    return juce::File::createLegalFileName(name).replaceCharacter(' ', '-').toLowerCase();
+}
+
+bool writeWav(const juce::File& file, const juce::AudioBuffer<float>& audio, double sampleRate)
+{
+    file.getParentDirectory().createDirectory();
+    file.deleteFile();
+
+    auto stream = file.createOutputStream();
+    if (stream == nullptr)
+        return false;
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatWriter> writer(
+        wav.createWriterFor(stream.get(), sampleRate, static_cast<unsigned int>(audio.getNumChannels()), 32, {}, 0));
+    if (writer == nullptr)
+        return false;
+
+    stream.release();  // owned by the writer now
+    return writer->writeFromAudioSampleBuffer(audio, 0, audio.getNumSamples());
+}
+
+bool readWav(const juce::File& file, juce::AudioBuffer<float>& audio, double& sampleRate)
+{
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatReader> reader(wav.createReaderFor(file.createInputStream().release(), true));
+    if (reader == nullptr)
+        return false;
+
+    sampleRate = reader->sampleRate;
+    audio.setSize(static_cast<int>(reader->numChannels), static_cast<int>(reader->lengthInSamples));
+    return reader->read(&audio, 0, audio.getNumSamples(), 0, true, true);
+}
+
+/**
+ * @brief Third-octave band levels (dB) of the averaged power spectrum
+ */
+std::vector<double> bandLevels(const juce::AudioBuffer<float>& audio, double sampleRate)
+{
+    constexpr int fftOrder = 12;
+    constexpr int fftSize = 1 << fftOrder;
+
+    juce::dsp::FFT fft(fftOrder);
+    juce::dsp::WindowingFunction<float> window(fftSize, juce::dsp::WindowingFunction<float>::hann, false);
+    std::vector<float> frame(fftSize * 2);
+    std::vector<double> power(fftSize / 2 + 1, 0.0);
+
+    for (int channel = 0; channel < audio.getNumChannels(); ++channel)
+    {
+        const auto* data = audio.getReadPointer(channel);
+        for (int start = 0; start + fftSize <= audio.getNumSamples(); start += fftSize / 2)
+        {
+            std::fill(frame.begin(), frame.end(), 0.0f);
+            std::copy(data + start, data + start + fftSize, frame.begin());
+            window.multiplyWithWindowingTable(frame.data(), fftSize);
+            fft.performFrequencyOnlyForwardTransform(frame.data());
+
+            for (size_t bin = 0; bin < power.size(); ++bin)
+                power[bin] += static_cast<double>(frame[bin]) * frame[bin];
+        }
+    }
+
+    std::vector<double> levels;
+    const double binHz = sampleRate / fftSize;
+    for (double low = 20.0; low < sampleRate * 0.5; low *= std::pow(2.0, 1.0 / 3.0))
+    {
+        const double high = low * std::pow(2.0, 1.0 / 3.0);
+        double energy = 0.0;
+        for (auto bin = static_cast<size_t>(std::ceil(low / binHz)); bin < power.size() && bin * binHz < high; ++bin)
+            energy += power[bin];
+
+        levels.push_back(10.0 * std::log10(energy + 1.0e-30));
+    }
+    return levels;
+}
+
+double spectralDeviation(const juce::AudioBuffer<float>& reference, const juce::AudioBuffer<float>& candidate,
+                         double sampleRate)
+{
+    const auto referenceLevels = bandLevels(reference, sampleRate);
+    const auto candidateLevels = bandLevels(candidate, sampleRate);
+
+    // Bands more than 100 dB under the loudest one are ignored (numerical floor)
+    double loudest = -300.0;
+    for (const auto level : referenceLevels)
+        loudest = juce::jmax(loudest, level);
+
+    double deviation = 0.0;
+    for (size_t band = 0; band < referenceLevels.size(); ++band)
+        if (referenceLevels[band] > loudest - 100.0)
+            deviation = juce::jmax(deviation, std::abs(candidateLevels[band] - referenceLevels[band]));
+
+    return deviation;
+}
+
+Corpus::Tolerance toleranceFor(const Mode& mode, const juce::var& overrides)
+{
+    auto tolerance = mode.tolerance;
+    const auto custom = overrides.getProperty(mode.name, {});
+
+    tolerance.maxAbsError = custom.getProperty("maxAbsError", tolerance.maxAbsError);
+    tolerance.nullResidualDb = custom.getProperty("nullResidualDb", tolerance.nullResidualDb);
+    tolerance.spectralDeviationDb = custom.getProperty("spectralDeviationDb", tolerance.spectralDeviationDb);
+    return tolerance;
+}
+}
+
+juce::Result Corpus::render(const juce::File& directory, double sampleRate)
+{
+    // Preset list from a scratch instance (indices are program numbers)
+    juce::Array<PresetManager::PresetInfo> presets;
+    {
+        FatPressorAudioProcessor processor;
+        presets = processor.presetManager.getAllPresets();
+    }
+
+    for (const auto& mode : modes)
+    {
+        for (int program = 0; program < presets.size(); ++program)
+        {
+            const auto& preset = presets.getReference(program);
+            if (! preset.isFactory)
+                continue;
+
+            for (const auto* signalJson : signals)
+            {
+                const auto signal = juce::JSON::parse(signalJson);
+
+                SessionScript script;
+                script.name = juce::String(mode.name) + "/" + preset.name + "/" + signal["name"].toString();
+                script.sampleRate = sampleRate;
+
+                const auto generated = TestSignals::generate(signal, sampleRate, script.numChannels, script.input);
+                if (generated.failed())
+                    return generated;
+
+                // Program first: it resets parameters the preset does not store
+                SessionScript::Event event;
+                event.kind = SessionScript::Event::Kind::program;
+                event.program = program;
+                script.events.push_back(event);
+
+                event.kind = SessionScript::Event::Kind::parameter;
+                for (const auto& setting : mode.settings)
+                {
+                    event.parameterId = setting.parameterId;
+                    event.value = setting.value;
+                    script.events.push_back(event);
+                }
+
+                // Deterministic (see SessionRunner), so reruns of one build null exactly
+                const auto result = SessionRunner::run(script);
+                if (! result.passed())
+                    return juce::Result::fail(script.name + ": " + result.failures.joinIntoString("; "));
+
+                const auto file = directory.getChildFile(mode.name)
+                                      .getChildFile(safeName(preset.category))
+                                      .getChildFile(safeName(preset.name))
+                                      .getChildFile(signal["name"].toString() + ".wav");
+
+                if (! writeWav(file, result.output, sampleRate))
+                    return juce::Result::fail("cannot write " + file.getFullPathName());
+            }
+        }
+
+        std::cout << "rendered " << mode.name << std::endl;
+    }
+
+    return juce::Result::ok();
+}
+
+int Corpus::compare(const juce::File& reference, const juce::File& candidate,
+                    const juce::var& tolerances, juce::Array<juce::var>& report)
+{
+    int failures = 0;
+
+    for (const auto& mode : modes)
+    {
+        const auto tolerance = toleranceFor(mode, tolerances);
+        const auto referenceDir = reference.getChildFile(mode.name);
+
+        auto referenceFiles = referenceDir.findChildFiles(juce::File::findFiles, true, "*.wav");
+        referenceFiles.sort();
+
+        for (const auto& referenceFile : referenceFiles)
+        {
+            const auto relativePath = referenceFile.getRelativePathFrom(reference);
+            const auto candidateFile = candidate.getChildFile(relativePath);
+
+            auto* entry = new juce::DynamicObject();
+            entry->setProperty("file", relativePath);
+            entry->setProperty("mode", mode.name);
+
+            juce::AudioBuffer<float> expected, actual;
+            double sampleRate = 0.0, candidateRate = 0.0;
+            juce::StringArray problems;
+
+            if (! readWav(referenceFile, expected, sampleRate))
+                problems.add("unreadable reference");
+            else if (! candidateFile.existsAsFile() || ! readWav(candidateFile, actual, candidateRate))
+                problems.add("missing candidate");
+            else if (actual.getNumChannels() != expected.getNumChannels()
+                     || actual.getNumSamples() != expected.getNumSamples()
+                     || ! juce::approximatelyEqual(sampleRate, candidateRate))
+                problems.add("length, channel count or sample rate differs");
+
+            if (problems.isEmpty())
+            {
+                double maxAbsError = 0.0, errorEnergy = 0.0, referenceEnergy = 0.0;
+                for (int channel = 0; channel < expected.getNumChannels(); ++channel)
+                {
+                    const auto* e = expected.getReadPointer(channel);
+                    const auto* a = actual.getReadPointer(channel);
+                    for (int sample = 0; sample < expected.getNumSamples(); ++sample)
+                    {
+                        const double difference = static_cast<double>(a[sample]) - e[sample];
+                        maxAbsError = juce::jmax(maxAbsError, std::abs(difference));
+                        errorEnergy += difference * difference;
+                        referenceEnergy += static_cast<double>(e[sample]) * e[sample];
+                    }
+                }
+
+                const double nullResidualDb = errorEnergy > 0.0
+                                                ? 10.0 * std::log10(errorEnergy / juce::jmax(referenceEnergy, 1.0e-30))
+                                                : -300.0;
+
+                const double deviationDb = spectralDeviation(expected, actual, sampleRate);
+
+                entry->setProperty("maxAbsError", maxAbsError);
+                entry->setProperty("nullResidualDb", nullResidualDb);
+                entry->setProperty("spectralDeviationDb", deviationDb);
+
+                if (maxAbsError > tolerance.maxAbsError)
+                    problems.add("max abs error " + juce::String(maxAbsError, 7));
+                if (nullResidualDb > tolerance.nullResidualDb)
+                    problems.add("null residual " + juce::String(nullResidualDb, 1) + " dB");
+                if (deviationDb > tolerance.spectralDeviationDb)
+                    problems.add("spectral deviation " + juce::String(deviationDb, 2) + " dB");
+            }
+
+            juce::Array<juce::var> problemList;
+            for (const auto& problem : problems)
+                problemList.add(problem);
+
+            entry->setProperty("passed", problems.isEmpty());
+            entry->setProperty("problems", problemList);
+            report.add(juce::var(entry));
+
+            if (! problems.isEmpty())
+            {
+                ++failures;
+                std::cout << "FAIL " << relativePath << ": " << problems.joinIntoString(", ") << std::endl;
+            }
+        }
+    }
+
+    return failures;
+}
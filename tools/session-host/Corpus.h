@@ -0,0 +1,49 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+/**
+ * @brief Golden-output regression corpus
+ *
+ * render() writes one 32-bit float WAV per mode × factory preset × test
+ * signal:  <dir>/<mode>/<category>/<preset>/<signal>.wav
+ *
+ * Modes cover each tube mode, the iron, each compressor mode, each chain
+ * order and each stage switched off, one at a time on top of the classic
+ * setup; combinations (say, De-Ess with the tube after the compressor) are
+ * not rendered. Renders are deterministic, like scripted sessions.
+ *
+ * compare() nulls every reference file against the same path in a
+ * candidate corpus and reports:
+ * - max absolute error
+ * - null-test residual: RMS(candidate - reference) / RMS(reference), in dB
+ * - spectral deviation: largest third-octave band level difference, in dB
+ *
+ * Each mode has its own tolerances (the triode and iron models iterate and
+ * integrate, so they are allowed to drift more than the table-based
+ * modes); a JSON file can override them:
+ *   { "triode": { "maxAbsError": 1e-3, "nullResidualDb": -60, "spectralDeviationDb": 0.5 } }
+ */
+namespace Corpus
+{
+struct Tolerance
+{
+    double maxAbsError = 1.0e-4;
+    double nullResidualDb = -80.0;
+    double spectralDeviationDb = 0.1;
+};
+
+/**
+ * @brief Render the corpus with the current build
+ */
+juce::Result render(const juce::File& directory, double sampleRate);
+
+/**
+ * @brief Compare a candidate corpus against a reference
+ * @param tolerances Per-mode overrides (may be void)
+ * @param report Receives one entry per compared file
+ * @return Number of files that failed (missing files count as failures)
+ */
+int compare(const juce::File& reference, const juce::File& candidate,
+            const juce::var& tolerances, juce::Array<juce::var>& report);
+}
@@ -0,0 +1,244 @@
+#include "SessionRunner.h"
+#include "Corpus.h"
+#include "CaptureReplay.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_events/juce_events.h>
+#include <iostream>
+
+/**
+ * fatpressor-session-host - headless host for scripted FatPressor sessions
+ *
+ *   fatpressor-session-host [--report <report.json>] [--record-hashes | --allow-missing-hash] <session.json>...
+ *   fatpressor-session-host --render-corpus <dir> [--sample-rate <hz>]
+ *   fatpressor-session-host --compare <reference-dir> <candidate-dir>
+ *                           [--tolerances <tolerances.json>] [--report <report.json>]
+ *   fatpressor-session-host --replay <capture.fpcap> [--report <report.json>]
+ *
+ * Replays each session through the processor (no editor), checks its
+ * expectations and prints one line per session (--record-hashes stores the
+ * output hash for this build in each script instead of checking it; a script
+ * with no hash for this build fails unless --allow-missing-hash); renders / compares the
+ * golden-output corpus (see Corpus.h); or replays a session captured by the
+ * plugin (see CaptureReplay.h). Exit code 0 when everything passed,
+ * 1 when anything failed, 2 on usage errors.
+ */
+namespace
+{
+void printUsage()
+{
+    std::cerr << "usage: fatpressor-session-host [--report <report.json>] [--record-hashes | --allow-missing-hash] <session.json>...\n"
+                 "       fatpressor-session-host --render-corpus <dir> [--sample-rate <hz>]\n"
+                 "       fatpressor-session-host --compare <reference-dir> <candidate-dir>"
+                 " [--tolerances <tolerances.json>] [--report <report.json>]\n"
+                 "       fatpressor-session-host --replay <capture.fpcap> [--report <report.json>]" << std::endl;
+}
+
+bool writeOutput(const juce::File& file, const SessionResult& result, double sampleRate)
+{
+    file.deleteFile();
+    auto stream = file.createOutputStream();
+    if (stream == nullptr)
+        return false;
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatWriter> writer(
+        wav.createWriterFor(stream.get(), sampleRate, static_cast<unsigned int>(result.output.getNumChannels()),
+                            32, {}, 0));
+    if (writer == nullptr)
+        return false;
+
+    stream.release();  // owned by the writer now
+    return writer->writeFromAudioSampleBuffer(result.output, 0, result.output.getNumSamples());
+}
+
+/**
+ * @brief Store a session's output hash for this build in its script's "expect" block
+ */
+bool recordHash(const juce::File& sessionFile, const SessionResult& result)
+{
+    juce::var session;
+    if (juce::JSON::parse(sessionFile.loadFileAsString(), session).failed() || ! session.isObject())
+        return false;
+
+    if (! session["expect"].isObject())
+        session.getDynamicObject()->setProperty("expect", juce::var(new juce::DynamicObject()));
+
+    auto* expect = session["expect"].getDynamicObject();
+    if (! expect->getProperty("hash").isObject())
+        expect->setProperty("hash", juce::var(new juce::DynamicObject()));
+
+    expect->getProperty("hash").getDynamicObject()->setProperty(SessionRunner::getBuildKey(), result.hash);
+    return sessionFile.replaceWithText(juce::JSON::toString(session) + "\n");
+}
+}
+
+int main(int argc, char* argv[])
+{
+    // The processor's parameter tree expects a message manager
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const auto cwd = juce::File::getCurrentWorkingDirectory();
+    juce::File reportFile, corpusDirectory, tolerancesFile, captureFile;
+    juce::Array<juce::File> positional;
+    bool compareMode = false;
+    bool recordHashes = false;
+    bool allowMissingHash = false;
+    double corpusSampleRate = 48000.0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String argument(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (argument == "--report" && hasValue)
+            reportFile = cwd.getChildFile(argv[++i]);
+        else if (argument == "--render-corpus" && hasValue)
+            corpusDirectory = cwd.getChildFile(argv[++i]);
+        else if (argument == "--sample-rate" && hasValue)
+            corpusSampleRate = juce::String(argv[++i]).getDoubleValue();
+        else if (argument == "--tolerances" && hasValue)
+            tolerancesFile = cwd.getChildFile(argv[++i]);
+        else if (argument == "--replay" && hasValue)
+            captureFile = cwd.getChildFile(argv[++i]);
+        else if (argument == "--compare")
+            compareMode = true;
+        else if (argument == "--record-hashes")
+            recordHashes = true;
+        else if (argument == "--allow-missing-hash")
+            allowMissingHash = true;
+        else if (argument.startsWith("--"))
+        {
+            printUsage();
+            return 2;
+        }
+        else
+            positional.add(cwd.getChildFile(argument));
+    }
+
+    juce::Array<juce::var> report;
+
+    if (corpusDirectory != juce::File())
+    {
+        if (corpusSampleRate <= 0.0)
+        {
+            printUsage();
+            return 2;
+        }
+
+        const auto rendered = Corpus::render(corpusDirectory, corpusSampleRate);
+        if (rendered.failed())
+            std::cerr << "error: " << rendered.getErrorMessage() << std::endl;
+
+        return rendered.wasOk() ? 0 : 1;
+    }
+
+    if (captureFile != juce::File())
+    {
+        const auto result = CaptureReplay::replay(captureFile);
+
+        std::cout << (result.passed() ? "REPLAY " : "FAIL ") << result.name
+                  << "  hash " << result.hash
+                  << "  blocks " << result.numBlocks
+                  << "  max block " << juce::String(result.maxBlockMs, 3) << " ms (#" << result.slowestBlock << ")"
+                  << "  " << juce::String(result.realtimeFactor, 1) << "x realtime" << std::endl;
+
+        std::cout << "    stages ms: tube " << juce::String(result.stageMs[0], 2)
+                  << "  compression " << juce::String(result.stageMs[1], 2)
+                  << "  transformer " << juce::String(result.stageMs[2], 2)
+                  << "  output " << juce::String(result.stageMs[3], 2) << std::endl;
+
+        std::cout << "    memory: " << juce::File::descriptionOfSizeInBytes(result.memoryBytes)
+                  << " (instance " << juce::File::descriptionOfSizeInBytes(result.instanceBytes)
+                  << ", arena " << juce::File::descriptionOfSizeInBytes(result.arenaBytes)
+                  << ", shared tables " << juce::File::descriptionOfSizeInBytes(result.sharedTableBytes) << ")" << std::endl;
+
+        for (const auto& warning : result.warnings)
+            std::cout << "    warning: " << warning << std::endl;
+        for (const auto& failure : result.failures)
+            std::cout << "    " << failure << std::endl;
+
+        if (reportFile != juce::File())
+            reportFile.replaceWithText(juce::JSON::toString(result.toJson()));
+
+        return result.passed() ? 0 : 1;
+    }
+
+    if (compareMode)
+    {
+        if (positional.size() != 2)
+        {
+            printUsage();
+            return 2;
+        }
+
+        juce::var tolerances;
+        if (tolerancesFile != juce::File() && juce::JSON::parse(tolerancesFile.loadFileAsString(), tolerances).failed())
+        {
+            std::cerr << "error: cannot parse " << tolerancesFile.getFullPathName() << std::endl;
+            return 2;
+        }
+
+        const int failures = Corpus::compare(positional[0], positional[1], tolerances, report);
+        std::cout << report.size() - failures << " of " << report.size() << " renders within tolerance" << std::endl;
+
+        if (reportFile != juce::File())
+            reportFile.replaceWithText(juce::JSON::toString(juce::var(report)));
+
+        return failures == 0 && ! report.isEmpty() ? 0 : 1;
+    }
+
+    const auto& sessionFiles = positional;
+    if (sessionFiles.isEmpty())
+    {
+        printUsage();
+        return 2;
+    }
+
+    bool allPassed = true;
+
+    for (const auto& sessionFile : sessionFiles)
+    {
+        SessionScript script;
+        const auto loaded = SessionScript::load(sessionFile, script);
+        if (loaded.failed())
+        {
+            std::cerr << "error: " << loaded.getErrorMessage() << std::endl;
+            return 2;
+        }
+
+        // Recording: check everything but the hash, then store it
+        if (recordHashes)
+            if (auto* expect = script.expectations.getDynamicObject())
+                expect->removeProperty("hash");
+
+        const auto result = SessionRunner::run(script, allowMissingHash);
+        allPassed = allPassed && result.passed();
+        report.add(result.toJson());
+
+        if (recordHashes && result.passed() && ! recordHash(sessionFile, result))
+        {
+            std::cerr << "error: could not record the hash in " << sessionFile.getFullPathName() << std::endl;
+            allPassed = false;
+        }
+
+        std::cout << (result.passed() ? (recordHashes ? "RECORD " : "PASS ") : "FAIL ") << script.name
+                  << "  hash " << result.hash
+                  << "  latency " << result.latencySamples
+                  << "  " << juce::String(result.realtimeFactor, 1) << "x realtime"
+                  << "  max block " << juce::String(result.maxBlockMs, 3) << " ms"
+                  << "  memory " << juce::File::descriptionOfSizeInBytes(result.memoryBytes) << std::endl;
+
+        for (const auto& warning : result.warnings)
+            std::cout << "    warning: " << warning << std::endl;
+        for (const auto& failure : result.failures)
+            std::cout << "    " << failure << std::endl;
+
+        if (script.outputFile != juce::File() && ! writeOutput(script.outputFile, result, script.sampleRate))
+            std::cerr << "warning: could not write " << script.outputFile.getFullPathName() << std::endl;
+    }
+
+    if (reportFile != juce::File())
+        reportFile.replaceWithText(juce::JSON::toString(juce::var(report)));
+
+    return allPassed ? 0 : 1;
+}
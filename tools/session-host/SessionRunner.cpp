@@ -0,0 +1,347 @@
+#include "SessionRunner.h"
+#include "../../src/PluginProcessor.h"
+#include <cstring>
+#include <map>
+
+namespace
+{
+juce::RangedAudioParameter* findParameter(juce::AudioProcessor& processor, const juce::String& id)
+{
+    for (auto* parameter : processor.getParameters())
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            if (ranged->getParameterID() == id)
+                return ranged;
+
+    return nullptr;
+}
+
+void setParameter(juce::RangedAudioParameter& parameter, float value)
+{
+    parameter.setValueNotifyingHost(parameter.convertTo0to1(value));
+}
+}
+
+juce::var SessionResult::toJson() const
+{
+    auto* object = new juce::DynamicObject();
+    object->setProperty("name", name);
+    object->setProperty("passed", passed());
+    object->setProperty("hash", hash);
+    object->setProperty("samples", output.getNumSamples());
+    object->setProperty("blocks", numBlocks);
+    object->setProperty("slowestBlock", slowestBlock);
+    object->setProperty("latencySamples", latencySamples);
+    object->setProperty("renderSeconds", renderSeconds);
+    object->setProperty("maxBlockMs", maxBlockMs);
+    object->setProperty("meanBlockMs", meanBlockMs);
+    object->setProperty("realtimeFactor", realtimeFactor);
+
+    auto* memory = new juce::DynamicObject();
+    memory->setProperty("instanceBytes", instanceBytes);
+    memory->setProperty("arenaBytes", arenaBytes);
+    memory->setProperty("totalBytes", memoryBytes);
+    memory->setProperty("sharedTableBytes", sharedTableBytes);
+    object->setProperty("memory", juce::var(memory));
+
+    auto* stages = new juce::DynamicObject();
+    const char* const stageNames[] = { "tube", "compression", "transformer", "output" };
+    for (size_t stage = 0; stage < stageMs.size(); ++stage)
+        stages->setProperty(stageNames[stage], stageMs[stage]);
+    object->setProperty("stageMs", juce::var(stages));
+
+    juce::Array<juce::var> failureList;
+    for (const auto& failure : failures)
+        failureList.add(failure);
+    object->setProperty("failures", failureList);
+
+    juce::Array<juce::var> warningList;
+    for (const auto& warning : warnings)
+        warningList.add(warning);
+    object->setProperty("warnings", warningList);
+
+    return juce::var(object);
+}
+
+void AudioHasher::update(const juce::AudioBuffer<float>& audio, int startSample, int numSamples)
+{
+    numChannels = juce::jmin(audio.getNumChannels(), static_cast<int>(channelHashes.size()));
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto hash = channelHashes[static_cast<size_t>(channel)];
+        const auto* data = audio.getReadPointer(channel, startSample);
+
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            juce::uint32 bits;
+            std::memcpy(&bits, data + sample, sizeof(bits));
+
+            for (int byte = 0; byte < 4; ++byte)
+            {
+                hash ^= (bits >> (byte * 8)) & 0xffu;
+                hash *= prime;
+            }
+        }
+
+        channelHashes[static_cast<size_t>(channel)] = hash;
+    }
+}
+
+juce::String AudioHasher::toString() const
+{
+    auto hash = offsetBasis;
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        for (int byte = 0; byte < 8; ++byte)
+        {
+            hash ^= (channelHashes[static_cast<size_t>(channel)] >> (byte * 8)) & 0xffu;
+            hash *= prime;
+        }
+    }
+
+    return juce::String::toHexString(static_cast<juce::int64>(hash)).paddedLeft('0', 16);
+}
+
+juce::String SessionRunner::getBuildKey()
+{
+   #if JUCE_WINDOWS
+    juce::String key("windows");
+   #elif JUCE_MAC
+    juce::String key("macos");
+   #else
+    juce::String key("linux");
+   #endif
+
+   #if JUCE_ARM && JUCE_64BIT
+    key << "-arm64";
+   #elif JUCE_ARM
+    key << "-arm";
+   #elif JUCE_64BIT
+    key << "-x86_64";
+   #else
+    key << "-x86";
+   #endif
+
+   #if JUCE_CLANG
+    key << "-clang" << __clang_major__;
+   #elif JUCE_GCC
+    key << "-gcc" << __GNUC__;
+   #elif JUCE_MSVC
+    key << "-msvc" << _MSC_VER;
+   #endif
+
+   #if JUCE_DEBUG
+    key << "-debug";
+   #else
+    key << "-release";
+   #endif
+
+    return key;
+}
+
+juce::String SessionRunner::hashAudio(const juce::AudioBuffer<float>& audio)
+{
+    AudioHasher hasher;
+    hasher.update(audio, 0, audio.getNumSamples());
+    return hasher.toString();
+}
+
+void SessionRunner::finishTiming(SessionResult& result, juce::int64 totalTicks, juce::int64 maxTicks,
+                                 double audioSeconds, const std::array<juce::int64, 4>& stageTicks)
+{
+    result.renderSeconds = juce::Time::highResolutionTicksToSeconds(totalTicks);
+    result.maxBlockMs = juce::Time::highResolutionTicksToSeconds(maxTicks) * 1000.0;
+    result.meanBlockMs = result.numBlocks > 0 ? result.renderSeconds * 1000.0 / result.numBlocks : 0.0;
+    result.realtimeFactor = result.renderSeconds > 0.0 ? audioSeconds / result.renderSeconds : 0.0;
+
+    for (size_t stage = 0; stage < stageTicks.size(); ++stage)
+        result.stageMs[stage] = juce::Time::highResolutionTicksToSeconds(stageTicks[stage]) * 1000.0;
+}
+
+void SessionRunner::recordFootprint(SessionResult& result, const FatPressorAudioProcessor& processor)
+{
+    const auto footprint = processor.getMemoryFootprint();
+    result.instanceBytes = static_cast<juce::int64>(footprint.instanceBytes);
+    result.arenaBytes = static_cast<juce::int64>(footprint.arenaBytes);
+    result.memoryBytes = static_cast<juce::int64>(footprint.getTotalBytes());
+    result.sharedTableBytes = static_cast<juce::int64>(footprint.sharedTableBytes);
+}
+
+SessionResult SessionRunner::run(const SessionScript& script, bool allowMissingHash)
+{
+    SessionResult result;
+    result.name = script.name;
+
+    FatPressorAudioProcessor processor;
+
+    const auto channelSet = script.numChannels == 1 ? juce::AudioChannelSet::mono()
+                                                    : juce::AudioChannelSet::stereo();
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(channelSet);
+    layout.outputBuses.add(channelSet);
+
+    if (! processor.setBusesLayout(layout))
+    {
+        result.failures.add("unsupported channel layout");
+        return result;
+    }
+
+    // Validate the script before rendering anything
+    for (const auto& event : script.events)
+    {
+        if (event.kind == SessionScript::Event::Kind::parameter && findParameter(processor, event.parameterId) == nullptr)
+            result.failures.add("unknown parameter: " + event.parameterId);
+
+        if (event.kind == SessionScript::Event::Kind::program
+            && ! juce::isPositiveAndBelow(event.program, processor.getNumPrograms()))
+            result.failures.add("program out of range: " + juce::String(event.program));
+    }
+
+    if (! result.passed())
+        return result;
+
+    // Table hand-offs at block boundaries instead of whenever the builder
+    // thread finishes, so the hash is repeatable (set before preparing)
+    processor.setDeterministicReplay(true);
+    processor.setRateAndBufferSizeDetails(script.sampleRate, script.blockSize);
+    processor.prepareToPlay(script.sampleRate, script.blockSize);
+    processor.setStageTimingEnabled(true);
+    result.latencySamples = processor.getLatencySamples();
+    recordFootprint(result, processor);
+
+    result.output.makeCopyOf(script.input);
+    const auto totalSamples = static_cast<juce::int64>(result.output.getNumSamples());
+
+    juce::MidiBuffer midi;
+    std::map<juce::String, juce::MemoryBlock> savedStates;
+    auto& parameterEvents = processor.getParameterEventQueue();
+
+    // Program changes and state calls happen between blocks, as hosts do
+    const auto applyBetweenBlocks = [&](const SessionScript::Event& event)
+    {
+        switch (event.kind)
+        {
+            case SessionScript::Event::Kind::parameter:
+                setParameter(*findParameter(processor, event.parameterId), event.value);
+                break;
+
+            case SessionScript::Event::Kind::program:
+                processor.setCurrentProgram(event.program);
+                break;
+
+            case SessionScript::Event::Kind::saveState:
+                processor.getStateInformation(savedStates[event.slot]);
+                break;
+
+            case SessionScript::Event::Kind::restoreState:
+            {
+                const auto state = savedStates.find(event.slot);
+                if (state == savedStates.end())
+                    result.failures.add("restoreState before saveState: " + event.slot);
+                else
+                    processor.setStateInformation(state->second.getData(), static_cast<int>(state->second.getSize()));
+                break;
+            }
+        }
+    };
+
+    size_t nextEvent = 0;
+    juce::int64 position = 0;
+    juce::int64 totalTicks = 0;
+    juce::int64 maxTicks = 0;
+
+    while (position < totalSamples)
+    {
+        while (nextEvent < script.events.size() && script.events[nextEvent].at <= position)
+            applyBetweenBlocks(script.events[nextEvent++]);
+
+        // Cut the block short where a program or state event is scheduled
+        auto end = juce::jmin(position + script.blockSize, totalSamples);
+        for (auto i = nextEvent; i < script.events.size() && script.events[i].at < end; ++i)
+        {
+            if (script.events[i].kind != SessionScript::Event::Kind::parameter)
+            {
+                end = script.events[i].at;
+                break;
+            }
+        }
+
+        // Parameter changes inside the block
+        for (; nextEvent < script.events.size() && script.events[nextEvent].at < end; ++nextEvent)
+        {
+            const auto& event = script.events[nextEvent];
+            auto* parameter = findParameter(processor, event.parameterId);
+
+            if (script.sampleAccurateAutomation)
+                parameterEvents.add(static_cast<int>(event.at - position), parameter->getParameterIndex(), event.value);
+            else
+                setParameter(*parameter, event.value);
+        }
+
+        const auto numSamples = static_cast<int>(end - position);
+        juce::AudioBuffer<float> block(result.output.getArrayOfWritePointers(), result.output.getNumChannels(),
+                                       static_cast<int>(position), numSamples);
+
+        // Where a real host's builder thread would have delivered it, give or take
+        processor.bakeRequestedCurveTable();
+
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+        processor.processBlock(block, midi);
+        const auto ticks = juce::Time::getHighResolutionTicks() - startTicks;
+
+        totalTicks += ticks;
+        if (ticks > maxTicks)
+        {
+            maxTicks = ticks;
+            result.slowestBlock = result.numBlocks;
+        }
+        ++result.numBlocks;
+        position = end;
+    }
+
+    processor.releaseResources();
+
+    result.hash = hashAudio(result.output);
+    finishTiming(result, totalTicks, maxTicks, static_cast<double>(totalSamples) / script.sampleRate,
+                 processor.getStageTicks());
+
+    checkExpectations(script, allowMissingHash, result);
+    return result;
+}
+
+void SessionRunner::checkExpectations(const SessionScript& script, bool allowMissingHash, SessionResult& result)
+{
+    const auto& expect = script.expectations;
+    if (! expect.isObject())
+        return;
+
+    // Hashes are bit-exact, so they are recorded per build (see getBuildKey())
+    if (expect.hasProperty("hash"))
+    {
+        const auto& hashes = expect["hash"];
+        const auto buildKey = getBuildKey();
+
+        if (hashes.isString() && hashes.toString() != result.hash)
+            result.failures.add("hash " + result.hash + " != expected " + hashes.toString());
+        else if (hashes.isObject() && ! hashes.hasProperty(buildKey) && allowMissingHash)
+            result.warnings.add("no hash recorded for " + buildKey + " (run with --record-hashes)");
+        else if (hashes.isObject() && ! hashes.hasProperty(buildKey))
+            result.failures.add("no hash recorded for " + buildKey
+                                + " (run with --record-hashes, or --allow-missing-hash to skip the check)");
+        else if (hashes.isObject() && hashes[juce::Identifier(buildKey)].toString() != result.hash)
+            result.failures.add("hash " + result.hash + " != expected " + hashes[juce::Identifier(buildKey)].toString()
+                                + " for " + buildKey);
+    }
+
+    if (expect.hasProperty("latencySamples") && static_cast<int>(expect["latencySamples"]) != result.latencySamples)
+        result.failures.add("latency " + juce::String(result.latencySamples) + " != expected "
+                            + expect["latencySamples"].toString());
+
+    if (expect.hasProperty("maxBlockMs") && result.maxBlockMs > static_cast<double>(expect["maxBlockMs"]))
+        result.failures.add("slowest block " + juce::String(result.maxBlockMs, 3) + " ms > "
+                            + expect["maxBlockMs"].toString() + " ms");
+
+    if (expect.hasProperty("minRealtimeFactor") && result.realtimeFactor < static_cast<double>(expect["minRealtimeFactor"]))
+        result.failures.add("realtime factor " + juce::String(result.realtimeFactor, 1) + " < "
+                            + expect["minRealtimeFactor"].toString());
+}
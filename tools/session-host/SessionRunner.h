@@ -0,0 +1,93 @@
+#pragma once
+
+#include "SessionScript.h"
+#include <array>
+
+class FatPressorAudioProcessor;
+
+/**
+ * @brief Streaming FNV-1a 64 hash of rendered audio
+ * One state per channel, combined at the end, so the result does not depend
+ * on how the audio was split into blocks.
+ */
+class AudioHasher
+{
+public:
+    void update(const juce::AudioBuffer<float>& audio, int startSample, int numSamples);
+    juce::String toString() const;
+
+private:
+    static constexpr juce::uint64 offsetBasis = 14695981039346656037ull;
+    static constexpr juce::uint64 prime = 1099511628211ull;
+
+    std::array<juce::uint64, 2> channelHashes { offsetBasis, offsetBasis };
+    int numChannels = 0;
+};
+
+/**
+ * @brief Result of one replayed session
+ */
+struct SessionResult
+{
+    juce::String name;
+    juce::AudioBuffer<float> output;
+    juce::String hash;             // AudioHasher over the output
+    int latencySamples = 0;
+    int numBlocks = 0;
+    int slowestBlock = -1;
+    double renderSeconds = 0.0;
+    double maxBlockMs = 0.0;
+    double meanBlockMs = 0.0;
+    double realtimeFactor = 0.0;   // audio duration / render time
+    std::array<double, 4> stageMs {};  // tube, compression, transformer, output
+    juce::int64 instanceBytes = 0;     // processor footprint after prepareToPlay
+    juce::int64 arenaBytes = 0;
+    juce::int64 memoryBytes = 0;       // total, see FatPressorAudioProcessor::getMemoryFootprint()
+    juce::int64 sharedTableBytes = 0;  // process-wide tables, shared with other instances
+    juce::StringArray failures;    // script errors and failed expectations
+    juce::StringArray warnings;
+
+    bool passed() const { return failures.isEmpty(); }
+    juce::var toJson() const;
+};
+
+/**
+ * @brief Runs a SessionScript through an in-process FatPressorAudioProcessor
+ *
+ * The processor is created without an editor and driven like a host would:
+ * prepareToPlay, then processBlock in blocks of the session's size, with
+ * program changes and state save/restore between blocks (a block is cut
+ * short where one is scheduled). It runs in deterministic replay mode:
+ * waveshaper tables are handed off at block boundaries, so the same build
+ * always renders the same hash.
+ *
+ * A script whose "hash" has no entry for this build fails, unless
+ * allowMissingHash is set (then it only gets a warning).
+ */
+class SessionRunner
+{
+public:
+    static SessionResult run(const SessionScript& script, bool allowMissingHash = false);
+
+    static juce::String hashAudio(const juce::AudioBuffer<float>& audio);
+
+    /**
+     * @brief Platform, architecture, compiler and configuration, e.g. "linux-x86_64-gcc13-release"
+     * Output hashes are bit-exact and only comparable within one build key.
+     */
+    static juce::String getBuildKey();
+
+    /**
+     * @brief Fill the timing fields of a result from per-block measurements
+     */
+    static void finishTiming(SessionResult& result, juce::int64 totalTicks, juce::int64 maxTicks,
+                             double audioSeconds, const std::array<juce::int64, 4>& stageTicks);
+
+    /**
+     * @brief Fill the memory fields of a result from a prepared processor
+     */
+    static void recordFootprint(SessionResult& result, const FatPressorAudioProcessor& processor);
+
+private:
+    static void checkExpectations(const SessionScript& script, bool allowMissingHash, SessionResult& result);
+};
@@ -0,0 +1,123 @@
+#include "SessionScript.h"
+#include "TestSignals.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <algorithm>
+
+namespace
+{
+juce::Result readAudioFile(const juce::File& file, int numChannels, double sampleRate,
+                           juce::AudioBuffer<float>& output)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr)
+        return juce::Result::fail("cannot read audio file: " + file.getFullPathName());
+
+    if (! juce::approximatelyEqual(reader->sampleRate, sampleRate))
+        return juce::Result::fail("audio file sample rate does not match the session: " + file.getFileName());
+
+    const auto numSamples = static_cast<int>(reader->lengthInSamples);
+    output.setSize(numChannels, numSamples);
+    output.clear();
+
+    // Mono files feed every channel
+    const int fileChannels = static_cast<int>(reader->numChannels);
+    reader->read(&output, 0, numSamples, 0, true, numChannels > 1 && fileChannels > 1);
+
+    if (fileChannels == 1)
+        for (int channel = 1; channel < numChannels; ++channel)
+            output.copyFrom(channel, 0, output, 0, 0, numSamples);
+
+    return juce::Result::ok();
+}
+
+juce::Result parseEvent(const juce::var& json, SessionScript::Event& event)
+{
+    if (! json.isObject() || ! json.hasProperty("at"))
+        return juce::Result::fail("every event needs an \"at\" sample offset");
+
+    event.at = static_cast<juce::int64>(static_cast<double>(json["at"]));
+
+    if (json.hasProperty("parameter"))
+    {
+        event.kind = SessionScript::Event::Kind::parameter;
+        event.parameterId = json["parameter"].toString();
+        event.value = static_cast<float>(static_cast<double>(json["value"]));
+    }
+    else if (json.hasProperty("program"))
+    {
+        event.kind = SessionScript::Event::Kind::program;
+        event.program = static_cast<int>(json["program"]);
+    }
+    else if (json.hasProperty("saveState"))
+    {
+        event.kind = SessionScript::Event::Kind::saveState;
+        event.slot = json["saveState"].toString();
+    }
+    else if (json.hasProperty("restoreState"))
+    {
+        event.kind = SessionScript::Event::Kind::restoreState;
+        event.slot = json["restoreState"].toString();
+    }
+    else
+    {
+        return juce::Result::fail("unknown event at sample " + juce::String(event.at));
+    }
+
+    return juce::Result::ok();
+}
+}
+
+juce::Result SessionScript::load(const juce::File& file, SessionScript& script)
+{
+    juce::var json;
+    const auto parsed = juce::JSON::parse(file.loadFileAsString(), json);
+    if (parsed.failed())
+        return juce::Result::fail(file.getFileName() + ": " + parsed.getErrorMessage());
+
+    if (! json.isObject())
+        return juce::Result::fail(file.getFileName() + ": expected a JSON object");
+
+    script.name = json.getProperty("name", file.getFileNameWithoutExtension()).toString();
+    script.sampleRate = json.getProperty("sampleRate", 48000.0);
+    script.blockSize = json.getProperty("blockSize", 512);
+    script.numChannels = json.getProperty("channels", 2);
+    script.sampleAccurateAutomation = json.getProperty("automation", "sample").toString() != "block";
+    script.expectations = json.getProperty("expect", {});
+
+    if (script.sampleRate <= 0.0 || script.blockSize <= 0 || script.numChannels < 1 || script.numChannels > 2)
+        return juce::Result::fail(file.getFileName() + ": invalid sampleRate, blockSize or channels");
+
+    if (json.hasProperty("output"))
+        script.outputFile = file.getParentDirectory().getChildFile(json["output"].toString());
+
+    // Input: audio file or generated signal
+    auto result = json.hasProperty("input")
+                    ? readAudioFile(file.getParentDirectory().getChildFile(json["input"].toString()),
+                                    script.numChannels, script.sampleRate, script.input)
+                    : TestSignals::generate(json.getProperty("signal", {}), script.sampleRate,
+                                            script.numChannels, script.input);
+    if (result.failed())
+        return juce::Result::fail(file.getFileName() + ": " + result.getErrorMessage());
+
+    script.events.clear();
+    if (const auto* events = json["events"].getArray())
+    {
+        for (const auto& eventJson : *events)
+        {
+            Event event;
+            result = parseEvent(eventJson, event);
+            if (result.failed())
+                return juce::Result::fail(file.getFileName() + ": " + result.getErrorMessage());
+
+            script.events.push_back(event);
+        }
+    }
+
+    std::stable_sort(script.events.begin(), script.events.end(),
+                     [](const Event& a, const Event& b) { return a.at < b.at; });
+
+    return juce::Result::ok();
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include <vector>
+
+/**
+ * @brief Scripted session for the headless host
+ *
+ * A session is a JSON file:
+ *
+ *   {
+ *     "name": "fat sweep",
+ *     "sampleRate": 48000, "blockSize": 512, "channels": 2,
+ *     "input": "drums.wav"                      (relative to the script)
+ *       or "signal": { "type": "sine", ... }    (see TestSignals.h)
+ *     "automation": "sample" | "block",
+ *     "events": [
+ *       { "at": 24000, "parameter": "fat", "value": 80 },
+ *       { "at": 48000, "program": 3 },
+ *       { "at": 60000, "saveState": "A" },
+ *       { "at": 90000, "restoreState": "A" }
+ *     ],
+ *     "expect": { "hash": { "<build key>": "..." }, "latencySamples": 0, "maxBlockMs": 2.0, "minRealtimeFactor": 10 },
+ *     "output": "render.wav"
+ *   }
+ *
+ * "at" is in samples from the start of the session. With "sample"
+ * automation parameter changes go through the processor's event queue and
+ * land on their sample; with "block" they are set at the start of the block
+ * that contains them, as VST3/AU hosts do.
+ *
+ * "hash" maps build keys (SessionRunner::getBuildKey()) to the expected
+ * output hash; a build with no entry fails (only a warning with
+ * `--allow-missing-hash`). `--record-hashes` writes the current build's
+ * hashes into the scripts.
+ * A plain string is still accepted and compared on every build.
+ */
+struct SessionScript
+{
+    struct Event
+    {
+        enum class Kind
+        {
+            parameter,
+            program,
+            saveState,
+            restoreState
+        };
+
+        Kind kind = Kind::parameter;
+        juce::int64 at = 0;
+        juce::String parameterId;
+        float value = 0.0f;
+        int program = 0;
+        juce::String slot;
+    };
+
+    juce::String name;
+    double sampleRate = 48000.0;
+    int blockSize = 512;
+    int numChannels = 2;
+    bool sampleAccurateAutomation = true;
+
+    juce::AudioBuffer<float> input;
+    std::vector<Event> events;  // sorted by time
+    juce::var expectations;
+    juce::File outputFile;
+
+    /**
+     * @brief Parse a session file (audio inputs are read here)
+     */
+    static juce::Result load(const juce::File& file, SessionScript& script);
+};
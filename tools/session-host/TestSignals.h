@@ -0,0 +1,73 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include <cmath>
+
+/**
+ * @brief Deterministic test signals for scripted sessions
+ *
+ * Spec (JSON object): { "type": "sine" | "sweep" | "noise" | "impulse" | "silence",
+ *                       "seconds": 2.0, "amplitude": 0.5, "frequency": 1000,
+ *                       "endFrequency": 20000, "seed": 1 }
+ * Every channel gets the same signal, so stereo-linked detection is exercised
+ * the same way on every run.
+ */
+namespace TestSignals
+{
+inline juce::Result generate(const juce::var& spec, double sampleRate, int numChannels,
+                             juce::AudioBuffer<float>& output)
+{
+    const auto type = spec.getProperty("type", "sine").toString();
+    const double seconds = spec.getProperty("seconds", 2.0);
+    const auto amplitude = static_cast<float>(static_cast<double>(spec.getProperty("amplitude", 0.5)));
+    const double frequency = spec.getProperty("frequency", 1000.0);
+    const double endFrequency = spec.getProperty("endFrequency", 20000.0);
+    const auto seed = static_cast<juce::int64>(static_cast<int>(spec.getProperty("seed", 1)));
+
+    const int numSamples = static_cast<int>(seconds * sampleRate);
+    if (numSamples <= 0)
+        return juce::Result::fail("signal length must be positive");
+
+    output.setSize(numChannels, numSamples);
+    output.clear();
+    auto* data = output.getWritePointer(0);
+
+    if (type == "sine")
+    {
+        const double omega = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = amplitude * static_cast<float>(std::sin(omega * i));
+    }
+    else if (type == "sweep")
+    {
+        // Exponential sweep, frequency → endFrequency over the whole signal
+        const double rate = std::log(endFrequency / frequency) / seconds;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double t = i / sampleRate;
+            const double phase = juce::MathConstants<double>::twoPi * frequency * (std::exp(rate * t) - 1.0) / rate;
+            data[i] = amplitude * static_cast<float>(std::sin(phase));
+        }
+    }
+    else if (type == "noise")
+    {
+        juce::Random random(seed);
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = amplitude * (random.nextFloat() * 2.0f - 1.0f);
+    }
+    else if (type == "impulse")
+    {
+        data[0] = amplitude;
+    }
+    else if (type != "silence")
+    {
+        return juce::Result::fail("unknown signal type: " + type);
+    }
+
+    for (int channel = 1; channel < numChannels; ++channel)
+        output.copyFrom(channel, 0, output, 0, 0, numSamples);
+
+    return juce::Result::ok();
+}
+}
@@ -0,0 +1,37 @@
+#!/bin/sh
+# Render the golden-output reference corpus from a known-good revision, render
+# the working tree's corpus with the same toolchain, and compare the two.
+#
+#   tools/session-host/corpus-check.sh [reference-revision] [work-directory]
+#
+# reference-revision defaults to the latest tag, work-directory to
+# ./corpus-check. Extra CMake arguments (e.g. -DJUCE_PATH=...) go in
+# $CMAKE_ARGS. The reference is built from a detached git worktree, so the
+# corpus never needs to be committed: both sides come from one machine and
+# compiler, which is what the tolerances in Corpus.h assume.
+set -eu
+
+root=$(git rev-parse --show-toplevel)
+reference=${1:-$(git -C "$root" describe --tags --abbrev=0)}
+work=$(mkdir -p "${2:-corpus-check}" && cd "${2:-corpus-check}" && pwd)
+config=Release
+
+build_host() {
+    # $1 source tree, $2 build directory; prints the host's path (build output goes to stderr)
+    cmake -S "$1" -B "$2" -DFATPRESSOR_BUILD_TOOLS=ON -DCMAKE_BUILD_TYPE=$config ${CMAKE_ARGS:-} >&2
+    cmake --build "$2" --config $config --target FatPressorSessionHost -j >&2
+    find "$2" -type f -name 'fatpressor-session-host*' -perm -u+x | head -n 1
+}
+
+if [ ! -d "$work/reference-src" ]; then
+    git -C "$root" worktree add --detach "$work/reference-src" "$reference"
+fi
+
+reference_host=$(build_host "$work/reference-src" "$work/reference-build")
+candidate_host=$(build_host "$root" "$work/candidate-build")
+
+rm -rf "$work/reference" "$work/candidate"
+"$reference_host" --render-corpus "$work/reference"
+"$candidate_host" --render-corpus "$work/candidate"
+
+"$candidate_host" --compare "$work/reference" "$work/candidate" --report "$work/compare.json"
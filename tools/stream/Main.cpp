@@ -0,0 +1,320 @@
+#include "PcmFormat.h"
+#include "../../src/PluginProcessor.h"
+#include <juce_events/juce_events.h>
+#include <array>
+#include <condition_variable>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#if JUCE_WINDOWS
+ #include <fcntl.h>
+ #include <io.h>
+#endif
+
+/**
+ * fatpressor-stream - pipes raw PCM through FatPressor
+ *
+ *   ffmpeg -i in.wav -f f32le -ac 2 -ar 48000 - \
+ *     | fatpressor-stream --rate 48000 --channels 2 --format f32le [--preset file.fppreset] [--set fat=60] \
+ *     | ffplay -f f32le -ac 2 -ar 48000 -
+ *
+ * Three threads share a fixed pool of blocks: the reader decodes stdin, the
+ * DSP thread runs the processor, the writer encodes to stdout (flushed per
+ * block). With numBlocks in the pool, at most numBlocks blocks are in flight,
+ * which bounds the latency the pipeline adds. Throughput and measured latency
+ * go to stderr at the end.
+ */
+namespace
+{
+constexpr int numBlocks = 4;  // one per thread plus one spare: double buffering at each hand-off
+
+struct Block
+{
+    juce::AudioBuffer<float> audio;
+    juce::HeapBlock<char> bytes;
+    int numFrames = 0;
+    juce::int64 readTicks = 0;  // when the reader finished decoding it
+};
+
+/**
+ * @brief Bounded FIFO of block indices between two pipeline threads
+ */
+class BlockQueue
+{
+public:
+    void push(int index)
+    {
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            indices[static_cast<size_t>((head + count) % numBlocks)] = index;
+            ++count;
+        }
+        condition.notify_one();
+    }
+
+    /** Blocks until an index is available; -1 once closed and empty */
+    int pop()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this] { return count > 0 || closed; });
+
+        if (count == 0)
+            return -1;
+
+        const int index = indices[static_cast<size_t>(head)];
+        head = (head + 1) % numBlocks;
+        --count;
+        return index;
+    }
+
+    void close()
+    {
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        condition.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::array<int, numBlocks> indices {};
+    int head = 0;
+    int count = 0;
+    bool closed = false;
+};
+
+void printUsage()
+{
+    std::cerr << "usage: fatpressor-stream [--rate <hz>] [--channels 1|2] [--format f32le|s16le|s24le|s32le]\n"
+                 "                         [--block <frames>] [--preset <file.fppreset>] [--set <id>=<value>]..."
+              << std::endl;
+}
+
+bool applySetting(FatPressorAudioProcessor& processor, const juce::String& setting)
+{
+    const auto id = setting.upToFirstOccurrenceOf("=", false, false);
+    const auto value = setting.fromFirstOccurrenceOf("=", false, false);
+
+    auto* parameter = processor.parameters.getParameter(id);
+    if (parameter == nullptr || value.isEmpty())
+        return false;
+
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(value.getFloatValue()));
+    return true;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    // The processor's parameter tree expects a message manager
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+#if JUCE_WINDOWS
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+    double sampleRate = 48000.0;
+    int numChannels = 2;
+    int blockSize = 512;
+    PcmFormat format;
+    juce::File presetFile;
+    juce::StringArray settings;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String argument(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (argument == "--rate" && hasValue)
+            sampleRate = juce::String(argv[++i]).getDoubleValue();
+        else if (argument == "--channels" && hasValue)
+            numChannels = juce::String(argv[++i]).getIntValue();
+        else if (argument == "--block" && hasValue)
+            blockSize = juce::String(argv[++i]).getIntValue();
+        else if (argument == "--format" && hasValue)
+        {
+            if (! PcmFormat::fromName(argv[++i], format))
+            {
+                printUsage();
+                return 2;
+            }
+        }
+        else if (argument == "--preset" && hasValue)
+            presetFile = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        else if (argument == "--set" && hasValue)
+            settings.add(argv[++i]);
+        else
+        {
+            printUsage();
+            return 2;
+        }
+    }
+
+    if (sampleRate <= 0.0 || numChannels < 1 || numChannels > 2 || blockSize < 16 || blockSize > 65536)
+    {
+        printUsage();
+        return 2;
+    }
+
+    FatPressorAudioProcessor processor;
+    processor.setSessionCaptureEnabled(false);
+
+    const auto channelSet = numChannels == 1 ? juce::AudioChannelSet::mono() : juce::AudioChannelSet::stereo();
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(channelSet);
+    layout.outputBuses.add(channelSet);
+    processor.setBusesLayout(layout);
+
+    if (presetFile != juce::File())
+    {
+        const auto xml = juce::XmlDocument::parse(presetFile);
+        if (xml == nullptr || ! processor.presetManager.loadPresetFromXml(*xml))
+        {
+            std::cerr << "error: cannot load preset " << presetFile.getFullPathName() << std::endl;
+            return 2;
+        }
+    }
+
+    for (const auto& setting : settings)
+    {
+        if (! applySetting(processor, setting))
+        {
+            std::cerr << "error: bad setting " << setting << std::endl;
+            return 2;
+        }
+    }
+
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    const auto frameBytes = static_cast<size_t>(format.bytesPerSample() * numChannels);
+    std::array<Block, numBlocks> blocks;
+    for (auto& block : blocks)
+    {
+        block.audio.setSize(numChannels, blockSize);
+        block.bytes.allocate(frameBytes * static_cast<size_t>(blockSize), true);
+    }
+
+    BlockQueue freeBlocks, toProcess, toWrite;
+    for (int i = 0; i < numBlocks; ++i)
+        freeBlocks.push(i);
+
+    juce::int64 totalFrames = 0;
+    juce::int64 dspTicks = 0;
+    juce::int64 maxLatencyTicks = 0;
+    juce::int64 latencyTicksSum = 0;
+    int numWritten = 0;
+    bool writeFailed = false;
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    std::thread reader([&]
+    {
+        for (int index; (index = freeBlocks.pop()) >= 0;)
+        {
+            auto& block = blocks[static_cast<size_t>(index)];
+
+            // A short read mid-stream just means the pipe had less ready; keep
+            // filling until the block is full or stdin ends
+            size_t filled = 0;
+            const size_t wanted = frameBytes * static_cast<size_t>(blockSize);
+            while (filled < wanted)
+            {
+                const auto got = std::fread(block.bytes.get() + filled, 1, wanted - filled, stdin);
+                if (got == 0)
+                    break;
+                filled += got;
+            }
+
+            block.numFrames = static_cast<int>(filled / frameBytes);
+            if (block.numFrames == 0)
+                break;
+
+            format.decode(block.bytes.get(), block.audio, block.numFrames);
+            block.readTicks = juce::Time::getHighResolutionTicks();
+            toProcess.push(index);
+
+            if (filled < wanted)
+                break;
+        }
+
+        toProcess.close();
+    });
+
+    std::thread dsp([&]
+    {
+        juce::MidiBuffer midi;
+
+        for (int index; (index = toProcess.pop()) >= 0;)
+        {
+            auto& block = blocks[static_cast<size_t>(index)];
+            juce::AudioBuffer<float> audio(block.audio.getArrayOfWritePointers(), numChannels, block.numFrames);
+
+            const auto ticks = juce::Time::getHighResolutionTicks();
+            processor.processBlock(audio, midi);
+            dspTicks += juce::Time::getHighResolutionTicks() - ticks;
+
+            toWrite.push(index);
+        }
+
+        toWrite.close();
+    });
+
+    std::thread writer([&]
+    {
+        for (int index; (index = toWrite.pop()) >= 0;)
+        {
+            auto& block = blocks[static_cast<size_t>(index)];
+            format.encode(block.audio, block.numFrames, block.bytes.get());
+
+            const auto numBytes = frameBytes * static_cast<size_t>(block.numFrames);
+            if (! writeFailed && (std::fwrite(block.bytes.get(), 1, numBytes, stdout) != numBytes || std::fflush(stdout) != 0))
+                writeFailed = true;  // downstream went away; keep draining so the other threads finish
+
+            const auto latency = juce::Time::getHighResolutionTicks() - block.readTicks;
+            maxLatencyTicks = juce::jmax(maxLatencyTicks, latency);
+            latencyTicksSum += latency;
+            totalFrames += block.numFrames;
+            ++numWritten;
+
+            freeBlocks.push(index);
+        }
+
+        freeBlocks.close();
+    });
+
+    reader.join();
+    dsp.join();
+    writer.join();
+    processor.releaseResources();
+
+    const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    const auto audioSeconds = static_cast<double>(totalFrames) / sampleRate;
+    const auto dspSeconds = juce::Time::highResolutionTicksToSeconds(dspTicks);
+    const auto toMs = [](juce::int64 ticks) { return juce::Time::highResolutionTicksToSeconds(ticks) * 1000.0; };
+
+    // Buffering bound: a block can wait behind every other block in the pool
+    const auto bufferedMs = 1000.0 * numBlocks * blockSize / sampleRate;
+    const auto processorMs = 1000.0 * processor.getLatencySamples() / sampleRate;
+
+    std::cerr << "fatpressor-stream: " << totalFrames << " frames (" << juce::String(audioSeconds, 2) << " s) in "
+              << juce::String(seconds, 2) << " s, DSP " << juce::String(dspSeconds > 0.0 ? audioSeconds / dspSeconds : 0.0, 1)
+              << "x realtime\n"
+              << "  added latency: " << juce::String(bufferedMs, 1) << " ms buffering bound + "
+              << juce::String(processorMs, 2) << " ms processor; measured read-to-write mean "
+              << juce::String(numWritten > 0 ? toMs(latencyTicksSum) / numWritten : 0.0, 2) << " ms, max "
+              << juce::String(toMs(maxLatencyTicks), 2) << " ms" << std::endl;
+
+    if (writeFailed)
+    {
+        std::cerr << "error: writing to stdout failed" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include <cstring>
+
+/**
+ * @brief Raw interleaved little-endian PCM encodings for fatpressor-stream
+ * Names follow ffmpeg's -f option: f32le, s16le, s24le, s32le.
+ */
+struct PcmFormat
+{
+    enum class Encoding { f32, s16, s24, s32 };
+
+    Encoding encoding = Encoding::f32;
+
+    static bool fromName(const juce::String& name, PcmFormat& format)
+    {
+        const auto lower = name.toLowerCase().upToFirstOccurrenceOf("le", false, false);
+        if (lower == "f32")      format.encoding = Encoding::f32;
+        else if (lower == "s16") format.encoding = Encoding::s16;
+        else if (lower == "s24") format.encoding = Encoding::s24;
+        else if (lower == "s32") format.encoding = Encoding::s32;
+        else                     return false;
+        return true;
+    }
+
+    int bytesPerSample() const
+    {
+        switch (encoding)
+        {
+            case Encoding::s16: return 2;
+            case Encoding::s24: return 3;
+            case Encoding::f32:
+            case Encoding::s32: return 4;
+        }
+        return 4;
+    }
+
+    /** Interleaved bytes → planar floats */
+    void decode(const char* bytes, juce::AudioBuffer<float>& audio, int numFrames) const
+    {
+        const int numChannels = audio.getNumChannels();
+        const int stride = bytesPerSample();
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* out = audio.getWritePointer(channel);
+            const auto* in = reinterpret_cast<const juce::uint8*>(bytes) + channel * stride;
+
+            for (int frame = 0; frame < numFrames; ++frame, in += stride * numChannels)
+                out[frame] = decodeSample(in);
+        }
+    }
+
+    /** Planar floats → interleaved bytes (integer encodings are clipped) */
+    void encode(const juce::AudioBuffer<float>& audio, int numFrames, char* bytes) const
+    {
+        const int numChannels = audio.getNumChannels();
+        const int stride = bytesPerSample();
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* in = audio.getReadPointer(channel);
+            auto* out = reinterpret_cast<juce::uint8*>(bytes) + channel * stride;
+
+            for (int frame = 0; frame < numFrames; ++frame, out += stride * numChannels)
+                encodeSample(in[frame], out);
+        }
+    }
+
+private:
+    static juce::int32 readInt(const juce::uint8* in, int numBytes)
+    {
+        juce::uint32 value = 0;
+        for (int byte = 0; byte < numBytes; ++byte)
+            value |= static_cast<juce::uint32>(in[byte]) << (8 * byte);
+
+        // Sign-extend from the top byte
+        const int shift = 32 - 8 * numBytes;
+        return static_cast<juce::int32>(value << shift) >> shift;
+    }
+
+    static void writeInt(juce::int32 value, juce::uint8* out, int numBytes)
+    {
+        for (int byte = 0; byte < numBytes; ++byte)
+            out[byte] = static_cast<juce::uint8>(static_cast<juce::uint32>(value) >> (8 * byte));
+    }
+
+    float decodeSample(const juce::uint8* in) const
+    {
+        switch (encoding)
+        {
+            case Encoding::f32:
+            {
+                const auto bits = static_cast<juce::uint32>(readInt(in, 4));
+                float value;
+                std::memcpy(&value, &bits, sizeof(value));
+                return value;
+            }
+            case Encoding::s16: return static_cast<float>(readInt(in, 2)) / 32768.0f;
+            case Encoding::s24: return static_cast<float>(readInt(in, 3)) / 8388608.0f;
+            case Encoding::s32: return static_cast<float>(static_cast<double>(readInt(in, 4)) / 2147483648.0);
+        }
+        return 0.0f;
+    }
+
+    void encodeSample(float value, juce::uint8* out) const
+    {
+        const auto clipped = static_cast<double>(juce::jlimit(-1.0f, 1.0f, value));
+
+        switch (encoding)
+        {
+            case Encoding::f32:
+            {
+                juce::uint32 bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                writeInt(static_cast<juce::int32>(bits), out, 4);
+                break;
+            }
+            case Encoding::s16: writeInt(static_cast<juce::int32>(juce::jlimit(-32768.0, 32767.0, std::round(clipped * 32768.0))), out, 2); break;
+            case Encoding::s24: writeInt(static_cast<juce::int32>(juce::jlimit(-8388608.0, 8388607.0, std::round(clipped * 8388608.0))), out, 3); break;
+            case Encoding::s32: writeInt(static_cast<juce::int32>(juce::jlimit(-2147483648.0, 2147483647.0, std::round(clipped * 2147483648.0))), out, 4); break;
+        }
+    }
+};
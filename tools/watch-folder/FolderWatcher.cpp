@@ -0,0 +1,140 @@
+#include "FolderWatcher.h"
+
+#if JUCE_LINUX
+ #include <poll.h>
+ #include <sys/inotify.h>
+ #include <unistd.h>
+#endif
+
+FolderWatcher::FolderWatcher(const juce::File& rootToWatch)
+    : root(rootToWatch)
+{
+#if JUCE_LINUX
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd >= 0)
+    {
+        juce::Array<juce::File> ignored;
+        addWatchesRecursively(root, ignored);
+    }
+#endif
+}
+
+FolderWatcher::~FolderWatcher()
+{
+#if JUCE_LINUX
+    if (inotifyFd >= 0)
+        close(inotifyFd);
+#endif
+}
+
+juce::Array<juce::File> FolderWatcher::waitForChanges(int timeoutMs)
+{
+    return usesInotify() ? readInotifyEvents(timeoutMs) : pollForStableFiles(timeoutMs);
+}
+
+void FolderWatcher::addWatchesRecursively(const juce::File& directory, juce::Array<juce::File>& existingFiles)
+{
+#if JUCE_LINUX
+    const auto wd = inotify_add_watch(inotifyFd, directory.getFullPathName().toRawUTF8(),
+                                      IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR);
+    if (wd >= 0)
+        watchedDirectories[wd] = directory;
+
+    for (const auto& entry : juce::RangedDirectoryIterator(directory, false, "*",
+                                                           juce::File::findFilesAndDirectories))
+    {
+        if (entry.isDirectory())
+            addWatchesRecursively(entry.getFile(), existingFiles);
+        else
+            existingFiles.add(entry.getFile());
+    }
+#else
+    juce::ignoreUnused(directory, existingFiles);
+#endif
+}
+
+juce::Array<juce::File> FolderWatcher::readInotifyEvents(int timeoutMs)
+{
+    juce::Array<juce::File> finished;
+
+#if JUCE_LINUX
+    pollfd descriptor { inotifyFd, POLLIN, 0 };
+    if (poll(&descriptor, 1, timeoutMs) <= 0)
+        return finished;
+
+    alignas(inotify_event) char events[16384];
+
+    for (;;)
+    {
+        const auto length = read(inotifyFd, events, sizeof(events));
+        if (length <= 0)
+            break;
+
+        for (const char* position = events; position < events + length;)
+        {
+            const auto* event = reinterpret_cast<const inotify_event*>(position);
+            position += sizeof(inotify_event) + event->len;
+
+            const auto directory = watchedDirectories.find(event->wd);
+            if (directory == watchedDirectories.end() || event->len == 0)
+                continue;
+
+            const auto file = directory->second.getChildFile(juce::String::fromUTF8(event->name));
+
+            if ((event->mask & IN_ISDIR) != 0)
+            {
+                // A new folder (created or moved in): watch it, and take whatever
+                // landed in it before the watch existed
+                if ((event->mask & (IN_CREATE | IN_MOVED_TO)) != 0)
+                    addWatchesRecursively(file, finished);
+            }
+            else if ((event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) != 0)
+            {
+                finished.add(file);
+            }
+        }
+    }
+#else
+    juce::ignoreUnused(timeoutMs);
+#endif
+
+    return finished;
+}
+
+juce::Array<juce::File> FolderWatcher::pollForStableFiles(int timeoutMs)
+{
+    juce::Thread::sleep(timeoutMs);
+    return findStableFiles(lastPoll);
+}
+
+juce::Array<juce::File> FolderWatcher::rescan()
+{
+    return findStableFiles(lastRescan);
+}
+
+juce::Array<juce::File> FolderWatcher::findStableFiles(Scan& previousScan) const
+{
+    juce::Array<juce::File> finished;
+    Scan scan;
+
+    for (const auto& entry : juce::RangedDirectoryIterator(root, true, "*", juce::File::findFiles))
+    {
+        const auto path = entry.getFile().getFullPathName();
+        FileStamp stamp { entry.getFileSize(), entry.getModificationTime(), false };
+
+        const auto previous = previousScan.find(path);
+        if (previous != previousScan.end() && previous->second.size == stamp.size
+            && previous->second.modified == stamp.modified)
+        {
+            // Unchanged since the last scan: finished, reported once
+            stamp.reported = true;
+            if (! previous->second.reported)
+                finished.add(entry.getFile());
+        }
+
+        scan[path] = stamp;
+    }
+
+    previousScan = std::move(scan);
+    return finished;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <map>
+
+/**
+ * @brief Reports files in a directory tree that have finished being written
+ *
+ * On Linux this uses inotify (IN_CLOSE_WRITE / IN_MOVED_TO, with watches
+ * added for new subdirectories as they appear). Elsewhere, or when inotify
+ * is unavailable, it rescans the tree and reports files whose size and
+ * modification time were stable across two scans.
+ *
+ * rescan() applies the same stability check on demand, whatever the
+ * backend, for the initial pass and the periodic safety-net scans.
+ */
+class FolderWatcher
+{
+public:
+    explicit FolderWatcher(const juce::File& root);
+    ~FolderWatcher();
+
+    /**
+     * @brief Wait up to timeoutMs for finished files; may return duplicates
+     */
+    juce::Array<juce::File> waitForChanges(int timeoutMs);
+
+    /**
+     * @brief Full scan: files whose size and modification time match the previous rescan()
+     * Each file is reported once per size/modification time; the first
+     * call only records what is there.
+     */
+    juce::Array<juce::File> rescan();
+
+    bool usesInotify() const { return inotifyFd >= 0; }
+
+private:
+    void addWatchesRecursively(const juce::File& directory, juce::Array<juce::File>& existingFiles);
+    juce::Array<juce::File> readInotifyEvents(int timeoutMs);
+    juce::Array<juce::File> pollForStableFiles(int timeoutMs);
+
+    juce::File root;
+    int inotifyFd = -1;
+    std::map<int, juce::File> watchedDirectories;  // watch descriptor → directory
+
+    struct FileStamp
+    {
+        juce::int64 size = -1;
+        juce::Time modified;
+        bool reported = false;
+    };
+    using Scan = std::map<juce::String, FileStamp>;
+
+    juce::Array<juce::File> findStableFiles(Scan& previousScan) const;
+
+    Scan lastPoll;    // polling backend
+    Scan lastRescan;  // rescan()
+
+    JUCE_DECLARE_NON_COPYABLE(FolderWatcher)
+};
@@ -0,0 +1,227 @@
+#include "FolderWatcher.h"
+#include "RenderJob.h"
+#include <juce_events/juce_events.h>
+#include <atomic>
+#include <csignal>
+#include <iostream>
+#include <mutex>
+#include <set>
+
+/**
+ * fatpressor-watch - watch-folder batch rendering
+ *
+ *   fatpressor-watch <input-dir> <output-dir> [--jobs <n>] [--once]
+ *
+ * Renders every audio file under <input-dir> to the same relative path
+ * under <output-dir> (as WAV, with a .json report next to it), then keeps
+ * watching for new files until SIGINT/SIGTERM. A folder's preset is the
+ * first .fppreset file in it, or failing that in the nearest folder above.
+ * Files whose report matches the current input are skipped, so a restart
+ * resumes where the last run stopped; that includes failed files, which are
+ * only retried once they change. --once renders what is there and exits.
+ */
+namespace
+{
+std::atomic<bool> stopRequested { false };
+
+void requestStop(int)
+{
+    stopRequested.store(true);
+}
+
+void printUsage()
+{
+    std::cerr << "usage: fatpressor-watch <input-dir> <output-dir> [--jobs <n>] [--once]" << std::endl;
+}
+
+bool isAudioFile(const juce::File& file)
+{
+    return file.hasFileExtension("wav;aif;aiff;flac;ogg") && ! file.getFileName().startsWithChar('.');
+}
+
+/**
+ * @brief Queues files onto the pool, once each, skipping finished ones
+ */
+class Scheduler
+{
+public:
+    Scheduler(const juce::File& inputDirectory, const juce::File& outputDirectory, int numJobs)
+        : inputRoot(inputDirectory), outputRoot(outputDirectory), pool(numJobs)
+    {
+    }
+
+    ~Scheduler()
+    {
+        pool.removeAllJobs(true, 30000);
+    }
+
+    void submit(const juce::File& input)
+    {
+        if (! isAudioFile(input) || ! input.existsAsFile() || ! input.isAChildOf(inputRoot))
+            return;
+
+        RenderRequest request;
+        request.input = input;
+        request.output = outputRoot.getChildFile(input.getRelativePathFrom(inputRoot)).withFileExtension("wav");
+        request.report = request.output.getSiblingFile(request.output.getFileName() + ".json");
+        request.preset = findPreset(input.getParentDirectory());
+
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            if (! active.insert(input.getFullPathName()).second)
+                return;  // already queued or rendering
+        }
+
+        if (request.isUpToDate())
+        {
+            const auto previousError = request.getPreviousError();
+            if (previousError.isNotEmpty())
+                std::cout << "skipped " << input.getFullPathName() << " (failed before: " << previousError
+                          << "; retried once it changes)" << std::endl;
+
+            finish(request);
+            return;
+        }
+
+        pool.addJob(new RenderJob(std::move(request), [this](const RenderRequest& done, const juce::Result& result)
+        {
+            std::cout << (result.wasOk() ? "done " : "FAILED ") << done.input.getFullPathName()
+                      << (result.wasOk() ? juce::String() : " (" + result.getErrorMessage() + ")") << std::endl;
+            finish(done);
+        }), true);
+    }
+
+    void submitAll(const juce::Array<juce::File>& files)
+    {
+        for (const auto& file : files)
+            submit(file);
+    }
+
+    bool isIdle()
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        return active.empty();
+    }
+
+private:
+    void finish(const RenderRequest& request)
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        active.erase(request.input.getFullPathName());
+    }
+
+    juce::File findPreset(juce::File directory) const
+    {
+        for (;;)
+        {
+            auto presets = directory.findChildFiles(juce::File::findFiles, false, "*.fppreset");
+            if (! presets.isEmpty())
+            {
+                presets.sort();
+                return presets.getFirst();
+            }
+
+            if (directory == inputRoot || ! directory.isAChildOf(inputRoot))
+                return {};
+
+            directory = directory.getParentDirectory();
+        }
+    }
+
+    const juce::File inputRoot, outputRoot;
+    juce::ThreadPool pool;
+    std::mutex mutex;
+    std::set<juce::String> active;
+};
+}
+
+int main(int argc, char* argv[])
+{
+    // The processor's parameter tree expects a message manager
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const auto cwd = juce::File::getCurrentWorkingDirectory();
+    juce::Array<juce::File> directories;
+    int numJobs = juce::jmax(1, juce::SystemStats::getNumCpus() - 1);
+    bool once = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String argument(argv[i]);
+
+        if (argument == "--jobs" && i + 1 < argc)
+            numJobs = juce::String(argv[++i]).getIntValue();
+        else if (argument == "--once")
+            once = true;
+        else if (argument.startsWith("--"))
+        {
+            printUsage();
+            return 2;
+        }
+        else
+            directories.add(cwd.getChildFile(argument));
+    }
+
+    if (directories.size() != 2 || ! directories[0].isDirectory() || numJobs < 1)
+    {
+        printUsage();
+        return 2;
+    }
+
+    const auto inputRoot = directories[0];
+    const auto outputRoot = directories[1];
+    if (outputRoot == inputRoot || outputRoot.isAChildOf(inputRoot))
+    {
+        std::cerr << "error: the output directory must be outside the input directory" << std::endl;
+        return 2;
+    }
+
+    outputRoot.createDirectory();
+
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+
+    // Start watching before the initial scan so nothing lands in between unseen
+    FolderWatcher watcher(inputRoot);
+    Scheduler scheduler(inputRoot, outputRoot, numJobs);
+
+    std::cout << "watching " << inputRoot.getFullPathName() << " with " << numJobs << " jobs ("
+              << (watcher.usesInotify() ? "inotify" : "polling") << ")" << std::endl;
+
+    // Files already there go through the same stability check as later
+    // rescans: stamp them, then take those unchanged a moment later
+    constexpr int settleMs = 1000;
+    watcher.rescan();
+    juce::Thread::sleep(settleMs);
+    scheduler.submitAll(watcher.rescan());
+
+    // Rescan now and then: covers missed inotify events (overflow) and files
+    // still being copied in at the initial scan. Only files that are stable
+    // across two rescans are submitted, and failed ones stay skipped until
+    // they change (see RenderRequest::isUpToDate()).
+    constexpr int rescanIntervalMs = 60000;
+    auto lastRescan = juce::Time::getMillisecondCounter();
+
+    while (! stopRequested.load())
+    {
+        if (once)
+        {
+            if (scheduler.isIdle())
+                break;
+
+            juce::Thread::sleep(100);
+            continue;
+        }
+
+        scheduler.submitAll(watcher.waitForChanges(1000));
+
+        if (juce::Time::getMillisecondCounter() - lastRescan > static_cast<juce::uint32>(rescanIntervalMs))
+        {
+            scheduler.submitAll(watcher.rescan());
+            lastRescan = juce::Time::getMillisecondCounter();
+        }
+    }
+
+    std::cout << "stopping" << std::endl;
+    return 0;
+}
@@ -0,0 +1,249 @@
+#include "RenderJob.h"
+#include "../../src/PluginProcessor.h"
+#include <array>
+#include <mutex>
+
+namespace
+{
+constexpr int blockSize = 1024;
+
+// Gain reduction histogram: 0.1 dB bins up to 60 dB
+constexpr float histogramStepDb = 0.1f;
+constexpr int histogramBins = 600;
+
+// Processor construction installs factory presets on first run; keep it to one thread
+std::mutex processorCreationMutex;
+
+juce::var describeSource(const juce::File& input)
+{
+    auto* source = new juce::DynamicObject();
+    source->setProperty("size", input.getSize());
+    source->setProperty("modified", input.getLastModificationTime().toMilliseconds());
+    return juce::var(source);
+}
+
+std::unique_ptr<juce::AudioFormatReader> openInput(juce::AudioFormatManager& formats, const juce::File& input,
+                                                   bool& memoryMapped)
+{
+    memoryMapped = false;
+
+    if (auto* format = formats.findFormatForFileExtension(input.getFileExtension()))
+    {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(format->createMemoryMappedReader(input));
+        if (mapped != nullptr && mapped->mapEntireFile())
+        {
+            memoryMapped = true;
+            return mapped;
+        }
+    }
+
+    return std::unique_ptr<juce::AudioFormatReader>(formats.createReaderFor(input));
+}
+
+// The previous report, if it was written for the input as it is now
+juce::var readMatchingReport(const RenderRequest& request)
+{
+    if (! request.report.existsAsFile())
+        return {};
+
+    const auto previous = juce::JSON::parse(request.report);
+    const auto source = previous["source"];
+
+    if (static_cast<juce::int64>(source["size"]) != request.input.getSize()
+        || static_cast<juce::int64>(source["modified"]) != request.input.getLastModificationTime().toMilliseconds())
+        return {};
+
+    return previous;
+}
+}
+
+bool RenderRequest::isUpToDate() const
+{
+    const auto previous = readMatchingReport(*this);
+    if (! previous.isObject())
+        return false;
+
+    return ! static_cast<bool>(previous["ok"]) || output.existsAsFile();
+}
+
+juce::String RenderRequest::getPreviousError() const
+{
+    const auto previous = readMatchingReport(*this);
+    return previous.isObject() && ! static_cast<bool>(previous["ok"]) ? previous["error"].toString() : juce::String();
+}
+
+RenderJob::RenderJob(RenderRequest requestToRender, Callback callback)
+    : juce::ThreadPoolJob("render " + requestToRender.input.getFileName())
+    , request(std::move(requestToRender))
+    , onFinished(std::move(callback))
+{
+}
+
+juce::ThreadPoolJob::JobStatus RenderJob::runJob()
+{
+    auto* report = new juce::DynamicObject();
+    const juce::var reportHolder(report);
+
+    report->setProperty("input", request.input.getFullPathName());
+    report->setProperty("output", request.output.getFullPathName());
+    report->setProperty("preset", request.preset.getFullPathName());
+    report->setProperty("source", describeSource(request.input));
+
+    const auto result = render(*report);
+    report->setProperty("ok", result.wasOk());
+    if (result.failed())
+        report->setProperty("error", result.getErrorMessage());
+
+    // An interrupted render leaves no report, so it is redone on restart
+    if (! shouldExit())
+        request.report.replaceWithText(juce::JSON::toString(reportHolder));
+
+    onFinished(request, result);
+    return jobHasFinished;
+}
+
+juce::Result RenderJob::render(juce::DynamicObject& report)
+{
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    bool memoryMapped = false;
+    const auto reader = openInput(formats, request.input, memoryMapped);
+    if (reader == nullptr)
+        return juce::Result::fail("unsupported or unreadable audio file");
+
+    const auto numChannels = static_cast<int>(reader->numChannels);
+    const auto sampleRate = reader->sampleRate;
+    if (numChannels < 1 || numChannels > 2 || sampleRate <= 0.0)
+        return juce::Result::fail("only mono and stereo files are supported");
+
+    report.setProperty("memoryMapped", memoryMapped);
+    report.setProperty("sampleRate", sampleRate);
+    report.setProperty("channels", numChannels);
+    report.setProperty("frames", reader->lengthInSamples);
+
+    std::unique_ptr<FatPressorAudioProcessor> processor;
+    {
+        const std::lock_guard<std::mutex> lock(processorCreationMutex);
+        processor = std::make_unique<FatPressorAudioProcessor>();
+    }
+    processor->setSessionCaptureEnabled(false);
+
+    const auto channelSet = numChannels == 1 ? juce::AudioChannelSet::mono() : juce::AudioChannelSet::stereo();
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(channelSet);
+    layout.outputBuses.add(channelSet);
+    processor->setBusesLayout(layout);
+
+    if (request.preset.existsAsFile())
+    {
+        const auto xml = juce::XmlDocument::parse(request.preset);
+        if (xml == nullptr || ! processor->presetManager.loadPresetFromXml(*xml))
+            return juce::Result::fail("cannot load preset " + request.preset.getFullPathName());
+    }
+
+    processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor->prepareToPlay(sampleRate, blockSize);
+
+    // Stream the output to a temporary file, renamed once complete
+    request.output.getParentDirectory().createDirectory();
+    const auto partial = request.output.getSiblingFile(request.output.getFileName() + ".part");
+    partial.deleteFile();
+
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+    {
+        auto stream = partial.createOutputStream();
+        if (stream == nullptr)
+            return juce::Result::fail("cannot write " + partial.getFullPathName());
+
+        const int bits = reader->usesFloatingPointData ? 32 : juce::jlimit(16, 24, static_cast<int>(reader->bitsPerSample));
+        juce::WavAudioFormat wav;
+        writer.reset(wav.createWriterFor(stream.get(), sampleRate, static_cast<unsigned int>(numChannels), bits, {}, 0));
+        if (writer == nullptr)
+            return juce::Result::fail("cannot create WAV writer");
+
+        stream.release();  // owned by the writer now
+    }
+
+    juce::AudioBuffer<float> block(numChannels, blockSize);
+    juce::MidiBuffer midi;
+    std::array<juce::int64, histogramBins> histogram {};
+    double gainReductionSum = 0.0;
+    float maxGainReduction = 0.0f;
+    float inputPeak = 0.0f, outputPeak = 0.0f;
+    juce::int64 numBlocks = 0;
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    for (juce::int64 position = 0; position < reader->lengthInSamples; position += blockSize)
+    {
+        if (shouldExit())
+        {
+            writer.reset();
+            partial.deleteFile();
+            return juce::Result::fail("interrupted");
+        }
+
+        const auto numSamples = static_cast<int>(juce::jmin<juce::int64>(blockSize, reader->lengthInSamples - position));
+        reader->read(&block, 0, numSamples, position, true, true);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            inputPeak = juce::jmax(inputPeak, block.getMagnitude(channel, 0, numSamples));
+
+        juce::AudioBuffer<float> audio(block.getArrayOfWritePointers(), numChannels, numSamples);
+        processor->processBlock(audio, midi);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            outputPeak = juce::jmax(outputPeak, audio.getMagnitude(channel, 0, numSamples));
+
+        // The processor meters the peak gain reduction of each block
+        const auto gainReduction = juce::jmax(0.0f, processor->gainReduction.load());
+        maxGainReduction = juce::jmax(maxGainReduction, gainReduction);
+        gainReductionSum += gainReduction;
+        ++histogram[static_cast<size_t>(juce::jlimit(0, histogramBins - 1, static_cast<int>(gainReduction / histogramStepDb)))];
+        ++numBlocks;
+
+        if (! writer->writeFromAudioSampleBuffer(audio, 0, numSamples))
+        {
+            writer.reset();
+            partial.deleteFile();
+            return juce::Result::fail("write failed");
+        }
+    }
+
+    writer.reset();
+    processor->releaseResources();
+
+    if (! partial.moveFileTo(request.output))
+        return juce::Result::fail("cannot move output into place");
+
+    // 95th percentile and time above 1 dB, from the per-block histogram
+    float percentile95 = 0.0f;
+    juce::int64 belowOneDb = 0, counted = 0;
+    for (int bin = 0; bin < histogramBins; ++bin)
+    {
+        if (static_cast<float>(bin) * histogramStepDb < 1.0f)
+            belowOneDb += histogram[static_cast<size_t>(bin)];
+
+        counted += histogram[static_cast<size_t>(bin)];
+        if (percentile95 == 0.0f && counted * 100 >= numBlocks * 95 && numBlocks > 0)
+            percentile95 = static_cast<float>(bin + 1) * histogramStepDb;
+    }
+
+    auto* gainReduction = new juce::DynamicObject();
+    gainReduction->setProperty("maxDb", maxGainReduction);
+    gainReduction->setProperty("meanDb", numBlocks > 0 ? gainReductionSum / static_cast<double>(numBlocks) : 0.0);
+    gainReduction->setProperty("p95Db", percentile95);
+    gainReduction->setProperty("fractionAbove1Db",
+                               numBlocks > 0 ? static_cast<double>(numBlocks - belowOneDb) / static_cast<double>(numBlocks) : 0.0);
+    gainReduction->setProperty("blockSize", blockSize);
+    report.setProperty("gainReduction", juce::var(gainReduction));
+
+    report.setProperty("inputPeakDb", juce::Decibels::gainToDecibels(inputPeak));
+    report.setProperty("outputPeakDb", juce::Decibels::gainToDecibels(outputPeak));
+    report.setProperty("latencySamples", processor->getLatencySamples());
+    report.setProperty("renderSeconds",
+                       juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks));
+
+    return juce::Result::ok();
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_core/juce_core.h>
+#include <functional>
+
+/**
+ * @brief One file to render: source, destination, report and preset
+ */
+struct RenderRequest
+{
+    juce::File input;
+    juce::File output;  // always WAV
+    juce::File report;  // <output>.json, written last
+    juce::File preset;  // nearest .fppreset up the input tree; none means defaults
+
+    /**
+     * @brief True when a previous run already handled this exact input
+     * (report present and matching the input's size and modification time):
+     * rendered it, or failed on it. A failed input is not retried until it
+     * changes or its report is deleted.
+     */
+    bool isUpToDate() const;
+
+    /**
+     * @brief The error a previous run reported for this exact input, if it failed
+     */
+    juce::String getPreviousError() const;
+};
+
+/**
+ * @brief Renders one file through its own processor instance
+ *
+ * Input is read through a memory-mapped reader where the format supports
+ * it (WAV, AIFF); output is streamed block by block to <output>.part and
+ * renamed once complete. The report records gain reduction statistics
+ * (max, mean, 95th percentile, time spent above 1 dB), peaks and timing.
+ */
+class RenderJob : public juce::ThreadPoolJob
+{
+public:
+    using Callback = std::function<void(const RenderRequest&, const juce::Result&)>;
+
+    RenderJob(RenderRequest request, Callback onFinished);
+
+    JobStatus runJob() override;
+
+private:
+    juce::Result render(juce::DynamicObject& report);
+
+    RenderRequest request;
+    Callback onFinished;
+};
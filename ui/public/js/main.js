@@ -310,6 +310,7 @@ function updateMeters(data) {
   const grMeter = document.getElementById('grMeter');
   const outputMeter = document.getElementById('outputMeter');
   const grDisplay = document.getElementById('grDisplay');
+  const expDisplay = document.getElementById('expDisplay');
 
   // Convert dB to percentage (assuming -60dB to 0dB range)
   const dbToPercent = (db) => Math.max(0, Math.min(100, ((db + 60) / 60) * 100));
@@ -334,6 +335,11 @@ function updateMeters(data) {
     grDisplay.textContent = `-${data.gr.toFixed(1)}dB`;
   }
 
+  // Expander/gate, reported apart from the compressor's GR
+  if (expDisplay && typeof data.exp === 'number') {
+    expDisplay.textContent = `-${data.exp.toFixed(1)}dB`;
+  }
+
   // Update FAT label glow based on gain reduction
   if (typeof data.gr === 'number') {
     currentGainReduction = data.gr;